@@ -0,0 +1,211 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+       Performance test for the CPU pack and unpack kernels used in the reshape operations
+*/
+
+#include "test_common.h"
+
+/*
+ * Reference implementation of the transpose unpack, uses scalar loops with fixed blocking.
+ * The performance of the heFFTe kernels is reported relative to this implementation.
+ */
+template<typename scalar_type, typename index>
+void reference_unpack(heffte::pack_plan_3d<index> const &plan, scalar_type const buffer[], scalar_type data[]){
+    constexpr index stride = 256 / sizeof(scalar_type);
+    if (plan.map[0] == 0 and plan.map[1] == 1){
+        for(index i=0; i<plan.size[2]; i++)
+            for(index j=0; j<plan.size[1]; j++)
+                for(index k=0; k<plan.size[0]; k++)
+                    data[i * plan.plane_stride + j * plan.line_stride + k]
+                        = buffer[ i * plan.buff_plane_stride + j * plan.buff_line_stride + k ];
+
+    }else if (plan.map[0] == 0 and plan.map[1] == 2){
+        for(index bi=0; bi<plan.size[2]; bi+=stride)
+            for(index bj=0; bj<plan.size[1]; bj+=stride)
+                for(index bk=0; bk<plan.size[0]; bk+=stride)
+                    for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
+                        for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
+                            for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
+                                data[i * plan.plane_stride + j * plan.line_stride + k]
+                                    = buffer[ j * plan.buff_plane_stride + i * plan.buff_line_stride + k ];
+
+    }else if (plan.map[0] == 1 and plan.map[1] == 0){
+        for(index bi=0; bi<plan.size[2]; bi+=stride)
+            for(index bj=0; bj<plan.size[1]; bj+=stride)
+                for(index bk=0; bk<plan.size[0]; bk+=stride)
+                    for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
+                        for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
+                            for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
+                                data[i * plan.plane_stride + j * plan.line_stride + k]
+                                    = buffer[ i * plan.buff_plane_stride + k * plan.buff_line_stride + j ];
+
+    }else if (plan.map[0] == 1 and plan.map[1] == 2){
+        for(index bi=0; bi<plan.size[2]; bi+=stride)
+            for(index bj=0; bj<plan.size[1]; bj+=stride)
+                for(index bk=0; bk<plan.size[0]; bk+=stride)
+                    for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
+                        for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
+                            for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
+                                data[i * plan.plane_stride + j * plan.line_stride + k]
+                                    = buffer[ k * plan.buff_plane_stride + i * plan.buff_line_stride + j ];
+
+    }else if (plan.map[0] == 2 and plan.map[1] == 0){
+        for(index bi=0; bi<plan.size[2]; bi+=stride)
+            for(index bj=0; bj<plan.size[1]; bj+=stride)
+                for(index bk=0; bk<plan.size[0]; bk+=stride)
+                    for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
+                        for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
+                            for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
+                                data[i * plan.plane_stride + j * plan.line_stride + k]
+                                    = buffer[ j * plan.buff_plane_stride + k * plan.buff_line_stride + i ];
+
+    }else{ // if (plan.map[0] == 2 and plan.map[1] == 1){
+        for(index bi=0; bi<plan.size[2]; bi+=stride)
+            for(index bj=0; bj<plan.size[1]; bj+=stride)
+                for(index bk=0; bk<plan.size[0]; bk+=stride)
+                    for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
+                        for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
+                            for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
+                                data[i * plan.plane_stride + j * plan.line_stride + k]
+                                    = buffer[ k * plan.buff_plane_stride + j * plan.buff_line_stride + i ];
+
+    }
+}
+
+/*
+ * Reference implementation of the direct pack, copies one line at a time.
+ */
+template<typename scalar_type, typename index>
+void reference_pack(heffte::pack_plan_3d<index> const &plan, scalar_type const data[], scalar_type buffer[]){
+    scalar_type* buffer_iterator = buffer;
+    for(index slow = 0; slow < plan.size[2]; slow++)
+        for(index mid = 0; mid < plan.size[1]; mid++)
+            buffer_iterator = std::copy_n(&data[slow * plan.plane_stride + mid * plan.line_stride], plan.size[0], buffer_iterator);
+}
+
+/*
+ * Returns the average time in seconds for a single call to the method.
+ */
+template<typename method_type>
+double time_method(int ntest, method_type method){
+    method(); // warmup
+    double t = -MPI_Wtime();
+    for(int i=0; i<ntest; i++) method();
+    t += MPI_Wtime();
+    return t / static_cast<double>(ntest);
+}
+
+template<typename scalar_type>
+void benchmark_pack(std::array<int, 3> size, std::deque<std::string> const &args){
+    using namespace heffte;
+    int const ntest = nruns(args);
+    int const num_entries = size[0] * size[1] * size[2];
+
+    // the sub-box covers the entire local box, e.g., a reshape between pencils that shares the whole box with one peer
+    pack_plan_3d<int> plan = {size, size[0], size[0] * size[1], size[0], size[0] * size[1], {0, 1, 2}};
+    std::vector<scalar_type> data(plan.plane_stride * size[2]), buffer(num_entries), result(plan.plane_stride * size[2]);
+    for(size_t i=0; i<data.size(); i++) data[i] = static_cast<scalar_type>(static_cast<double>(i % 1031));
+
+    double const mbytes = 2.0 * sizeof(scalar_type) * num_entries * 1.E-6; // read and write
+    auto report = [&](std::string const &name, double tref, double theffte)->void{
+        if (mpi::world_rank(0))
+            cout << std::setw(22) << name << std::setw(14) << mbytes / tref * 1.E-3 << std::setw(14) << mbytes / theffte * 1.E-3
+                 << std::setw(12) << tref / theffte << "\n";
+    };
+
+    if (mpi::world_rank(0)){
+        cout << "\n----------------------------------------------------------------------------- \n";
+        cout << "heFFTe pack/unpack performance test\n";
+        cout << "----------------------------------------------------------------------------- \n";
+        cout << "Type:        " << ((is_ccomplex<scalar_type>::value or is_zcomplex<scalar_type>::value) ? "complex " : "real ")
+                                << ((std::is_same<scalar_type, float>::value or is_ccomplex<scalar_type>::value) ? "float" : "double") << "\n";
+        cout << "Sub-box:     " << size[0] << "x" << size[1] << "x" << size[2] << "\n";
+        #ifdef Heffte_ENABLE_OPENMP
+        cout << "Threads:     " << omp_get_max_threads() << "\n";
+        #else
+        cout << "Threads:     1 (OpenMP is disabled)\n";
+        #endif
+        #ifdef Heffte_ENABLE_AVX
+        cout << "Tiles:       AVX registers\n";
+        #else
+        cout << "Tiles:       scalar\n";
+        #endif
+        cout << std::setw(22) << "kernel" << std::setw(14) << "ref (GB/s)" << std::setw(14) << "heffte (GB/s)" << std::setw(12) << "speedup" << "\n";
+    }
+
+    double tref = time_method(ntest, [&]()->void{ reference_pack(plan, data.data(), buffer.data()); });
+    double theffte = time_method(ntest, [&]()->void{ direct_packer<tag::cpu>().pack(nullptr, plan, data.data(), buffer.data()); });
+    report("pack", tref, theffte);
+
+    tref = time_method(ntest, [&]()->void{ reference_unpack(plan, buffer.data(), result.data()); });
+    theffte = time_method(ntest, [&]()->void{ direct_packer<tag::cpu>().unpack(nullptr, plan, buffer.data(), result.data()); });
+    report("unpack", tref, theffte);
+
+    std::array<std::array<int, 3>, 6> const maps = {{{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}};
+    for(auto const &map : maps){
+        pack_plan_3d<int> tplan = plan;
+        tplan.map = map;
+        tplan.buff_line_stride  = size[map[0]];
+        tplan.buff_plane_stride = size[map[0]] * size[map[1]];
+
+        tref = time_method(ntest, [&]()->void{ reference_unpack(tplan, buffer.data(), result.data()); });
+        theffte = time_method(ntest, [&]()->void{ transpose_packer<tag::cpu>().unpack(nullptr, tplan, buffer.data(), result.data()); });
+        report("transpose (" + std::to_string(map[0]) + ", " + std::to_string(map[1]) + ", " + std::to_string(map[2]) + ")", tref, theffte);
+    }
+    if (mpi::world_rank(0)) cout << endl;
+}
+
+int main(int argc, char *argv[]){
+
+    MPI_Init(&argc, &argv);
+
+    if (argc < 5){
+        if (mpi::world_rank(0)){
+            cout << "\nUsage:\n    ./pack_unpack <type> <size-x> <size-y> <size-z> <args>\n\n"
+                 << "    options\n"
+                 << "        type is one of float, double, complex-float, complex-double\n"
+                 << "        size-x/y/z are the dimensions of the sub-box that is packed and unpacked\n\n"
+                 << "        args is a set of optional arguments\n"
+                 << "         -nX: number of times to repeat the run, accepted variants are -n5 (default), -n10, -n50\n"
+                 << "    the number of threads is set with OMP_NUM_THREADS, if OpenMP is enabled\n\n"
+                 << "Examples:\n"
+                 << "    ./pack_unpack double 128 128 64 -n50\n"
+                 << "    OMP_NUM_THREADS=8 ./pack_unpack complex-double 256 256 32\n\n";
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    std::string type_string = argv[1];
+    std::array<int, 3> size = {0, 0, 0};
+    try{
+        size = {std::stoi(argv[2]), std::stoi(argv[3]), std::stoi(argv[4])};
+        for(auto s : size) if (s < 1) throw std::invalid_argument("negative input");
+    }catch(std::invalid_argument &e){
+        if (mpi::world_rank(0)){
+            std::cout << "Cannot convert the sizes into positive integers!\n";
+            std::cout << "Encountered error: " << e.what() << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    if (type_string == "float"){
+        benchmark_pack<float>(size, arguments(argc, argv));
+    }else if (type_string == "double"){
+        benchmark_pack<double>(size, arguments(argc, argv));
+    }else if (type_string == "complex-float"){
+        benchmark_pack<std::complex<float>>(size, arguments(argc, argv));
+    }else if (type_string == "complex-double"){
+        benchmark_pack<std::complex<double>>(size, arguments(argc, argv));
+    }else{
+        if (mpi::world_rank(0))
+            std::cout << "Invalid type " << type_string << ", must use float, double, complex-float or complex-double" << std::endl;
+    }
+
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+       Performance test for the plan setup logic, simulates a large number of ranks in a single process
+*/
+
+#include <chrono>
+
+#include "test_common.h"
+
+/*
+ * Returns the average time in seconds for a single call to the method.
+ */
+template<typename method_type>
+double time_method(int ntest, method_type method){
+    method(); // warmup
+    auto start = std::chrono::steady_clock::now();
+    for(int i=0; i<ntest; i++) method();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(ntest);
+}
+
+/*
+ * Simulates the planning on a single rank for num_ranks bricks reshaped into pencils.
+ * The general methods scan the boxes of all ranks for each box, i.e., the cost is quadratic
+ * in the number of ranks, those are skipped when num_ranks exceeds max_general.
+ */
+void benchmark_plan_setup(std::array<int, 3> size, int num_ranks, int max_general, int ntest){
+    using namespace heffte;
+    box3d<> const world({0, 0, 0}, {size[0] - 1, size[1] - 1, size[2] - 1});
+
+    split_grid<int> const bricks = {world, proc_setup_min_surface(world, num_ranks)};
+    split_grid<int> const pencils = {world, make_procgrid2d(world, 0, make_procgrid(num_ranks))};
+    ioboxes<int> const boxes = {split_world(bricks.world, bricks.proc_grid), split_world(bricks.world, bricks.proc_grid)};
+
+    double const tgrid = time_method(ntest, [&]()->void{
+        std::vector<box3d<>> result = maximize_overlap(pencils, boxes.in, world.order, rank_remap());
+        if (result.empty() or count_connections(pencils, boxes.in) < 0) std::abort();
+    });
+
+    double tgeneral = 0.0;
+    if (num_ranks <= max_general){
+        std::vector<box3d<>> const pencil_boxes = split_world(pencils.world, pencils.proc_grid);
+        tgeneral = time_method(ntest, [&]()->void{
+            std::vector<box3d<>> result = maximize_overlap(pencil_boxes, boxes.in, world.order, rank_remap());
+            if (count_connections(result, boxes.in) < 0) std::abort();
+        });
+    }
+
+    double const tplan = time_method(ntest, [&]()->void{
+        logic_plan3d<int> plan = plan_operations(boxes, -1, default_options<backend::stock>(), 0);
+        if (plan.in_shape[0].empty()) std::abort();
+    });
+
+    std::string const grid = std::to_string(bricks.proc_grid[0]) + "x" + std::to_string(bricks.proc_grid[1]) + "x" + std::to_string(bricks.proc_grid[2]);
+    cout << std::setw(10) << num_ranks << std::setw(20) << grid;
+    if (num_ranks <= max_general)
+        cout << std::setw(14) << tgeneral * 1.E3 << std::setw(14) << tgrid * 1.E3 << std::setw(12) << tgeneral / tgrid;
+    else
+        cout << std::setw(14) << "skipped" << std::setw(14) << tgrid * 1.E3 << std::setw(12) << "-";
+    cout << std::setw(14) << tplan * 1.E3 << "\n";
+}
+
+int main(int argc, char *argv[]){
+
+    if (argc < 4){
+        cout << "\nUsage:\n    ./plan_setup <size-x> <size-y> <size-z> <max-ranks> <max-general>\n\n"
+             << "    options\n"
+             << "        size-x/y/z are the dimensions of the world box\n"
+             << "        max-ranks is the largest number of simulated ranks, the test starts from 64 and grows by a factor of 4 (default 65536)\n"
+             << "        max-general is the largest number of ranks that will run the general (quadratic) methods (default 4096)\n"
+             << "    the test runs in a single process and does not use MPI communication\n\n"
+             << "Examples:\n"
+             << "    ./plan_setup 1024 1024 1024\n"
+             << "    ./plan_setup 2048 2048 2048 262144 16384\n\n";
+        return 0;
+    }
+
+    std::array<int, 3> size = {0, 0, 0};
+    int max_ranks = 65536, max_general = 4096;
+    try{
+        size = {std::stoi(argv[1]), std::stoi(argv[2]), std::stoi(argv[3])};
+        for(auto s : size) if (s < 1) throw std::invalid_argument("negative input");
+        if (argc > 4) max_ranks = std::stoi(argv[4]);
+        if (argc > 5) max_general = std::stoi(argv[5]);
+    }catch(std::invalid_argument &e){
+        std::cout << "Cannot convert the inputs into positive integers!\n";
+        std::cout << "Encountered error: " << e.what() << std::endl;
+        return 0;
+    }
+
+    cout << "\n----------------------------------------------------------------------------- \n";
+    cout << "heFFTe plan setup performance test\n";
+    cout << "----------------------------------------------------------------------------- \n";
+    cout << "Size:        " << size[0] << "x" << size[1] << "x" << size[2] << "\n";
+    cout << "Reshape:     bricks to pencils, times in milliseconds\n";
+    cout << std::setw(10) << "ranks" << std::setw(20) << "bricks" << std::setw(14) << "general" << std::setw(14) << "grid"
+         << std::setw(12) << "speedup" << std::setw(14) << "plan" << "\n";
+
+    for(int num_ranks = 64; num_ranks <= max_ranks; num_ranks *= 4){
+        if (num_ranks > size[0] * size[1] or num_ranks > size[1] * size[2]) break; // cannot split the world
+        benchmark_plan_setup(size, num_ranks, max_general, (num_ranks <= 1024) ? 5 : 1);
+    }
+    cout << endl;
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+       Offline simulator of the plan logic, runs the planner for any number of ranks in a single process
+*/
+
+#include <chrono>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+#include "test_common.h"
+
+/*
+ * Returns the time in seconds for a single call to the method.
+ */
+template<typename method_type>
+double time_method(method_type method){
+    auto start = std::chrono::steady_clock::now();
+    method();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/*
+ * Returns the peak resident memory of the process in MB, or -1 if not available.
+ */
+double peak_memory_mb(){
+    #ifdef __unix__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return static_cast<double>(usage.ru_maxrss) / 1024.0; // Linux reports KB
+    #endif
+    return -1.0;
+}
+
+/*
+ * Holds the min, max and sum of a statistic across the simulated ranks.
+ */
+struct rank_stats{
+    long long min_value = std::numeric_limits<long long>::max();
+    long long max_value = 0;
+    double sum = 0.0;
+    int count = 0;
+    void add(long long value){
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+        sum += static_cast<double>(value);
+        count++;
+    }
+    double average() const{ return (count == 0) ? 0.0 : sum / static_cast<double>(count); }
+};
+
+/*
+ * Returns the ranks to simulate, all ranks if num_samples is not positive or exceeds the ranks,
+ * otherwise num_samples ranks evenly spread across the range and always including the first and last rank.
+ */
+std::vector<int> sample_ranks(int num_ranks, int num_samples){
+    std::vector<int> result;
+    if (num_samples <= 0 or num_samples >= num_ranks){
+        for(int r=0; r<num_ranks; r++) result.push_back(r);
+    }else if (num_samples == 1){
+        result.push_back(0);
+    }else{
+        for(int i=0; i<num_samples; i++)
+            result.push_back(static_cast<int>((static_cast<long long>(num_ranks - 1) * i) / (num_samples - 1)));
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    return result;
+}
+
+/*
+ * Simulates the plan on num_ranks ranks, the per-rank data is computed by setting the mpi_rank of the plan
+ * and computing the same overlap maps as the reshape operations, i.e., without any MPI communication.
+ */
+template<typename index>
+void simulate_plan(std::array<int, 3> size_fft, int num_ranks, std::deque<std::string> const &args){
+    using namespace heffte;
+
+    box3d<index> const world = {{0, 0, 0}, {size_fft[0]-1, size_fft[1]-1, size_fft[2]-1}};
+
+    std::array<int, 3> proc_i = proc_setup_min_surface(world, num_ranks);
+    std::array<int, 3> proc_o = proc_setup_min_surface(world, num_ranks);
+    if (has_option(args, "-io_pencils")){
+        std::array<int, 2> proc_grid = make_procgrid(num_ranks);
+        proc_i = {1, proc_grid[0], proc_grid[1]};
+        proc_o = {proc_grid[0], proc_grid[1], 1};
+    }
+    if (has_option(args, "-ingrid"))
+        proc_i = get_grid(args, "-ingrid");
+    if (has_option(args, "-outgrid"))
+        proc_o = get_grid(args, "-outgrid");
+
+    if (proc_i[0] * proc_i[1] * proc_i[2] != num_ranks or proc_o[0] * proc_o[1] * proc_o[2] != num_ranks)
+        throw std::runtime_error("the input or output processor grid does not match the number of ranks");
+
+    int const r2c_dir = get_int_arg("-r2c_dir", args);
+    size_t const element_size = (has_option(args, "-single")) ? sizeof(std::complex<float>) : sizeof(std::complex<double>);
+    std::vector<int> const ranks = sample_ranks(num_ranks, get_int_arg("-sample", args, (num_ranks <= 4096) ? num_ranks : 64));
+
+    plan_options const options = args_to_options<backend::stock>(args);
+
+    ioboxes<index> boxes;
+    double const tboxes = time_method([&]()->void{
+        boxes.in  = split_world(world, proc_i);
+        boxes.out = split_world((r2c_dir == -1) ? world : world.r2c(r2c_dir), proc_o);
+    });
+
+    std::unique_ptr<logic_plan3d<index>> plan;
+    double const tplan = time_method([&]()->void{
+        plan = std::unique_ptr<logic_plan3d<index>>(new logic_plan3d<index>(plan_operations<index>(boxes, r2c_dir, options, 0)));
+    });
+
+    std::vector<std::array<int, 3>> grids;
+    double const tgrids = time_method([&]()->void{ grids = compute_grids(*plan); });
+
+    size_t plan_bytes = 0;
+    for(int i=0; i<4; i++)
+        plan_bytes += (plan->in_shape[i].size() + plan->out_shape[i].size()) * sizeof(box3d<index>);
+
+    cout << "\n----------------------------------------------------------------------------- \n";
+    cout << "heFFTe plan simulator\n";
+    cout << "----------------------------------------------------------------------------- \n";
+    cout << "Size:        " << size_fft[0] << "x" << size_fft[1] << "x" << size_fft[2] << "\n";
+    cout << "Ranks:       " << num_ranks << " (simulating " << ranks.size() << ")\n";
+    cout << "Grids:       ";
+    for(size_t i=0; i<grids.size(); i++){
+        if (i > 0 and grids[i] == grids[i-1]){ cout << "-  "; continue; }
+        cout << "(" << grids[i][0] << ", " << grids[i][1] << ", " << grids[i][2] << ")  ";
+    }
+    cout << "\n";
+    cout << "Decomp:      " << ((options.use_pencils) ? "pencils" : "slabs") << ((options.use_reorder) ? ", reorder" : ", no-reorder");
+    if (r2c_dir != -1) cout << ", r2c in direction " << r2c_dir;
+    cout << "\n";
+    cout << "Entry:       " << element_size << " bytes\n";
+    cout << "Time (ms):   boxes " << tboxes * 1.E3 << ", plan " << tplan * 1.E3 << ", grids " << tgrids * 1.E3 << "\n";
+    cout << "Plan (MB):   " << static_cast<double>(plan_bytes) * 1.E-6 << "\n\n";
+
+    cout << std::setw(8) << "reshape" << std::setw(30) << "send messages (min/avg/max)" << std::setw(30) << "send MB (min/avg/max)"
+         << std::setw(14) << "max recv msg" << std::setw(14) << "max recv MB" << std::setw(16) << "map ms/rank" << "\n";
+
+    double tmaps_total = 0.0;
+    for(int i=0; i<4; i++){
+        std::vector<box3d<index>> const &source      = plan->in_shape[i];
+        std::vector<box3d<index>> const &destination = plan->out_shape[i];
+        cout << std::setw(8) << i;
+        if (match(source, destination)){
+            cout << std::setw(30) << "skipped" << "\n";
+            continue;
+        }
+
+        rank_stats send_msg, send_bytes, recv_msg, recv_bytes;
+        double const tmaps = time_method([&]()->void{
+            for(int me : ranks){
+                std::vector<int> proc, offset, sizes;
+                std::vector<pack_plan_3d<index>> plans;
+                compute_overlap_map_direct_pack(me, num_ranks, source[me], destination, proc, offset, sizes, plans);
+                send_msg.add(static_cast<long long>(proc.size()));
+                send_bytes.add(element_size * std::accumulate(sizes.begin(), sizes.end(), 0LL));
+
+                proc.clear(); offset.clear(); sizes.clear(); plans.clear();
+                if (destination[me].ordered_same_as(source[me]))
+                    compute_overlap_map_direct_pack(me, num_ranks, destination[me], source, proc, offset, sizes, plans);
+                else
+                    compute_overlap_map_transpose_pack(me, num_ranks, destination[me], source, proc, offset, sizes, plans);
+                recv_msg.add(static_cast<long long>(proc.size()));
+                recv_bytes.add(element_size * std::accumulate(sizes.begin(), sizes.end(), 0LL));
+            }
+        });
+        tmaps_total += tmaps;
+
+        std::stringstream smsg, sbytes;
+        smsg << send_msg.min_value << " / " << std::fixed << std::setprecision(1) << send_msg.average() << " / " << send_msg.max_value;
+        sbytes << std::fixed << std::setprecision(3) << send_bytes.min_value * 1.E-6 << " / " << send_bytes.average() * 1.E-6
+               << " / " << send_bytes.max_value * 1.E-6;
+        cout << std::setw(30) << smsg.str() << std::setw(30) << sbytes.str()
+             << std::setw(14) << recv_msg.max_value << std::setw(14) << recv_bytes.max_value * 1.E-6
+             << std::setw(16) << tmaps * 1.E3 / static_cast<double>(ranks.size()) << "\n";
+    }
+
+    cout << "\nTotal time (ms): " << (tboxes + tplan + tgrids) * 1.E3 << " for the plan, "
+         << tmaps_total * 1.E3 << " for the overlap maps of " << ranks.size() << " ranks\n";
+    double const peak = peak_memory_mb();
+    if (peak > 0.0)
+        cout << "Peak memory (MB): " << peak << "\n";
+    cout << endl;
+}
+
+int main(int argc, char *argv[]){
+
+    if (argc < 5){
+        cout << "\nUsage:\n    ./plan_simulator <size-x> <size-y> <size-z> <num-ranks> <args>\n\n"
+             << "    options\n"
+             << "        size-x/y/z are the 3D dimensions of the Fourier transform\n"
+             << "        num-ranks is the number of simulated MPI ranks\n\n"
+             << "        args is a set of optional arguments that define algorithmic tweaks and variations\n"
+             << "         -reorder: reorder the elements of the arrays so that each 1-D FFT will use contiguous data\n"
+             << "         -no-reorder: some of the 1-D will be strided (non contiguous)\n"
+             << "         -pencils: use pencil reshape logic\n"
+             << "         -slabs: use slab reshape logic\n"
+             << "         -io_pencils: if input and output proc grids are pencils, useful for comparison with other libraries \n"
+             << "         -ingrid x y z: specifies the input processor grid, x * y * z must equal num-ranks\n"
+             << "         -outgrid x y z: specifies the output processor grid, x * y * z must equal num-ranks\n"
+             << "         -r2c_dir dir: simulate the r2c transform with the given direction\n"
+             << "         -sample n: number of ranks to simulate for the message statistics\n"
+             << "                    (default: all ranks up to 4096 and 64 ranks otherwise)\n"
+             << "         -single: report the bytes for single precision complex entries (default double)\n"
+             << "         -long: use long long indexing\n"
+             << "    the statistics cover the sampled ranks, the plan itself is computed for all ranks\n\n"
+             << "Examples:\n"
+             << "    ./plan_simulator 1024 1024 1024 4096\n"
+             << "    ./plan_simulator 2048 2048 2048 65536 -slabs -sample 16\n"
+             << "    ./plan_simulator 4096 4096 4096 262144 -io_pencils -long\n\n";
+        return 0;
+    }
+
+    std::array<int, 3> size_fft = {0, 0, 0};
+    int num_ranks = 0;
+    try{
+        size_fft = {std::stoi(argv[1]), std::stoi(argv[2]), std::stoi(argv[3])};
+        for(auto s : size_fft) if (s < 1) throw std::invalid_argument("negative input");
+        num_ranks = std::stoi(argv[4]);
+        if (num_ranks < 1) throw std::invalid_argument("negative input");
+    }catch(std::invalid_argument &e){
+        std::cout << "Cannot convert the sizes and ranks into positive integers!\n";
+        std::cout << "Encountered error: " << e.what() << std::endl;
+        return 0;
+    }
+
+    std::deque<std::string> args = arguments(argc, argv);
+    try{
+        if (has_option(args, "-long"))
+            simulate_plan<long long>(size_fft, num_ranks, args);
+        else
+            simulate_plan<int>(size_fft, num_ranks, args);
+    }catch(std::exception &e){
+        std::cout << "Simulation failed with error: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+       Performance test for 2D FFTs, compares the 2D planner with the 3D plan logic applied to a 2D problem
+*/
+
+#include "test_fft3d.h"
+
+/*
+ * Returns the number of reshapes that move data in the plan, i.e., excluding the local transposes.
+ */
+template<typename index>
+int count_reshapes(logic_plan3d<index> const &plan){
+    int result = 0;
+    for(int i=0; i<4; i++)
+        if (not match(plan.in_shape[i], plan.out_shape[i])) result++;
+    return result;
+}
+
+/*
+ * Returns the number of 1D transform stages of the plan, the directions of size one are skipped.
+ */
+template<typename index>
+int count_fft_stages(logic_plan3d<index> const &plan){
+    int result = 0;
+    for(int i=0; i<3; i++)
+        if (plan.fft_sizes[plan.fft_direction[i]] > 1) result++;
+    return result;
+}
+
+/*
+ * Times the forward and backward transforms using the 2D planner and the 3D plan logic, returns the average time
+ * of a forward/backward pair in seconds (the max across all ranks) and verifies that the round trip recovers the input.
+ */
+template<typename backend_tag, typename precision_type>
+double time_transform(box3d<int> const world, box3d<int> const inbox, box3d<int> const outbox,
+                      heffte::plan_options const options, int ntest, MPI_Comm const comm){
+    using data_type = std::complex<precision_type>;
+
+    auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, options);
+
+    std::vector<data_type> input = make_data<data_type>(inbox);
+    std::vector<data_type> const reference = input;
+    std::vector<data_type> output(fft.size_outbox());
+    std::vector<data_type> workspace(fft.size_workspace());
+
+    // warmup
+    fft.forward(input.data(), output.data(), workspace.data(), scale::full);
+    fft.backward(output.data(), input.data(), workspace.data());
+
+    MPI_Barrier(comm);
+    double t = -MPI_Wtime();
+    for(int i=0; i<ntest; i++){
+        fft.forward(input.data(), output.data(), workspace.data(), scale::full);
+        fft.backward(output.data(), input.data(), workspace.data());
+    }
+    MPI_Barrier(comm);
+    t += MPI_Wtime();
+
+    double t_max = 0.0;
+    MPI_Allreduce(&t, &t_max, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    precision_type err = 0.0;
+    for(size_t i=0; i<input.size(); i++)
+        err = std::max(err, std::abs(reference[i] - input[i]));
+    precision_type mpi_max_err = 0.0;
+    MPI_Allreduce(&err, &mpi_max_err, 1, mpi::type_from<precision_type>(), MPI_MAX, comm);
+    if (mpi_max_err > precision<data_type>::tolerance)
+        throw std::runtime_error("observed error after the heFFTe benchmark exceeds the tolerance, world "
+                                 + std::to_string(world.size[0]) + "x" + std::to_string(world.size[1]));
+
+    return t_max / static_cast<double>(ntest);
+}
+
+template<typename backend_tag, typename precision_type>
+void benchmark_fft2d(std::array<int, 2> size_fft, std::deque<std::string> const &args){
+    MPI_Comm const comm = MPI_COMM_WORLD;
+    int const me = mpi::comm_rank(comm);
+    int const nprocs = mpi::comm_size(comm);
+
+    box3d<int> const world = {{0, 0, 0}, {size_fft[0] - 1, size_fft[1] - 1, 0}};
+
+    // by default the input and output use the brick grid with minimum surface
+    std::array<int, 3> proc_i = heffte::proc_setup_min_surface(world, nprocs);
+    std::array<int, 3> proc_o = proc_i;
+    if (has_option(args, "-io_slabs")){
+        proc_i = {1, nprocs, 1};
+        proc_o = {nprocs, 1, 1};
+    }
+    if (has_option(args, "-ingrid"))
+        proc_i = get_grid(args, "-ingrid");
+    if (has_option(args, "-outgrid"))
+        proc_o = get_grid(args, "-outgrid");
+
+    if (proc_i[0] * proc_i[1] * proc_i[2] != nprocs or proc_o[0] * proc_o[1] * proc_o[2] != nprocs)
+        throw std::runtime_error("the input or output processor grid does not match the number of ranks");
+
+    std::vector<box3d<int>> const inboxes  = heffte::split_world(world, proc_i);
+    std::vector<box3d<int>> const outboxes = heffte::split_world(world, proc_o);
+
+    heffte::plan_options options_2d = args_to_options<backend_tag>(args);
+    options_2d.use_2d_planner = true;
+    heffte::plan_options options_3d = options_2d;
+    options_3d.use_2d_planner = false;
+
+    int const ntest = nruns(args);
+    double const t2d = time_transform<backend_tag, precision_type>(world, inboxes[me], outboxes[me], options_2d, ntest, comm);
+    double const t3d = time_transform<backend_tag, precision_type>(world, inboxes[me], outboxes[me], options_3d, ntest, comm);
+
+    logic_plan3d<int> const plan_2d = plan_operations<int>({inboxes, outboxes}, -1, set_options<backend_tag>(options_2d), me);
+    logic_plan3d<int> const plan_3d = plan_operations<int>({inboxes, outboxes}, -1, set_options<backend_tag>(options_3d), me);
+
+    if (me == 0){
+        double const fftsize  = static_cast<double>(world.count());
+        auto floprate = [&](double t)->double{ return 5.0 * fftsize * std::log(fftsize) * 1e-9 / std::log(2.0) / (0.5 * t); };
+        cout << "\n----------------------------------------------------------------------------- \n";
+        cout << "heFFTe 2D performance test\n";
+        cout << "----------------------------------------------------------------------------- \n";
+        cout << "Backend:   " << backend::name<backend_tag>() << "\n";
+        cout << "Size:      " << world.size[0] << "x" << world.size[1] << "\n";
+        cout << "MPI ranks: " << std::setw(4) << nprocs << "\n";
+        cout << "Grids:     (" << proc_i[0] << ", " << proc_i[1] << ") -> (" << proc_o[0] << ", " << proc_o[1] << ")\n";
+        cout << "Precision: " << ((std::is_same<precision_type, float>::value) ? "SINGLE" : "DOUBLE") << "\n";
+        cout << std::setw(12) << "planner" << std::setw(12) << "reshapes" << std::setw(12) << "1d stages"
+             << std::setw(16) << "time (s)" << std::setw(12) << "GFlops/s" << "\n";
+        cout << std::setw(12) << "2d" << std::setw(12) << count_reshapes(plan_2d) << std::setw(12) << count_fft_stages(plan_2d)
+             << std::setw(16) << 0.5 * t2d << std::setw(12) << floprate(t2d) << "\n";
+        cout << std::setw(12) << "3d" << std::setw(12) << count_reshapes(plan_3d) << std::setw(12) << count_fft_stages(plan_3d)
+             << std::setw(16) << 0.5 * t3d << std::setw(12) << floprate(t3d) << "\n";
+        cout << "Speedup:   " << t3d / t2d << "\n";
+        cout << endl;
+    }
+}
+
+template<typename backend_tag>
+bool perform_benchmark(std::string const &precision_string, std::string const &backend_string, std::string const &backend_name,
+                       std::array<int, 2> size_fft, std::deque<std::string> const &args){
+    if (backend_string == backend_name){
+        if (precision_string == "float"){
+            benchmark_fft2d<backend_tag, float>(size_fft, args);
+        }else{
+            benchmark_fft2d<backend_tag, double>(size_fft, args);
+        }
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char *argv[]){
+
+    MPI_Init(&argc, &argv);
+
+    std::string backends = "stock ";
+    #ifdef Heffte_ENABLE_FFTW
+    backends += "fftw ";
+    #endif
+    #ifdef Heffte_ENABLE_MKL
+    backends += "mkl ";
+    #endif
+
+    if (argc < 5){
+        if (mpi::world_rank(0)){
+            cout << "\nUsage:\n    mpirun -np x ./speed2d <backend> <precision> <size-x> <size-y> <args>\n\n"
+                 << "    options\n"
+                 << "        backend is the 1-D FFT library\n"
+                 << "            available options for this build: " << backends << "\n"
+                 << "        precision is either float or double\n"
+                 << "        size-x/y are the 2D array dimensions \n\n"
+                 << "        args is a set of optional arguments that define algorithmic tweaks and variations\n"
+                 << "         -reorder: reorder the elements of the arrays so that each 1-D FFT will use contiguous data\n"
+                 << "         -no-reorder: some of the 1-D will be strided (non contiguous)\n"
+                 << "         -a2a: use MPI_Alltoall communication method\n"
+                 << "         -a2av: use MPI_Alltoallv communication method\n"
+                 << "         -p2p: use MPI_Send and MPI_Irecv communication methods\n"
+                 << "         -p2p_pl: use MPI_Isend and MPI_Irecv communication methods\n"
+                 << "         -io_slabs: the input uses slabs in x and the output uses slabs in y\n"
+                 << "         -ingrid x y 1: specifies the processor grid to use in the input\n"
+                 << "         -outgrid x y 1: specifies the processor grid to use in the output\n"
+                 << "         -nX: number of times to repeat the run, accepted variants are -n5 (default), -n10, -n50\n"
+                 << "    the benchmark runs the transform using the 2D planner and the 3D plan logic applied to the 2D problem\n\n"
+                 << "Examples:\n"
+                 << "    mpirun -np  4 ./speed2d fftw  double 8192 8192\n"
+                 << "    mpirun -np 16 ./speed2d fftw  double 16384 16384 -io_slabs -p2p\n"
+                 << "    mpirun -np 64 ./speed2d stock float  65536 65536\n\n";
+        }
+
+        MPI_Finalize();
+        return 0;
+    }
+
+    std::string const backend_string = argv[1];
+
+    std::string const precision_string = argv[2];
+    if (precision_string != "float" and precision_string != "double"){
+        if (mpi::world_rank(0)){
+            std::cout << "Invalid precision!\n";
+            std::cout << "Must use float or double" << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    std::array<int, 2> size_fft = {0, 0};
+    try{
+        size_fft = {std::stoi(argv[3]), std::stoi(argv[4])};
+        for(auto s : size_fft) if (s < 1) throw std::invalid_argument("negative input");
+    }catch(std::invalid_argument &e){
+        if (mpi::world_rank(0)){
+            std::cout << "Cannot convert the sizes into positive integers!\n";
+            std::cout << "Encountered error: " << e.what() << std::endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    bool valid_backend = false;
+    valid_backend = valid_backend or perform_benchmark<backend::stock>(precision_string, backend_string, "stock", size_fft, arguments(argc, argv));
+    #ifdef Heffte_ENABLE_FFTW
+    valid_backend = valid_backend or perform_benchmark<backend::fftw>(precision_string, backend_string, "fftw", size_fft, arguments(argc, argv));
+    #endif
+    #ifdef Heffte_ENABLE_MKL
+    valid_backend = valid_backend or perform_benchmark<backend::mkl>(precision_string, backend_string, "mkl", size_fft, arguments(argc, argv));
+    #endif
+
+    if (not valid_backend){
+        if (mpi::world_rank(0)){
+            std::cout << "Invalid backend " << backend_string << "\n";
+            std::cout << "The available backends are: " << backends << std::endl;
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
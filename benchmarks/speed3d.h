@@ -7,6 +7,10 @@
 
 #include "test_fft3d.h"
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
 #ifdef BENCH_C2C
 template<typename precision>
 struct bench_types{
@@ -29,6 +33,21 @@ struct bench_types{
 };
 #endif
 
+// returns the peak resident memory of the process in MB, or -1 if the platform does not report it
+inline long long peak_resident_memory(){
+    #if defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+    #ifdef __APPLE__
+    return static_cast<long long>(usage.ru_maxrss) / (1024ll * 1024ll); // bytes
+    #else
+    return static_cast<long long>(usage.ru_maxrss) / 1024ll; // kilobytes
+    #endif
+    #else
+    return -1;
+    #endif
+}
+
 template<typename backend_tag, typename precision_type, typename index>
 void benchmark_fft(std::array<int,3> size_fft, std::deque<std::string> const &args){
 
@@ -156,6 +175,11 @@ void benchmark_fft(std::array<int,3> size_fft, std::deque<std::string> const &ar
     // Define workspace array
     typename heffte::fft3d<backend_tag>::template buffer_container<output_type> workspace(batch_size * fft.size_workspace());
 
+    // the autotuning may select a different algorithm, reorder or grid, report the grids used by the tuned plan
+    bool const tuned = options.use_autotune or options.grid_search != grid_selection::heuristic;
+    if (tuned)
+        grids = compute_grids(plan_operations<index>({inboxes, outboxes}, r2c_dir, fft.get_options(), me));
+
     // Warmup
     heffte::add_trace("mark warmup begin");
     fft.forward(input_array, output_array,  scale::full);
@@ -224,6 +248,11 @@ void benchmark_fft(std::array<int,3> size_fft, std::deque<std::string> const &ar
         return;
     }
 
+    // the peak includes the reference data and the workspace allocated by the warmup run
+    long long const peak_memory = peak_resident_memory();
+    long long max_peak_memory = 0;
+    MPI_Reduce(&peak_memory, &max_peak_memory, 1, MPI_LONG_LONG, MPI_MAX, 0, fft_comm);
+
     // Print results
     if(me==0){
         t_max = t_max / (2.0 * ntest);
@@ -233,6 +262,7 @@ void benchmark_fft(std::array<int,3> size_fft, std::deque<std::string> const &ar
                             + static_cast<long long>(fft.size_workspace());
         mem_usage *= sizeof(output_type);
         mem_usage /= 1024ll * 1024ll; // convert to MB
+        long long const workspace_usage = static_cast<long long>(fft.size_workspace()) * sizeof(output_type) / (1024ll * 1024ll);
         cout << "\n----------------------------------------------------------------------------- \n";
         cout << "heFFTe performance test\n";
         cout << "----------------------------------------------------------------------------- \n";
@@ -243,11 +273,22 @@ void benchmark_fft(std::array<int,3> size_fft, std::deque<std::string> const &ar
         for(int i=0; i<5; i++)
             print_proc_grid(i);
         cout << "\n";
+        if (tuned)
+            cout << "Autotuned: " << fft.get_options() << "\n";
         cout << "Time per run: " << t_max << " (s)\n";
         cout << "Performance:  " << floprate << " GFlops/s\n";
         cout << "Memory usage: " << mem_usage << "MB/rank\n";
+        cout << "Workspace:    " << workspace_usage << "MB/rank" << ((fft.get_options().use_low_memory) ? " (low-memory mode)" : "") << "\n";
+        if (max_peak_memory > 0)
+            cout << "Peak memory:  " << max_peak_memory << "MB/rank (max resident set size)\n";
         cout << "Tolerance:    " << precision<std::complex<precision_type>>::tolerance << "\n";
         cout << "Max error:    " << mpi_max_err << "\n";
+        if (has_option(args, "-cost")){
+            // the options of the plan include any changes made by the autotuning
+            cout << "\nEstimated cost per transform:\n"
+                 << estimate_plan_cost(plan_operations<index>({inboxes, outboxes}, r2c_dir, fft.get_options(), me),
+                                       sizeof(output_type), r2c_dir);
+        }
         cout << endl;
     }
 }
@@ -272,7 +313,13 @@ bool perform_benchmark(std::string const &precision_string, std::string const &b
 
 int main(int argc, char *argv[]){
 
-    MPI_Init(&argc, &argv);
+    // the progress thread calls MPI concurrently with the main thread
+    if (std::any_of(argv, argv + argc, [](char const *a)->bool{ return (std::string(a) == "-progress-thread"); })){
+        int provided = MPI_THREAD_SINGLE;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+    }else{
+        MPI_Init(&argc, &argv);
+    }
 
     #ifdef BENCH_C2C
     std::string bench_executable = "./speed3d_c2c";
@@ -337,12 +384,19 @@ int main(int argc, char *argv[]){
                  << "         -p2p: use MPI_Send() and MPI_Irecv() communication methods\n"
                  << "         -p2p_pl: use MPI_Isend() and MPI_Irecv() communication methods\n"
                  << "         -no-gpu-aware: move the data to the cpu before doing gpu operations (gpu backends only)\n"
+                 << "         -autotune: time all communication algorithms with and without reorder, then use the fastest\n"
+                 << "         -grid-model: select the processor grid and pencils/slabs using a communication cost model\n"
+                 << "         -grid-measure: time the processor grids with lowest estimated cost, then use the fastest\n"
+                 << "         -cost: print the estimated communication volume, flops and workspace of the plan\n"
+                 << "         -low-memory: exchange data with one rank at a time and reuse the output array to reduce the workspace\n"
                  << "         -pencils: use pencil reshape logic\n"
                  << "         -slabs: use slab reshape logic\n"
                  << "         -io_pencils: if input and output proc grids are pencils, useful for comparison with other libraries \n"
                  << "         -ingrid x y z: specifies the processor grid to use in the input, x y z must be integers \n"
                  << "         -outgrid x y z: specifies the processor grid to use in the output, x y z must be integers \n"
                  << "         -subcomm num_ranks: specifies the number of ranks to use in intermediate reshapes\n"
+                 << "         -threads num_threads: specifies the number of OpenMP threads used by the CPU stages of the transform\n"
+                 << "         -progress-thread: use a helper thread to progress the MPI messages, requires MPI_THREAD_MULTIPLE\n"
                  << "         -batch batch_size: specifies the size of the batch to use in the benchmark\n"
                  << "         -r2c_dir dir: specifies the r2c direction for the r2c tests, dir must be 0 1 or 2 \n"
                  << "         -mps: for the cufft backend and multiple gpus, associate the mpi ranks with different cuda devices\n"
@@ -26,6 +26,15 @@ if ("@Heffte_ENABLE_FFTW@")
     endif()
 endif()
 
+if (NOT TARGET Threads::Threads)
+    set(THREADS_PREFER_PTHREAD_FLAG TRUE)
+    find_package(Threads REQUIRED)
+endif()
+
+if ("@Heffte_ENABLE_OPENMP@" AND NOT TARGET OpenMP::OpenMP_CXX)
+    find_package(OpenMP REQUIRED)
+endif()
+
 if (@Heffte_ENABLE_MKL@ AND NOT TARGET Heffte::MKL)
     add_library(Heffte::MKL INTERFACE IMPORTED GLOBAL)
     target_link_libraries(Heffte::MKL INTERFACE @Heffte_MKL_LIBRARIES@)
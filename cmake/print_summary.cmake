@@ -12,7 +12,7 @@ if (Heffte_ENABLE_ROCM)
     list(APPEND HEFFTE_OPTIONS "CMAKE_HIP_FLAGS")
 endif()
 
-foreach(_opt FFTW MKL CUDA ROCM ONEAPI AVX AVX512 PYTHON FORTRAN TRACING TESTING)
+foreach(_opt FFTW MKL CUDA ROCM ONEAPI AVX AVX512 OPENMP PYTHON FORTRAN TRACING TESTING)
     list(APPEND HEFFTE_OPTIONS "Heffte_ENABLE_${_opt}")
 endforeach()
 
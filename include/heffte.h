@@ -10,6 +10,8 @@
 #ifdef __cplusplus
 
 #include "heffte_fft3d_r2c.h"
+#include "heffte_fft1d.h"
+#include "heffte_fft3d_mixed.h"
 
 #else
 
@@ -82,6 +82,14 @@ namespace cuda {
     template<typename scalar_type, typename index>
     void scale_data(cudaStream_t stream, index num_entries, scalar_type *data, double scale_factor);
 
+    /*!
+     * \ingroup hefftecuda
+     * \brief Pointwise product of complex data, y = scale_factor * x * y or the conjugate of x is used.
+     */
+    template<typename precision_type, typename index>
+    void multiply_data(cudaStream_t stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                       bool conjugate, double scale_factor);
+
     /*!
      * \ingroup hefftecuda
      * \brief Performs a direct-pack operation for data sitting on the GPU device.
@@ -845,6 +853,15 @@ namespace data_scaling {
     void apply(cudaStream_t stream, index num_entries, std::complex<precision_type> *data, double scale_factor){
         apply<precision_type>(stream, 2*num_entries, reinterpret_cast<precision_type*>(data), scale_factor);
     }
+    /*!
+     * \ingroup hefftecuda
+     * \brief Pointwise product of complex data, see the cpu variant.
+     */
+    template<typename precision_type, typename index>
+    void multiply(cudaStream_t stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                  bool conjugate, double scale_factor){
+        cuda::multiply_data<precision_type, long long>(stream, static_cast<long long>(num_entries), x, y, conjugate, scale_factor);
+    }
 }
 
 /*!
@@ -139,10 +139,13 @@ struct plan_fftw<std::complex<float>, dir>{
                                       );
         }
     }
-    //! \brief Identical to the float-complex specialization.
-    plan_fftw(int size1, int size2, int size3){
-        std::array<int, 3> size = {size3, size2, size1};
-        plan = fftwf_plan_many_dft(3, size.data(), 1, nullptr, nullptr, 1, 1, nullptr, nullptr, 1, 1,
+    //! \brief Constructor for a single 3-D transform, takes inputs similar to fftwf_plan_many_dft().
+    plan_fftw(int size1, int size2, int size3) : plan_fftw(std::array<int, 3>{size1, size2, size3}, 1){}
+    //! \brief Constructor for \b howmanyffts 3-D transforms with sizes \b size3d stored back-to-back.
+    plan_fftw(std::array<int, 3> const &size3d, int howmanyffts){
+        std::array<int, 3> size = {size3d[2], size3d[1], size3d[0]};
+        int const dist = size3d[0] * size3d[1] * size3d[2];
+        plan = fftwf_plan_many_dft(3, size.data(), howmanyffts, nullptr, nullptr, 1, dist, nullptr, nullptr, 1, dist,
                                    (dir == direction::forward) ? FFTW_FORWARD : FFTW_BACKWARD, FFTW_ESTIMATE);
     }
     //! \brief Destructor, deletes the plan.
@@ -182,9 +185,12 @@ struct plan_fftw<std::complex<double>, dir>{
         }
     }
     //! \brief Identical to the float-complex specialization.
-    plan_fftw(int size1, int size2, int size3){
-        std::array<int, 3> size = {size3, size2, size1};
-        plan = fftw_plan_many_dft(3, size.data(), 1, nullptr, nullptr, 1, 1, nullptr, nullptr, 1, 1,
+    plan_fftw(int size1, int size2, int size3) : plan_fftw(std::array<int, 3>{size1, size2, size3}, 1){}
+    //! \brief Identical to the float-complex specialization.
+    plan_fftw(std::array<int, 3> const &size3d, int howmanyffts){
+        std::array<int, 3> size = {size3d[2], size3d[1], size3d[0]};
+        int const dist = size3d[0] * size3d[1] * size3d[2];
+        plan = fftw_plan_many_dft(3, size.data(), howmanyffts, nullptr, nullptr, 1, dist, nullptr, nullptr, 1, dist,
                                   (dir == direction::forward) ? FFTW_FORWARD : FFTW_BACKWARD, FFTW_ESTIMATE);
     }
     //! \brief Identical to the float-complex specialization.
@@ -293,26 +299,50 @@ public:
             fftw_execute_dft(*zbackward, block_data, block_data);
         }
     }
+    //! \brief Forward fft on a batch of boxes, float-complex case.
+    void forward(int batch_size, std::complex<float> data[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, data, workspace);
+        make_plan(cforward_batch, batch_size);
+        fftwf_execute_dft(*cforward_batch.plan, reinterpret_cast<fftwf_complex*>(data), reinterpret_cast<fftwf_complex*>(data));
+    }
+    //! \brief Backward fft on a batch of boxes, float-complex case.
+    void backward(int batch_size, std::complex<float> data[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, data, workspace);
+        make_plan(cbackward_batch, batch_size);
+        fftwf_execute_dft(*cbackward_batch.plan, reinterpret_cast<fftwf_complex*>(data), reinterpret_cast<fftwf_complex*>(data));
+    }
+    //! \brief Forward fft on a batch of boxes, double-complex case.
+    void forward(int batch_size, std::complex<double> data[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, data, workspace);
+        make_plan(zforward_batch, batch_size);
+        fftw_execute_dft(*zforward_batch.plan, reinterpret_cast<fftw_complex*>(data), reinterpret_cast<fftw_complex*>(data));
+    }
+    //! \brief Backward fft on a batch of boxes, double-complex case.
+    void backward(int batch_size, std::complex<double> data[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, data, workspace);
+        make_plan(zbackward_batch, batch_size);
+        fftw_execute_dft(*zbackward_batch.plan, reinterpret_cast<fftw_complex*>(data), reinterpret_cast<fftw_complex*>(data));
+    }
 
     //! \brief Converts the real data to complex and performs float-complex forward transform.
     void forward(float const indata[], std::complex<float> outdata[], std::complex<float> *workspace) const override{
-        for(int i=0; i<total_size; i++) outdata[i] = std::complex<float>(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::complex<float>(indata[i]); });
         forward(outdata, workspace);
     }
     //! \brief Performs backward float-complex transform and truncates the complex part of the result.
     void backward(std::complex<float> indata[], float outdata[], std::complex<float> *workspace) const override{
         backward(indata, workspace);
-        for(int i=0; i<total_size; i++) outdata[i] = std::real(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::real(indata[i]); });
     }
     //! \brief Converts the real data to complex and performs double-complex forward transform.
     void forward(double const indata[], std::complex<double> outdata[], std::complex<double> *workspace) const override{
-        for(int i=0; i<total_size; i++) outdata[i] = std::complex<double>(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::complex<double>(indata[i]); });
         forward(outdata, workspace);
     }
     //! \brief Performs backward double-complex transform and truncates the complex part of the result.
     void backward(std::complex<double> indata[], double outdata[], std::complex<double> *workspace) const override{
         backward(indata, workspace);
-        for(int i=0; i<total_size; i++) outdata[i] = std::real(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::real(indata[i]); });
     }
 
     //! \brief Returns the size of the box.
@@ -333,6 +363,35 @@ private:
                 plan = std::unique_ptr<plan_fftw<scalar_type, dir>>(new plan_fftw<scalar_type, dir>(size, size2, embed, howmanyffts, stride, dist));
         }
     }
+    /*!
+     * \brief Returns true if the boxes of a batch can be handled with a single plan.
+     *
+     * The transforms of consecutive boxes must line up with the same distance, i.e., the transforms of the second box
+     * must start where the transforms of the first box would continue.
+     * This holds for the transforms along the fast dimension and for the merged transforms that include the fast dimension.
+     */
+    bool contiguous_batch() const{ return (dist == 0) or (blocks == 1 and howmanyffts * dist == total_size); }
+    //! \brief Holds a plan for a batch of boxes and the size of the batch.
+    template<typename scalar_type, direction dir>
+    struct batch_plan{
+        //! \brief The number of boxes in the batch, the plan is re-created if the batch size changes.
+        int batch_size = 0;
+        //! \brief The plan covering the entire batch.
+        std::unique_ptr<plan_fftw<scalar_type, dir>> plan;
+    };
+    //! \brief Helper template to create the plan for a batch of boxes.
+    template<typename scalar_type, direction dir>
+    void make_plan(batch_plan<scalar_type, dir> &bplan, int batch_size) const{
+        if (bplan.batch_size != batch_size){
+            bplan.batch_size = batch_size;
+            if (dist == 0)
+                bplan.plan = std::unique_ptr<plan_fftw<scalar_type, dir>>(new plan_fftw<scalar_type, dir>(std::array<int, 3>{size, size2, howmanyffts}, batch_size));
+            else if (size2 == 0)
+                bplan.plan = std::unique_ptr<plan_fftw<scalar_type, dir>>(new plan_fftw<scalar_type, dir>(size, batch_size * howmanyffts, stride, dist));
+            else
+                bplan.plan = std::unique_ptr<plan_fftw<scalar_type, dir>>(new plan_fftw<scalar_type, dir>(size, size2, embed, batch_size * howmanyffts, stride, dist));
+        }
+    }
 
     int size, size2, howmanyffts, stride, dist, blocks, block_stride, total_size;
     std::array<int, 2> embed;
@@ -340,6 +399,10 @@ private:
     mutable std::unique_ptr<plan_fftw<std::complex<float>, direction::backward>> cbackward;
     mutable std::unique_ptr<plan_fftw<std::complex<double>, direction::forward>> zforward;
     mutable std::unique_ptr<plan_fftw<std::complex<double>, direction::backward>> zbackward;
+    mutable batch_plan<std::complex<float>, direction::forward> cforward_batch;
+    mutable batch_plan<std::complex<float>, direction::backward> cbackward_batch;
+    mutable batch_plan<std::complex<double>, direction::forward> zforward_batch;
+    mutable batch_plan<std::complex<double>, direction::backward> zbackward_batch;
 };
 
 /*!
@@ -468,6 +531,30 @@ public:
             fftw_execute_dft_c2r(*dbackward, cdata, outdata + i * rblock_stride);
         }
     }
+    //! \brief Forward transform on a batch of boxes, single precision.
+    void forward(int batch_size, float const indata[], std::complex<float> outdata[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, indata, outdata, workspace);
+        make_plan(sforward_batch, batch_size);
+        fftwf_execute_dft_r2c(*sforward_batch.plan, const_cast<float*>(indata), reinterpret_cast<fftwf_complex*>(outdata));
+    }
+    //! \brief Backward transform on a batch of boxes, single precision.
+    void backward(int batch_size, std::complex<float> indata[], float outdata[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, indata, outdata, workspace);
+        make_plan(sbackward_batch, batch_size);
+        fftwf_execute_dft_c2r(*sbackward_batch.plan, reinterpret_cast<fftwf_complex*>(indata), outdata);
+    }
+    //! \brief Forward transform on a batch of boxes, double precision.
+    void forward(int batch_size, double const indata[], std::complex<double> outdata[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, indata, outdata, workspace);
+        make_plan(dforward_batch, batch_size);
+        fftw_execute_dft_r2c(*dforward_batch.plan, const_cast<double*>(indata), reinterpret_cast<fftw_complex*>(outdata));
+    }
+    //! \brief Backward transform on a batch of boxes, double precision.
+    void backward(int batch_size, std::complex<double> indata[], double outdata[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, indata, outdata, workspace);
+        make_plan(dbackward_batch, batch_size);
+        fftw_execute_dft_c2r(*dbackward_batch.plan, reinterpret_cast<fftw_complex*>(indata), outdata);
+    }
 
     //! \brief Returns the size of the box with real data.
     int box_size() const override{ return rsize; }
@@ -482,6 +569,25 @@ private:
     void make_plan(std::unique_ptr<plan_fftw<scalar_type, dir>> &plan) const{
         if (!plan) plan = std::unique_ptr<plan_fftw<scalar_type, dir>>(new plan_fftw<scalar_type, dir>(size, howmanyffts, stride, rdist, cdist));
     }
+    //! \brief Returns true if the boxes of a batch can be handled with a single plan, see fftw_executor::contiguous_batch().
+    bool contiguous_batch() const{ return (blocks == 1 and howmanyffts * rdist == rsize and howmanyffts * cdist == csize); }
+    //! \brief Holds a plan for a batch of boxes and the size of the batch.
+    template<typename scalar_type, direction dir>
+    struct batch_plan{
+        //! \brief The number of boxes in the batch, the plan is re-created if the batch size changes.
+        int batch_size = 0;
+        //! \brief The plan covering the entire batch.
+        std::unique_ptr<plan_fftw<scalar_type, dir>> plan;
+    };
+    //! \brief Helper template to create the plan for a batch of boxes.
+    template<typename scalar_type, direction dir>
+    void make_plan(batch_plan<scalar_type, dir> &bplan, int batch_size) const{
+        if (bplan.batch_size != batch_size){
+            bplan.batch_size = batch_size;
+            bplan.plan = std::unique_ptr<plan_fftw<scalar_type, dir>>(
+                new plan_fftw<scalar_type, dir>(size, batch_size * howmanyffts, stride, rdist, cdist));
+        }
+    }
 
     int size, howmanyffts, stride, blocks;
     int rdist, cdist, rblock_stride, cblock_stride, rsize, csize;
@@ -489,6 +595,10 @@ private:
     mutable std::unique_ptr<plan_fftw<double, direction::forward>> dforward;
     mutable std::unique_ptr<plan_fftw<float, direction::backward>> sbackward;
     mutable std::unique_ptr<plan_fftw<double, direction::backward>> dbackward;
+    mutable batch_plan<float, direction::forward> sforward_batch;
+    mutable batch_plan<double, direction::forward> dforward_batch;
+    mutable batch_plan<float, direction::backward> sbackward_batch;
+    mutable batch_plan<double, direction::backward> dbackward_batch;
 };
 
 /*!
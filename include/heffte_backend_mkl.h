@@ -142,12 +142,24 @@ struct plan_mkl{
      * \param size2 is the number of entries in a 3-D transform, direction 2
      * \param size3 is the number of entries in a 3-D transform, direction 3
      */
-    plan_mkl(int size1, int size2, int size3){
-        MKL_LONG size[] = {static_cast<MKL_LONG>(size3), static_cast<MKL_LONG>(size2), static_cast<MKL_LONG>(size1)};
+    plan_mkl(int size1, int size2, int size3) : plan_mkl(std::array<int, 3>{size1, size2, size3}, 1){}
+    /*!
+     * \brief Constructor for a batch of 3-D transforms stored back-to-back.
+     *
+     * \param size3d is the number of entries in a 3-D transform in each direction
+     * \param howmanyffts is the number of transforms in the batch
+     */
+    plan_mkl(std::array<int, 3> const &size3d, int howmanyffts){
+        MKL_LONG size[] = {static_cast<MKL_LONG>(size3d[2]), static_cast<MKL_LONG>(size3d[1]), static_cast<MKL_LONG>(size3d[0])};
         check_error( DftiCreateDescriptor(&plan, (std::is_same<scalar_type, std::complex<float>>::value) ?
                                                   DFTI_SINGLE : DFTI_DOUBLE,
                                           DFTI_COMPLEX, 3, size), "mkl plan create 3d" );
-        check_error( DftiSetValue(plan, DFTI_NUMBER_OF_TRANSFORMS, 1), "mkl set howmany");
+        check_error( DftiSetValue(plan, DFTI_NUMBER_OF_TRANSFORMS, static_cast<MKL_LONG>(howmanyffts)), "mkl set howmany");
+        if (howmanyffts > 1){
+            MKL_LONG const dist = size[0] * size[1] * size[2];
+            check_error( DftiSetValue(plan, DFTI_INPUT_DISTANCE, dist), "mkl set idist");
+            check_error( DftiSetValue(plan, DFTI_OUTPUT_DISTANCE, dist), "mkl set odist");
+        }
         check_error( DftiSetValue(plan, DFTI_PLACEMENT, DFTI_INPLACE), "mkl set in place");
         check_error( DftiCommitDescriptor(plan), "mkl commit");
     }
@@ -260,26 +272,50 @@ public:
             DftiComputeBackward(*zplan, block_data);
         }
     }
+    //! \brief Forward fft on a batch of boxes, float-complex case.
+    void forward(int batch_size, std::complex<float> data[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, data, workspace);
+        make_plan(cplan_batch, batch_size);
+        DftiComputeForward(*cplan_batch.plan, reinterpret_cast<float _Complex*>(data));
+    }
+    //! \brief Backward fft on a batch of boxes, float-complex case.
+    void backward(int batch_size, std::complex<float> data[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, data, workspace);
+        make_plan(cplan_batch, batch_size);
+        DftiComputeBackward(*cplan_batch.plan, reinterpret_cast<float _Complex*>(data));
+    }
+    //! \brief Forward fft on a batch of boxes, double-complex case.
+    void forward(int batch_size, std::complex<double> data[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, data, workspace);
+        make_plan(zplan_batch, batch_size);
+        DftiComputeForward(*zplan_batch.plan, reinterpret_cast<double _Complex*>(data));
+    }
+    //! \brief Backward fft on a batch of boxes, double-complex case.
+    void backward(int batch_size, std::complex<double> data[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, data, workspace);
+        make_plan(zplan_batch, batch_size);
+        DftiComputeBackward(*zplan_batch.plan, reinterpret_cast<double _Complex*>(data));
+    }
 
     //! \brief Converts the real data to complex and performs float-complex forward transform.
     void forward(float const indata[], std::complex<float> outdata[], std::complex<float> *workspace) const override{
-        for(int i=0; i<total_size; i++) outdata[i] = std::complex<float>(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::complex<float>(indata[i]); });
         forward(outdata, workspace);
     }
     //! \brief Performs backward float-complex transform and truncates the complex part of the result.
     void backward(std::complex<float> indata[], float outdata[], std::complex<float> *workspace) const override{
         backward(indata, workspace);
-        for(int i=0; i<total_size; i++) outdata[i] = std::real(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::real(indata[i]); });
     }
     //! \brief Converts the real data to complex and performs double-complex forward transform.
     void forward(double const indata[], std::complex<double> outdata[], std::complex<double> *workspace) const override{
-        for(int i=0; i<total_size; i++) outdata[i] = std::complex<double>(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::complex<double>(indata[i]); });
         forward(outdata, workspace);
     }
     //! \brief Performs backward double-complex transform and truncates the complex part of the result.
     void backward(std::complex<double> indata[], double outdata[], std::complex<double> *workspace) const override{
         backward(indata, workspace);
-        for(int i=0; i<total_size; i++) outdata[i] = std::real(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::real(indata[i]); });
     }
 
     //! \brief Returns the size of the box.
@@ -300,11 +336,42 @@ private:
                 plan = std::unique_ptr<plan_mkl<scalar_type>>(new plan_mkl<scalar_type>(size, size2, embed, howmanyffts, dist));
         }
     }
+    /*!
+     * \brief Returns true if the boxes of a batch can be handled with a single descriptor.
+     *
+     * The transforms of consecutive boxes must line up with the same distance, i.e., the transforms of the second box
+     * must start where the transforms of the first box would continue.
+     * This holds for the transforms along the fast dimension and for the merged transforms that include the fast dimension.
+     */
+    bool contiguous_batch() const{ return (dist == 0) or (blocks == 1 and howmanyffts * dist == total_size); }
+    //! \brief Holds a descriptor for a batch of boxes and the size of the batch.
+    template<typename scalar_type>
+    struct batch_plan{
+        //! \brief The number of boxes in the batch, the descriptor is re-created if the batch size changes.
+        int batch_size = 0;
+        //! \brief The descriptor covering the entire batch, i.e., with DFTI_NUMBER_OF_TRANSFORMS set to cover all boxes.
+        std::unique_ptr<plan_mkl<scalar_type>> plan;
+    };
+    //! \brief Helper template to create the descriptor for a batch of boxes.
+    template<typename scalar_type>
+    void make_plan(batch_plan<scalar_type> &bplan, int batch_size) const{
+        if (bplan.batch_size != batch_size){
+            bplan.batch_size = batch_size;
+            if (dist == 0)
+                bplan.plan = std::unique_ptr<plan_mkl<scalar_type>>(new plan_mkl<scalar_type>(std::array<int, 3>{size, size2, howmanyffts}, batch_size));
+            else if (size2 == 0)
+                bplan.plan = std::unique_ptr<plan_mkl<scalar_type>>(new plan_mkl<scalar_type>(size, batch_size * howmanyffts, stride, dist));
+            else
+                bplan.plan = std::unique_ptr<plan_mkl<scalar_type>>(new plan_mkl<scalar_type>(size, size2, embed, batch_size * howmanyffts, dist));
+        }
+    }
 
     int size, size2, howmanyffts, stride, dist, blocks, block_stride, total_size;
     std::array<MKL_LONG, 2> embed;
     mutable std::unique_ptr<plan_mkl<std::complex<float>>> cplan;
     mutable std::unique_ptr<plan_mkl<std::complex<double>>> zplan;
+    mutable batch_plan<std::complex<float>> cplan_batch;
+    mutable batch_plan<std::complex<double>> zplan_batch;
 };
 
 /*!
@@ -422,6 +489,30 @@ public:
             DftiComputeBackward(*dbackward, cdata, outdata + i * rblock_stride);
         }
     }
+    //! \brief Forward transform on a batch of boxes, single precision.
+    void forward(int batch_size, float const indata[], std::complex<float> outdata[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, indata, outdata, workspace);
+        make_plan(sforward_batch, batch_size);
+        DftiComputeForward(*sforward_batch.plan, const_cast<float*>(indata), reinterpret_cast<float _Complex*>(outdata));
+    }
+    //! \brief Backward transform on a batch of boxes, single precision.
+    void backward(int batch_size, std::complex<float> indata[], float outdata[], std::complex<float> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, indata, outdata, workspace);
+        make_plan(sbackward_batch, batch_size);
+        DftiComputeBackward(*sbackward_batch.plan, reinterpret_cast<float _Complex*>(indata), outdata);
+    }
+    //! \brief Forward transform on a batch of boxes, double precision.
+    void forward(int batch_size, double const indata[], std::complex<double> outdata[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::forward(batch_size, indata, outdata, workspace);
+        make_plan(dforward_batch, batch_size);
+        DftiComputeForward(*dforward_batch.plan, const_cast<double*>(indata), reinterpret_cast<double _Complex*>(outdata));
+    }
+    //! \brief Backward transform on a batch of boxes, double precision.
+    void backward(int batch_size, std::complex<double> indata[], double outdata[], std::complex<double> *workspace) const override{
+        if (not contiguous_batch() or batch_size == 1) return executor_base::backward(batch_size, indata, outdata, workspace);
+        make_plan(dbackward_batch, batch_size);
+        DftiComputeBackward(*dbackward_batch.plan, reinterpret_cast<double _Complex*>(indata), outdata);
+    }
 
     //! \brief Returns the size of the box with real data.
     int box_size() const override{ return rsize; }
@@ -436,6 +527,25 @@ private:
     void make_plan(std::unique_ptr<plan_mkl_r2c<scalar_type, dir>> &plan) const{
         if (!plan) plan = std::unique_ptr<plan_mkl_r2c<scalar_type, dir>>(new plan_mkl_r2c<scalar_type, dir>(size, howmanyffts, stride, rdist, cdist));
     }
+    //! \brief Returns true if the boxes of a batch can be handled with a single descriptor, see mkl_executor::contiguous_batch().
+    bool contiguous_batch() const{ return (blocks == 1 and howmanyffts * rdist == rsize and howmanyffts * cdist == csize); }
+    //! \brief Holds a descriptor for a batch of boxes and the size of the batch.
+    template<typename scalar_type, direction dir>
+    struct batch_plan{
+        //! \brief The number of boxes in the batch, the descriptor is re-created if the batch size changes.
+        int batch_size = 0;
+        //! \brief The descriptor covering the entire batch.
+        std::unique_ptr<plan_mkl_r2c<scalar_type, dir>> plan;
+    };
+    //! \brief Helper template to create the descriptor for a batch of boxes.
+    template<typename scalar_type, direction dir>
+    void make_plan(batch_plan<scalar_type, dir> &bplan, int batch_size) const{
+        if (bplan.batch_size != batch_size){
+            bplan.batch_size = batch_size;
+            bplan.plan = std::unique_ptr<plan_mkl_r2c<scalar_type, dir>>(
+                new plan_mkl_r2c<scalar_type, dir>(size, batch_size * howmanyffts, stride, rdist, cdist));
+        }
+    }
 
     int size, howmanyffts, stride, blocks;
     int rdist, cdist, rblock_stride, cblock_stride, rsize, csize;
@@ -443,6 +553,10 @@ private:
     mutable std::unique_ptr<plan_mkl_r2c<double, direction::forward>> dforward;
     mutable std::unique_ptr<plan_mkl_r2c<float, direction::backward>> sbackward;
     mutable std::unique_ptr<plan_mkl_r2c<double, direction::backward>> dbackward;
+    mutable batch_plan<float, direction::forward> sforward_batch;
+    mutable batch_plan<double, direction::forward> dforward_batch;
+    mutable batch_plan<float, direction::backward> sbackward_batch;
+    mutable batch_plan<double, direction::backward> dbackward_batch;
 };
 
 /*!
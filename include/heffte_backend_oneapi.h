@@ -90,6 +90,14 @@ namespace oapi {
     template<typename scalar_type, typename index>
     void scale_data(sycl::queue &stream, index num_entries, scalar_type *data, double scale_factor);
 
+    /*!
+     * \ingroup heffteoneapi
+     * \brief Pointwise product of complex data, y = scale_factor * x * y or the conjugate of x is used.
+     */
+    template<typename precision_type, typename index>
+    void multiply_data(sycl::queue &stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                       bool conjugate, double scale_factor);
+
     /*!
      * \ingroup heffteoneapi
      * \brief Performs a direct-pack operation for data sitting on the GPU device.
@@ -732,6 +740,14 @@ namespace data_scaling {
     static void apply(sycl::queue &stream, index num_entries, std::complex<precision_type> *data, double scale_factor){
         apply<precision_type>(stream, 2*num_entries, reinterpret_cast<precision_type*>(data), scale_factor);
     }
+    /*!
+     * \brief Pointwise product of complex data, see the cpu variant.
+     */
+    template<typename precision_type, typename index>
+    static void multiply(sycl::queue &stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                         bool conjugate, double scale_factor){
+        oapi::multiply_data(stream, static_cast<long long>(num_entries), x, y, conjugate, scale_factor);
+    }
 };
 
 /*!
@@ -85,6 +85,14 @@ namespace rocm {
     template<typename scalar_type, typename index>
     void scale_data(hipStream_t stream, index num_entries, scalar_type *data, double scale_factor);
 
+    /*!
+     * \ingroup heffterocm
+     * \brief Pointwise product of complex data, y = scale_factor * x * y or the conjugate of x is used.
+     */
+    template<typename precision_type, typename index>
+    void multiply_data(hipStream_t stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                       bool conjugate, double scale_factor);
+
     /*!
      * \ingroup heffterocm
      * \brief Performs a direct-pack operation for data sitting on the GPU device.
@@ -979,6 +987,15 @@ namespace data_scaling {
     static void apply(hipStream_t stream, index num_entries, std::complex<precision_type> *data, double scale_factor){
         apply<precision_type>(stream, 2*num_entries, reinterpret_cast<precision_type*>(data), scale_factor);
     }
+    /*!
+     * \ingroup heffterocm
+     * \brief Pointwise product of complex data, see the cpu variant.
+     */
+    template<typename precision_type, typename index>
+    static void multiply(hipStream_t stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                         bool conjugate, double scale_factor){
+        rocm::multiply_data<precision_type, long long>(stream, static_cast<long long>(num_entries), x, y, conjugate, scale_factor);
+    }
 };
 
 /*!
@@ -138,13 +138,15 @@ struct plan_stock_fft{
     constexpr static int L = pack_size<F>::size;
     std::unique_ptr<stock::biFuncNode<F,L>[]> root;
     //! \brief Execute C2R FFT
-    void execute(std::complex<F> const idata[], F odata[]) {
+    void execute(std::complex<F> const idata[], F odata[]) { execute(idata, odata, num_ffts); }
+    //! \brief Overload that executes \b howmany transforms, e.g., to cover a batch of boxes stored back-to-back.
+    void execute(std::complex<F> const idata[], F odata[], int howmany) {
         // Allocate input and output temporary arrays
         stock::complex_vector<F,L> inp (N);
         stock::complex_vector<F,L> out (N);
 
         // Perform batch transform on everything save for the remainder
-        for(int p = 0; p+((L/2)-1) < num_ffts; p += (L/2)) {
+        for(int p = 0; p+((L/2)-1) < howmany; p += (L/2)) {
             // Convert types
             inp[0] = stock::Complex<F,L> (&idata[p*comp_d], comp_d);
             for(int i = 1; i < (N+2)/2; i++) {
@@ -163,10 +165,10 @@ struct plan_stock_fft{
         }
 
         // Handle remainder
-        if(num_ffts % (L/2) > 0) {
-            int rem = num_ffts % (L/2);
+        if(howmany % (L/2) > 0) {
+            int rem = howmany % (L/2);
             // Init p for ease of use
-            int p = num_ffts - rem;
+            int p = howmany - rem;
             inp[0] = copy_pad<F,L>(&idata[p*comp_d], rem, comp_d);
             for(int i = 1; i < (N+2)/2; i++) {
                 int idx = p*comp_d + i*stride_sz;
@@ -185,13 +187,15 @@ struct plan_stock_fft{
         }
     }
     //! \brief Execute R2C FFT
-    void execute(F const idata[], std::complex<F> odata[]) {
+    void execute(F const idata[], std::complex<F> odata[]) { execute(idata, odata, num_ffts); }
+    //! \brief Overload that executes \b howmany transforms, e.g., to cover a batch of boxes stored back-to-back.
+    void execute(F const idata[], std::complex<F> odata[], int howmany) {
         // Allocate input and output temporary arrays
         stock::complex_vector<F,L> inp (N);
         stock::complex_vector<F,L> out (N);
 
         // Perform batch transform on everything save for the remainder
-        for(int p = 0; p+((L/2)-1) < num_ffts; p += L/2) {
+        for(int p = 0; p+((L/2)-1) < howmany; p += L/2) {
             // Convert types
             for(int i = 0; i < N; i++) {
                 int idx = p*real_d + i*stride_sz;
@@ -208,10 +212,10 @@ struct plan_stock_fft{
         }
 
         // Handle remainder
-        if(num_ffts % (L/2) > 0) {
-            int rem = num_ffts % (L/2);
+        if(howmany % (L/2) > 0) {
+            int rem = howmany % (L/2);
             // Init p for ease of use
-            int p = num_ffts - rem;
+            int p = howmany - rem;
             for(int i = 0; i < N; i++) {
                 int idx = p*real_d + i*stride_sz;
                 // remainder columns are all zeros
@@ -257,13 +261,15 @@ struct plan_stock_fft<std::complex<F>, dir>{
     constexpr static int L = pack_size<F>::size;
     std::unique_ptr<stock::biFuncNode<F, L>[]> root;
     //! \brief Execute an FFT inplace on std::complex<F> data
-    void execute(std::complex<F> data[]) {
+    void execute(std::complex<F> data[]) { execute(data, num_ffts); }
+    //! \brief Overload that executes \b howmany transforms, e.g., to cover a batch of boxes stored back-to-back.
+    void execute(std::complex<F> data[], int howmany) {
         // Allocate input and output temporary arrays
         stock::complex_vector<F,L> inp (N);
         stock::complex_vector<F,L> out (N);
 
         // Perform batch transform on everything save for the remainder
-        for(int p = 0; p + (L/2 - 1) < num_ffts; p += L/2) {
+        for(int p = 0; p + (L/2 - 1) < howmany; p += L/2) {
             // Convert types
             for(int i = 0; i < N; i++) {
                 int idx = p*idist + i*stride_sz;
@@ -280,10 +286,10 @@ struct plan_stock_fft<std::complex<F>, dir>{
         }
 
         // Handle remainder
-        if(num_ffts % (L/2) > 0) {
-            int rem = num_ffts % (L/2);
+        if(howmany % (L/2) > 0) {
+            int rem = howmany % (L/2);
             // Init p for ease of use
-            int p = num_ffts - rem;
+            int p = howmany - rem;
             for(int i = 0; i < N; i++) {
                 int idx = p*idist + i*stride_sz;
                 // remainder columns are all zeros
@@ -331,13 +337,15 @@ struct plan_stock_fft{
     int N, num_ffts, stride_sz, real_d, comp_d, numNodes;
     std::unique_ptr<stock::biFuncNode<F, 1>[]> root;
     //! \brief Execute C2R FFT
-    void execute(std::complex<F> const idata[], F odata[]) {
+    void execute(std::complex<F> const idata[], F odata[]) { execute(idata, odata, num_ffts); }
+    //! \brief Overload that executes \b howmany transforms, e.g., to cover a batch of boxes stored back-to-back.
+    void execute(std::complex<F> const idata[], F odata[], int howmany) {
         // Allocate input and output temporary arrays
         stock::complex_vector<F,1> inp (N);
         stock::complex_vector<F,1> out (N);
 
         // Perform batch transform on everything save for the remainder
-        for(int p = 0; p < num_ffts; p++) {
+        for(int p = 0; p < howmany; p++) {
             // Convert types
             inp[0] = stock::Complex<F,1> {idata[p*comp_d]};
             for(int i = 1; i < (N+2)/2; i++) {
@@ -356,13 +364,15 @@ struct plan_stock_fft{
         }
     }
     //! \brief Execute R2C FFT
-    void execute(F const idata[], std::complex<F> odata[]) {
+    void execute(F const idata[], std::complex<F> odata[]) { execute(idata, odata, num_ffts); }
+    //! \brief Overload that executes \b howmany transforms, e.g., to cover a batch of boxes stored back-to-back.
+    void execute(F const idata[], std::complex<F> odata[], int howmany) {
         // Allocate input and output temporary arrays
         stock::complex_vector<F,1> inp (N);
         stock::complex_vector<F,1> out (N);
 
         // Perform batch transform on everything save for the remainder
-        for(int p = 0; p < num_ffts; p++) {
+        for(int p = 0; p < howmany; p++) {
             // Convert types
             for(int i = 0; i < N; i++) {
                 int idx = p*real_d + i*stride_sz;
@@ -406,13 +416,15 @@ struct plan_stock_fft<std::complex<F>, dir>{
     int N, num_ffts, stride_sz, idist, odist, numNodes;
     std::unique_ptr<stock::biFuncNode<F,1>[]> root;
     //! \brief Execute an FFT inplace on std::complex<F> data
-    void execute(std::complex<F> data[]) {
+    void execute(std::complex<F> data[]) { execute(data, num_ffts); }
+    //! \brief Overload that executes \b howmany transforms, e.g., to cover a batch of boxes stored back-to-back.
+    void execute(std::complex<F> data[], int howmany) {
         // Allocate input and output temporary arrays
         stock::complex_vector<F,1> inp (N);
         stock::complex_vector<F,1> out (N);
 
         // Perform batch transform on everything save for the remainder
-        for(int p = 0; p < num_ffts; p++) {
+        for(int p = 0; p < howmany; p++) {
             // Convert types
             for(int i = 0; i < N; i++) {
                 int idx = p*idist + i*stride_sz;
@@ -431,6 +443,35 @@ struct plan_stock_fft<std::complex<F>, dir>{
 };
 #endif // Heffte_ENABLE_AVX512
 
+/*!
+ * \ingroup hefftestock
+ * \brief Runs \b num_units groups of \b howmany 1-D transforms of the given \b size, splitting the groups across the threads.
+ *
+ * The stock plans hold internal workspace, hence each thread uses a separate plan created with \b make_plan.
+ * If there are fewer groups than threads, the transforms of each group are split into chunks,
+ * the chunks are multiples of 8 transforms so that the vectorized lanes are always filled.
+ * The \b run method is called with the plan, the index of the group, the first transform and the number of transforms.
+ */
+template<typename plan_type, typename plan_factory, typename callable>
+void stock_execute_threaded(std::vector<std::unique_ptr<plan_type>> &plans, plan_factory const &make_plan,
+                            int size, int num_units, int howmany, callable const &run){
+    long long const num_entries = static_cast<long long>(num_units) * howmany * size;
+    int const threads = pack_kernels::num_threads(num_entries);
+    while(static_cast<int>(plans.size()) < threads) plans.push_back(make_plan());
+
+    int chunk = howmany;
+    if (num_units < threads){
+        int const parts = (threads + num_units - 1) / num_units;
+        chunk = 8 * (((howmany + parts - 1) / parts + 7) / 8);
+    }
+    int const chunks_per_unit = (howmany + chunk - 1) / chunk;
+    pack_kernels::parallel_for(static_cast<long long>(num_units) * chunks_per_unit, num_entries, [&](long long w)->void{
+        int const unit  = static_cast<int>(w / chunks_per_unit);
+        int const first = static_cast<int>(w % chunks_per_unit) * chunk;
+        run(*plans[(threads > 1) ? pack_kernels::thread_id() : 0], unit, first, std::min(chunk, howmany - first));
+    });
+}
+
 /*!
  * \ingroup hefftestock
  * \brief Wrapper around the Stock FFT API.
@@ -472,53 +513,41 @@ public:
     }
 
     //! \brief Forward fft, float-complex case.
-    void forward(std::complex<float> data[], std::complex<float>*) const override{
-        make_plan(cforward);
-        for(int i=0; i<blocks; i++) {
-            cforward->execute(data + i * block_stride);
-        }
-    }
+    void forward(std::complex<float> data[], std::complex<float>*) const override{ execute_batch(cforward, 1, data); }
     //! \brief Backward fft, float-complex case.
-    void backward(std::complex<float> data[], std::complex<float>*) const override{
-        make_plan(cbackward);
-        for(int i=0; i<blocks; i++) {
-            cbackward->execute(data + i * block_stride);
-        }
-    }
+    void backward(std::complex<float> data[], std::complex<float>*) const override{ execute_batch(cbackward, 1, data); }
     //! \brief Forward fft, double-complex case.
-    void forward(std::complex<double> data[], std::complex<double>*) const override{
-        make_plan(zforward);
-        for(int i=0; i<blocks; i++) {
-            zforward->execute(data + i * block_stride);
-        }
-    }
+    void forward(std::complex<double> data[], std::complex<double>*) const override{ execute_batch(zforward, 1, data); }
     //! \brief Backward fft, double-complex case.
-    void backward(std::complex<double> data[], std::complex<double>*) const override{
-        make_plan(zbackward);
-        for(int i=0; i<blocks; i++) {
-            zbackward->execute(data + i * block_stride);
-        }
-    }
+    void backward(std::complex<double> data[], std::complex<double>*) const override{ execute_batch(zbackward, 1, data); }
+    //! \brief Forward fft on a batch of boxes, float-complex case.
+    void forward(int batch_size, std::complex<float> data[], std::complex<float>*) const override{ execute_batch(cforward, batch_size, data); }
+    //! \brief Backward fft on a batch of boxes, float-complex case.
+    void backward(int batch_size, std::complex<float> data[], std::complex<float>*) const override{ execute_batch(cbackward, batch_size, data); }
+    //! \brief Forward fft on a batch of boxes, double-complex case.
+    void forward(int batch_size, std::complex<double> data[], std::complex<double>*) const override{ execute_batch(zforward, batch_size, data); }
+    //! \brief Backward fft on a batch of boxes, double-complex case.
+    void backward(int batch_size, std::complex<double> data[], std::complex<double>*) const override{ execute_batch(zbackward, batch_size, data); }
 
     //! \brief Converts the real data to complex and performs float-complex forward transform.
     void forward(float const indata[], std::complex<float> outdata[], std::complex<float> *workspace) const override{
-        for(int i=0; i<total_size; i++) outdata[i] = std::complex<float>(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::complex<float>(indata[i]); });
         forward(outdata, workspace);
     }
     //! \brief Performs backward float-complex transform and truncates the complex part of the result.
     void backward(std::complex<float> indata[], float outdata[], std::complex<float> *workspace) const override{
         backward(indata, workspace);
-        for(int i=0; i<total_size; i++) outdata[i] = std::real(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::real(indata[i]); });
     }
     //! \brief Converts the real data to complex and performs double-complex forward transform.
     void forward(double const indata[], std::complex<double> outdata[], std::complex<double> *workspace) const override{
-        for(int i=0; i<total_size; i++) outdata[i] = std::complex<double>(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::complex<double>(indata[i]); });
         forward(outdata, workspace);
     }
     //! \brief Performs backward double-complex transform and truncates the complex part of the result.
     void backward(std::complex<double> indata[], double outdata[], std::complex<double> *workspace) const override{
         backward(indata, workspace);
-        for(int i=0; i<total_size; i++) outdata[i] = std::real(indata[i]);
+        pack_kernels::parallel_for(total_size, total_size, [&](long long i)->void{ outdata[i] = std::real(indata[i]); });
     }
 
     //! \brief Returns the size of the box.
@@ -528,17 +557,37 @@ public:
     size_t workspace_size() const override{ return 0; }
 
 private:
-    //! \brief Helper template to create the plan.
+    /*!
+     * \brief Helper template to execute the plans on a batch of boxes.
+     *
+     * If the sequences of consecutive boxes line up with the same distance, i.e., the transforms run along the fast dimension,
+     * the whole batch is a single long sequence and the vectorized lanes are filled across the boxes of the batch.
+     * The work is split across the threads, see stock_execute_threaded().
+     */
     template<typename scalar_type, direction dir>
-    void make_plan(std::unique_ptr<plan_stock_fft<scalar_type, dir>> &plan) const{
-        if (!plan) plan = std::unique_ptr<plan_stock_fft<scalar_type, dir>>(new plan_stock_fft<scalar_type, dir>(size, num_ffts, stride, dist));
+    void execute_batch(std::vector<std::unique_ptr<plan_stock_fft<scalar_type, dir>>> &plans, int batch_size, scalar_type data[]) const{
+        auto make_plan = [&]()->std::unique_ptr<plan_stock_fft<scalar_type, dir>>{
+            return std::unique_ptr<plan_stock_fft<scalar_type, dir>>(new plan_stock_fft<scalar_type, dir>(size, num_ffts, stride, dist));
+        };
+        if (blocks == 1 and num_ffts * dist == total_size){
+            stock_execute_threaded(plans, make_plan, size, 1, batch_size * num_ffts,
+                [&](plan_stock_fft<scalar_type, dir> &plan, int, int first, int count)->void{
+                    plan.execute(data + static_cast<long long>(first) * dist, count);
+                });
+        }else{
+            stock_execute_threaded(plans, make_plan, size, batch_size * blocks, num_ffts,
+                [&](plan_stock_fft<scalar_type, dir> &plan, int unit, int first, int count)->void{
+                    plan.execute(data + static_cast<long long>(unit / blocks) * total_size + (unit % blocks) * block_stride
+                                 + static_cast<long long>(first) * dist, count);
+                });
+        }
     }
 
     int size, num_ffts, stride, dist, blocks, block_stride, total_size;
-    mutable std::unique_ptr<plan_stock_fft<std::complex<float>, direction::forward>> cforward;
-    mutable std::unique_ptr<plan_stock_fft<std::complex<float>, direction::backward>> cbackward;
-    mutable std::unique_ptr<plan_stock_fft<std::complex<double>, direction::forward>> zforward;
-    mutable std::unique_ptr<plan_stock_fft<std::complex<double>, direction::backward>> zbackward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<std::complex<float>, direction::forward>>> cforward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<std::complex<float>, direction::backward>>> cbackward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<std::complex<double>, direction::forward>>> zforward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<std::complex<double>, direction::backward>>> zbackward;
 };
 
 /*!
@@ -576,31 +625,35 @@ public:
 
     //! \brief Forward transform, single precision.
     void forward(float const indata[], std::complex<float> outdata[], std::complex<float>*) const override{
-        make_plan(sforward);
-        for(int i=0; i<blocks; i++) {
-            sforward->execute(indata + i*rblock_stride, outdata + i*cblock_stride);
-        }
+        execute_batch(sforward, 1, indata, outdata);
     }
     //! \brief Backward transform, single precision.
     void backward(std::complex<float> indata[], float outdata[], std::complex<float>*) const override{
-        make_plan(sbackward);
-        for(int i=0; i<blocks; i++) {
-            sbackward->execute(indata + i*cblock_stride, outdata + i*rblock_stride);
-        }
+        execute_batch(sbackward, 1, indata, outdata);
     }
     //! \brief Forward transform, double precision.
     void forward(double const indata[], std::complex<double> outdata[], std::complex<double>*) const override{
-        make_plan(dforward);
-        for(int i=0; i<blocks; i++) {
-            dforward->execute(indata + i*rblock_stride, outdata + i*cblock_stride);
-        }
+        execute_batch(dforward, 1, indata, outdata);
     }
     //! \brief Backward transform, double precision.
     void backward(std::complex<double> indata[], double outdata[], std::complex<double>*) const override{
-        make_plan(dbackward);
-        for(int i=0; i<blocks; i++) {
-            dbackward->execute(indata + i*cblock_stride, outdata + i*rblock_stride);
-        }
+        execute_batch(dbackward, 1, indata, outdata);
+    }
+    //! \brief Forward transform on a batch of boxes, single precision.
+    void forward(int batch_size, float const indata[], std::complex<float> outdata[], std::complex<float>*) const override{
+        execute_batch(sforward, batch_size, indata, outdata);
+    }
+    //! \brief Backward transform on a batch of boxes, single precision.
+    void backward(int batch_size, std::complex<float> indata[], float outdata[], std::complex<float>*) const override{
+        execute_batch(sbackward, batch_size, indata, outdata);
+    }
+    //! \brief Forward transform on a batch of boxes, double precision.
+    void forward(int batch_size, double const indata[], std::complex<double> outdata[], std::complex<double>*) const override{
+        execute_batch(dforward, batch_size, indata, outdata);
+    }
+    //! \brief Backward transform on a batch of boxes, double precision.
+    void backward(int batch_size, std::complex<double> indata[], double outdata[], std::complex<double>*) const override{
+        execute_batch(dbackward, batch_size, indata, outdata);
     }
 
     //! \brief Returns the size of the box with real data.
@@ -611,18 +664,39 @@ public:
     size_t workspace_size() const override{ return 0; }
 
 private:
-    //! \brief Helper template to initialize the plan.
-    template<typename scalar_type, direction dir>
-    void make_plan(std::unique_ptr<plan_stock_fft<scalar_type, dir>> &plan) const{
-        if (!plan) plan = std::unique_ptr<plan_stock_fft<scalar_type, dir>>(new plan_stock_fft<scalar_type, dir>(size, num_ffts, stride, rdist, cdist));
+    //! \brief Helper template to execute the plans on a batch of boxes, see stock_fft_executor::execute_batch().
+    template<typename scalar_type, direction dir, typename input_type, typename output_type>
+    void execute_batch(std::vector<std::unique_ptr<plan_stock_fft<scalar_type, dir>>> &plans, int batch_size, input_type indata[], output_type outdata[]) const{
+        auto make_plan = [&]()->std::unique_ptr<plan_stock_fft<scalar_type, dir>>{
+            return std::unique_ptr<plan_stock_fft<scalar_type, dir>>(new plan_stock_fft<scalar_type, dir>(size, num_ffts, stride, rdist, cdist));
+        };
+        int const in_size  = (dir == direction::forward) ? rsize : csize;
+        int const out_size = (dir == direction::forward) ? csize : rsize;
+        int const in_block  = (dir == direction::forward) ? rblock_stride : cblock_stride;
+        int const out_block = (dir == direction::forward) ? cblock_stride : rblock_stride;
+        int const in_dist  = (dir == direction::forward) ? rdist : cdist;
+        int const out_dist = (dir == direction::forward) ? cdist : rdist;
+        if (blocks == 1 and num_ffts * rdist == rsize and num_ffts * cdist == csize){
+            stock_execute_threaded(plans, make_plan, size, 1, batch_size * num_ffts,
+                [&](plan_stock_fft<scalar_type, dir> &plan, int, int first, int count)->void{
+                    plan.execute(indata + static_cast<long long>(first) * in_dist, outdata + static_cast<long long>(first) * out_dist, count);
+                });
+        }else{
+            stock_execute_threaded(plans, make_plan, size, batch_size * blocks, num_ffts,
+                [&](plan_stock_fft<scalar_type, dir> &plan, int unit, int first, int count)->void{
+                    long long const j = unit / blocks, i = unit % blocks;
+                    plan.execute(indata + j * in_size + i * in_block + static_cast<long long>(first) * in_dist,
+                                 outdata + j * out_size + i * out_block + static_cast<long long>(first) * out_dist, count);
+                });
+        }
     }
 
     int size, num_ffts, stride, blocks;
     int rdist, cdist, rblock_stride, cblock_stride, rsize, csize;
-    mutable std::unique_ptr<plan_stock_fft<float, direction::forward>> sforward;
-    mutable std::unique_ptr<plan_stock_fft<double, direction::forward>> dforward;
-    mutable std::unique_ptr<plan_stock_fft<float, direction::backward>> sbackward;
-    mutable std::unique_ptr<plan_stock_fft<double, direction::backward>> dbackward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<float, direction::forward>>> sforward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<double, direction::forward>>> dforward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<float, direction::backward>>> sbackward;
+    mutable std::vector<std::unique_ptr<plan_stock_fft<double, direction::backward>>> dbackward;
 };
 /*!
  * \ingroup hefftestock
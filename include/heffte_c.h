@@ -255,4 +255,83 @@ void heffte_backward_z2d_buffered(heffte_plan const plan, void const *input, dou
  */
 void heffte_backward_z2z_buffered(heffte_plan const plan, void const *input, void *output, void *workspace, int scale);
 
+/*!
+ * \ingroup cfft
+ * \brief Wrapper around heffte::fft3d::forward_async() and heffte::fft3d_r2c::forward_async().
+ *
+ * Starts a forward transform that has to be completed with heffte_request_test() or heffte_request_wait(),
+ * the input, output and workspace cannot be used until the request is complete.
+ * \param plan is an already created heffte_plan
+ * \param input has size at least heffte_size_inbox() of real-single precision numbers
+ * \param output has size at least heffte_size_outbox() will be overwritten with the output
+ * \param workspace is either NULL or has size at least heffte_size_workspace() of complex-single precision numbers,
+ *                  if set to NULL, the workspace will be allocated internally
+ * \param scale is Heffte_SCALE_NONE, Heffte_SCALE_FULL or Heffte_SCALE_SYMMETRIC,
+ *              see heffte::scale for details
+ * \param request will be overwritten with a new request
+ *
+ * The method has four variants corresponding to the variants of heffte_forward_s2c_buffered():
+ * heffte_forward_s2c_async(), heffte_forward_c2c_async(), heffte_forward_d2z_async() and heffte_forward_z2z_async().
+ */
+void heffte_forward_s2c_async(heffte_plan const plan, float const *input, void *output, void *workspace, int scale, heffte_request *request);
+/*!
+ * \ingroup cfft
+ * \brief Forward transform, asynchronous, single precision, complex to complex, see heffte_forward_s2c_async()
+ */
+void heffte_forward_c2c_async(heffte_plan const plan, void const *input, void *output, void *workspace, int scale, heffte_request *request);
+/*!
+ * \ingroup cfft
+ * \brief Forward transform, asynchronous, double precision, real to complex, see heffte_forward_s2c_async()
+ */
+void heffte_forward_d2z_async(heffte_plan const plan, double const *input, void *output, void *workspace, int scale, heffte_request *request);
+/*!
+ * \ingroup cfft
+ * \brief Forward transform, asynchronous, double precision, complex to complex, see heffte_forward_s2c_async()
+ */
+void heffte_forward_z2z_async(heffte_plan const plan, void const *input, void *output, void *workspace, int scale, heffte_request *request);
+
+/*!
+ * \ingroup cfft
+ * \brief Wrapper around heffte::fft3d::backward_async() and heffte::fft3d_r2c::backward_async().
+ *
+ * Starts a backward transform, otherwise identical to heffte_forward_s2c_async().
+ * The method has four variants corresponding to the variants of heffte_backward_c2s_buffered():
+ * heffte_backward_c2s_async(), heffte_backward_c2c_async(), heffte_backward_z2d_async() and heffte_backward_z2z_async().
+ */
+void heffte_backward_c2s_async(heffte_plan const plan, void const *input, float *output, void *workspace, int scale, heffte_request *request);
+/*!
+ * \ingroup cfft
+ * \brief Backward transform, asynchronous, single precision, complex to complex, see heffte_backward_c2s_async()
+ */
+void heffte_backward_c2c_async(heffte_plan const plan, void const *input, void *output, void *workspace, int scale, heffte_request *request);
+/*!
+ * \ingroup cfft
+ * \brief Backward transform, asynchronous, double precision, complex to real, see heffte_backward_c2s_async()
+ */
+void heffte_backward_z2d_async(heffte_plan const plan, void const *input, double *output, void *workspace, int scale, heffte_request *request);
+/*!
+ * \ingroup cfft
+ * \brief Backward transform, asynchronous, double precision, complex to complex, see heffte_backward_c2s_async()
+ */
+void heffte_backward_z2z_async(heffte_plan const plan, void const *input, void *output, void *workspace, int scale, heffte_request *request);
+
+/*!
+ * \ingroup cfft
+ * \brief Wrapper around heffte::fft_request::test().
+ *
+ * \param request is a request created by one of the asynchronous transforms,
+ *                if the transform is complete, the request will be destroyed and set to NULL
+ *
+ * \returns 1 if the transform is complete (or the request is NULL), 0 otherwise
+ */
+int heffte_request_test(heffte_request *request);
+
+/*!
+ * \ingroup cfft
+ * \brief Wrapper around heffte::fft_request::wait(), completes the transform and destroys the request.
+ *
+ * \param request is a request created by one of the asynchronous transforms, it will be set to NULL on exit
+ */
+void heffte_request_wait(heffte_request *request);
+
 #endif /* HEFFTE_C_H */
@@ -36,6 +36,12 @@
  *
  * The buffered versions of the methods accept an extra parameter that is a user allocated workspace.
  *
+ * Asynchronous transforms, see heffte::fft_request, are started with variants of:
+ * - heffte_forward_s2c_async()
+ * - heffte_backward_c2s_async()
+ *
+ * and completed with heffte_request_test() or heffte_request_wait().
+ *
  * Complex arrays are accepted as void-pointers which removes type safety but works around the issues with multiple complex types.
  * The methods use different suffixes to indicate the input/output types using standard BLAS naming conventions:
  * - \b s for single precision real
@@ -145,6 +151,15 @@ typedef struct{
  */
 typedef heffte_fft_plan* heffte_plan;
 
+/*!
+ * \ingroup cfft
+ * \brief C-style wrapper around an instance of heffte::fft_request.
+ *
+ * Created by the asynchronous transforms, e.g., heffte_forward_s2c_async(),
+ * and destroyed by heffte_request_wait() or a successful call to heffte_request_test().
+ */
+typedef void* heffte_request;
+
 /*!
  * \ingroup cfft
  * \brief Indicate no scaling, see heffte::scale::none
@@ -0,0 +1,223 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+*/
+
+#ifndef HEFFTE_CALLBACKS_H
+#define HEFFTE_CALLBACKS_H
+
+#include "heffte_reshape3d.h"
+
+/*!
+ * \ingroup fft3d
+ * \addtogroup hefftecallbacks Pointwise callbacks
+ *
+ * Element-wise operations that are applied to the input of a transform as it is loaded
+ * and to the output as it is stored, e.g., windowing of the input or filtering of the spectrum.
+ * The callbacks are called with the global indexes of each entry and are fused into the first
+ * and last reshape of the transform, i.e., the callback is applied to each block of data
+ * right after the block has been unpacked and is still in cache.
+ * Thus, a callback can replace a separate pass over the input or the output arrays,
+ * see heffte::fft3d::forward() and heffte::fft3d::backward() for the overloads that accept callbacks.
+ *
+ * The callbacks are supported only for backends that work with data on the CPU.
+ */
+
+namespace heffte {
+
+/*!
+ * \ingroup hefftecallbacks
+ * \brief Element-wise operation applied to the entries of a transform, indexed by the global indexes.
+ *
+ * The callback can be constructed from any functor with signature equivalent to:
+ * \code
+ *  void callback(index i, index j, index k, scalar_type &value);
+ * \endcode
+ * where i, j, k are the global indexes of the entry in the first, second and third dimension
+ * and the value can be modified in-place.
+ * The functor is wrapped into an operation that works on an entire line of entries,
+ * which avoids the overhead of the type-erasure for each entry.
+ * The functor can be called concurrently from multiple threads, but never for the same entry.
+ * In the batched case, the same callback is applied to each transform in the batch.
+ *
+ * Example:
+ * \code
+ *  heffte::transform_callbacks<std::complex<double>> callbacks;
+ *  callbacks.store = [&](int i, int j, int k, std::complex<double> &value)->void{
+ *      value *= filter(i, j, k);
+ *  };
+ *  fft.forward(input.data(), output.data(), callbacks);
+ * \endcode
+ */
+template<typename scalar_type, typename index = int>
+class pointwise_callback{
+public:
+    //! \brief Applies the callback to \b count entries of a \b line, the first entry has global indexes \b first and the line goes along \b dimension.
+    using line_operation = std::function<void(std::array<index, 3> const &first, int dimension, index count, scalar_type line[])>;
+
+    //! \brief Empty callback, does nothing.
+    pointwise_callback() = default;
+    //! \brief Wraps the functor (i, j, k, value) into a callback.
+    template<typename functor_type,
+             typename = typename std::enable_if<not std::is_same<typename std::decay<functor_type>::type, pointwise_callback>::value>::type>
+    pointwise_callback(functor_type functor) :
+        operation([functor](std::array<index, 3> const &first, int dimension, index count, scalar_type line[])->void{
+            std::array<index, 3> idx = first;
+            for(index t=0; t<count; t++){
+                idx[dimension] = first[dimension] + t;
+                functor(idx[0], idx[1], idx[2], line[t]);
+            }
+        })
+    {}
+
+    //! \brief Returns true if the callback has been set.
+    explicit operator bool() const{ return static_cast<bool>(operation); }
+
+    //! \brief Applies the callback to \b count entries of the \b line, the first entry has global indexes \b first and the line goes along \b dimension.
+    void operator()(std::array<index, 3> const &first, int dimension, index count, scalar_type line[]) const{
+        operation(first, dimension, count, line);
+    }
+
+private:
+    //! \brief The wrapped functor.
+    line_operation operation;
+};
+
+/*!
+ * \ingroup hefftecallbacks
+ * \brief The pair of callbacks applied to the input of a transform as it is loaded and to the output as it is stored.
+ *
+ * Either callback can be empty, the load callback is applied to the input of the transform
+ * (e.g., the inbox data for the forward transform) and the store callback is applied to the output
+ * (e.g., the outbox data for the forward transform) before any scaling.
+ * The type of the load callback must match the input of the transform and the store callback
+ * must match the output, e.g., real and complex for the forward real-to-complex transform.
+ */
+template<typename load_type, typename store_type = load_type, typename index = int>
+struct transform_callbacks{
+    //! \brief Called for each entry of the input.
+    pointwise_callback<load_type, index> load;
+    //! \brief Called for each entry of the output.
+    pointwise_callback<store_type, index> store;
+};
+
+/*!
+ * \internal
+ * \ingroup hefftecallbacks
+ * \brief Reshape that applies a callback and a scaling factor to the data as it is unpacked into the destination box.
+ *
+ * If the \b reshape is set, the callback and the scaling are fused into the unpack stage of the reshape,
+ * otherwise the data is copied into the destination (if the source is different) and the callback and scaling
+ * are applied to each line after the copy.
+ * The reshape operation works only with the scalar type of the callback and only with data on the CPU.
+ * \endinternal
+ */
+template<typename scalar_type, typename index>
+class reshape3d_callback : public reshape3d_base<index>{
+public:
+    //! \brief Constructor, the \b reshape can be nullptr and the \b box is the destination box of this rank, the callback can be empty.
+    reshape3d_callback(reshape3d_base<index> const *creshape, box3d<index> const cbox, pointwise_callback<scalar_type, index> const &ccallback,
+                       double cscale_factor = 1.0) :
+        reshape3d_base<index>((creshape == nullptr) ? cbox.count() : creshape->size_intput(),
+                              (creshape == nullptr) ? cbox.count() : creshape->size_output()),
+        reshape(creshape), box(cbox), callback(ccallback), scale_factor(cscale_factor)
+    {}
+
+    //! \brief Apply the reshape operations, single precision overload.
+    void apply(int batch_size, float const source[], float destination[], float workspace[]) const override final{
+        apply_callback(batch_size, source, destination, workspace);
+    }
+    //! \brief Apply the reshape operations, double precision overload.
+    void apply(int batch_size, double const source[], double destination[], double workspace[]) const override final{
+        apply_callback(batch_size, source, destination, workspace);
+    }
+    //! \brief Apply the reshape operations, single precision complex overload.
+    void apply(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[]) const override final{
+        apply_callback(batch_size, source, destination, workspace);
+    }
+    //! \brief Apply the reshape operations, double precision complex overload.
+    void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[]) const override final{
+        apply_callback(batch_size, source, destination, workspace);
+    }
+    //! \brief Nesting of callbacks is not supported, single precision overload.
+    void apply(int, float const[], float[], float[], unpack_hook<float, index> const&) const override final{ unsupported(); }
+    //! \brief Nesting of callbacks is not supported, double precision overload.
+    void apply(int, double const[], double[], double[], unpack_hook<double, index> const&) const override final{ unsupported(); }
+    //! \brief Nesting of callbacks is not supported, single precision complex overload.
+    void apply(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[],
+               unpack_hook<std::complex<float>, index> const&) const override final{ unsupported(); }
+    //! \brief Nesting of callbacks is not supported, double precision complex overload.
+    void apply(int, std::complex<double> const[], std::complex<double>[], std::complex<double>[],
+               unpack_hook<std::complex<double>, index> const&) const override final{ unsupported(); }
+
+    //! \brief The workspace of the wrapped reshape, if any.
+    size_t size_workspace() const override{ return (reshape == nullptr) ? 0 : reshape->size_workspace(); }
+
+private:
+    //! \brief Applies the reshape followed by the callback and the scaling.
+    void apply_callback(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const{
+        if (reshape != nullptr){
+            reshape->apply(batch_size, source, destination, workspace,
+                           [&](scalar_type block[], pack_plan_3d<index> const &plan)->void{
+                                process_block(destination, block, plan, nullptr);
+                           });
+        }else{
+            add_trace name((source == destination) ? "callback" : "copy-callback");
+            pack_plan_3d<index> const plan = {{box.osize(0), box.osize(1), box.osize(2)}, box.osize(0), box.osize(0) * box.osize(1),
+                                              0, 0, {0, 1, 2}};
+            for(int j=0; j<batch_size; j++)
+                process_block(destination, destination + j * this->output_size, plan,
+                              (source == destination) ? nullptr : source);
+        }
+    }
+    //! \brief The callback is tied to a single type, the other types cannot be used.
+    template<typename other_type>
+    void apply_callback(int, other_type const[], other_type[], other_type[]) const{ unsupported(); }
+
+    /*!
+     * \brief Applies the callback and the scaling to a block of the destination array.
+     *
+     * The \b block is the first entry of the block in the \b destination and the \b plan holds the sizes and strides of the block,
+     * the global indexes are recovered from the offset of the block within the box.
+     * If \b source is not nullptr, then the entries are first copied from the source, line-by-line,
+     * where the source and destination have the same layout.
+     */
+    void process_block(scalar_type const destination[], scalar_type block[], pack_plan_3d<index> const &plan, scalar_type const source[]) const{
+        long long const offset = static_cast<long long>(block - destination) % static_cast<long long>(box.count());
+        index const fast = static_cast<index>(offset % box.osize(0));
+        index const mid  = static_cast<index>((offset / box.osize(0)) % box.osize(1));
+        index const slow = static_cast<index>(offset / (static_cast<long long>(box.osize(0)) * box.osize(1)));
+
+        std::array<index, 3> first;
+        for(index s=0; s<plan.size[2]; s++){
+            for(index m=0; m<plan.size[1]; m++){
+                scalar_type *line = block + static_cast<long long>(s) * plan.plane_stride + static_cast<long long>(m) * plan.line_stride;
+                if (source != nullptr)
+                    std::copy_n(source + (line - destination), plan.size[0], line);
+                if (callback){
+                    first[box.order[0]] = box.low[box.order[0]] + fast;
+                    first[box.order[1]] = box.low[box.order[1]] + mid + m;
+                    first[box.order[2]] = box.low[box.order[2]] + slow + s;
+                    callback(first, box.order[0], plan.size[0], line);
+                }
+                if (scale_factor != 1.0)
+                    data_scaling::apply(nullptr, plan.size[0], line, scale_factor);
+            }
+        }
+    }
+
+    //! \brief Throws an exception indicating an invalid use of the class.
+    [[noreturn]] void unsupported() const{
+        throw std::runtime_error("heffte internal error: invalid use of reshape3d_callback");
+    }
+
+    reshape3d_base<index> const *reshape;
+    box3d<index> const box;
+    pointwise_callback<scalar_type, index> const &callback;
+    double const scale_factor;
+};
+
+}
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "heffte_geometry.h"
 #include "heffte_trace.h"
+#include "heffte_threads.h"
 
 namespace heffte {
 
@@ -68,12 +69,17 @@ namespace backend {
         //! \brief Wrapper around std::copy_n().
         template<typename source_type, typename destination_type>
         static void copy_n(void*, source_type const source[], size_t num_entries, destination_type destination[]){
-            std::copy_n(source, num_entries, destination);
+            copy_n(source, num_entries, destination);
         }
-        //! \brief Wrapper around std::copy_n().
+        //! \brief Wrapper around std::copy_n(), large arrays are split into one chunk per thread.
         template<typename source_type, typename destination_type>
         static void copy_n(source_type const source[], size_t num_entries, destination_type destination[]){
-            std::copy_n(source, num_entries, destination);
+            long long const total = static_cast<long long>(num_entries);
+            long long const num_chunks = pack_kernels::num_threads(total);
+            pack_kernels::parallel_for(num_chunks, total, [&](long long c)->void{
+                long long const first = total * c / num_chunks;
+                std::copy_n(source + first, total * (c + 1) / num_chunks - first, destination + first);
+            });
         }
         //! \brief Wrapper around std::copy_n().
         template<typename source_type, typename destination_type>
@@ -586,6 +592,60 @@ public:
     virtual void backward(std::complex<float>[], float[], std::complex<float>*) const{}
     //! \brief Backward FFT real-to-complex, double precision.
     virtual void backward(std::complex<double>[], double[], std::complex<double>*) const{}
+
+    /*
+     * Batched overloads, the boxes of the batch are stored back-to-back in memory with box_size() or complex_size() entries per box.
+     * The default implementation loops over the batch, backends that can plan many transforms at once override the methods.
+     */
+    //! \brief Forward r2r on a batch of boxes, single precision.
+    virtual void forward(int batch_size, float data[], float *workspace) const{
+        for(int j=0; j<batch_size; j++) forward(data + j * box_size(), workspace);
+    }
+    //! \brief Forward r2r on a batch of boxes, double precision.
+    virtual void forward(int batch_size, double data[], double *workspace) const{
+        for(int j=0; j<batch_size; j++) forward(data + j * box_size(), workspace);
+    }
+    //! \brief Backward r2r on a batch of boxes, single precision.
+    virtual void backward(int batch_size, float data[], float *workspace) const{
+        for(int j=0; j<batch_size; j++) backward(data + j * box_size(), workspace);
+    }
+    //! \brief Backward r2r on a batch of boxes, double precision.
+    virtual void backward(int batch_size, double data[], double *workspace) const{
+        for(int j=0; j<batch_size; j++) backward(data + j * box_size(), workspace);
+    }
+    //! \brief Forward FFT on a batch of boxes, single precision.
+    virtual void forward(int batch_size, std::complex<float> data[], std::complex<float> *workspace) const{
+        for(int j=0; j<batch_size; j++) forward(data + j * box_size(), workspace);
+    }
+    //! \brief Forward FFT on a batch of boxes, double precision.
+    virtual void forward(int batch_size, std::complex<double> data[], std::complex<double> *workspace) const{
+        for(int j=0; j<batch_size; j++) forward(data + j * box_size(), workspace);
+    }
+    //! \brief Backward FFT on a batch of boxes, single precision.
+    virtual void backward(int batch_size, std::complex<float> data[], std::complex<float> *workspace) const{
+        for(int j=0; j<batch_size; j++) backward(data + j * box_size(), workspace);
+    }
+    //! \brief Backward FFT on a batch of boxes, double precision.
+    virtual void backward(int batch_size, std::complex<double> data[], std::complex<double> *workspace) const{
+        for(int j=0; j<batch_size; j++) backward(data + j * box_size(), workspace);
+    }
+    //! \brief Forward FFT real-to-complex on a batch of boxes, single precision.
+    virtual void forward(int batch_size, float const indata[], std::complex<float> outdata[], std::complex<float> *workspace) const{
+        for(int j=0; j<batch_size; j++) forward(indata + j * box_size(), outdata + j * complex_size(), workspace);
+    }
+    //! \brief Forward FFT real-to-complex on a batch of boxes, double precision.
+    virtual void forward(int batch_size, double const indata[], std::complex<double> outdata[], std::complex<double> *workspace) const{
+        for(int j=0; j<batch_size; j++) forward(indata + j * box_size(), outdata + j * complex_size(), workspace);
+    }
+    //! \brief Backward FFT complex-to-real on a batch of boxes, single precision.
+    virtual void backward(int batch_size, std::complex<float> indata[], float outdata[], std::complex<float> *workspace) const{
+        for(int j=0; j<batch_size; j++) backward(indata + j * complex_size(), outdata + j * box_size(), workspace);
+    }
+    //! \brief Backward FFT complex-to-real on a batch of boxes, double precision.
+    virtual void backward(int batch_size, std::complex<double> indata[], double outdata[], std::complex<double> *workspace) const{
+        for(int j=0; j<batch_size; j++) backward(indata + j * complex_size(), outdata + j * box_size(), workspace);
+    }
+
     //! \brief Return the size of the box.
     virtual int box_size() const{ return 0; }
     //! \brief Return the workspace of the size.
@@ -594,6 +654,24 @@ public:
     virtual int complex_size() const{ return box_size(); }
 };
 
+/*!
+ * \ingroup fft3dbackend
+ * \brief Executor for the transforms of size one, e.g., the third direction of a two dimensional problem.
+ *
+ * The transform of size one does not change the data, the executor performs no work
+ * but reports the size of the box so that the buffers of the transform are sized correctly.
+ */
+class identity_executor : public executor_base{
+public:
+    //! \brief Constructor, takes the box of the stage.
+    template<typename index>
+    identity_executor(box3d<index> const box) : total_size(static_cast<int>(box.count())){}
+    //! \brief Returns the size of the box.
+    int box_size() const override{ return total_size; }
+private:
+    int const total_size;
+};
+
 /*!
  * \ingroup fft3dbackend
  * \brief cuFFT requires that the input and output in R2C transforms are aligned to the complex type.
@@ -11,6 +11,96 @@
 
 namespace heffte {
 
+    /*!
+     * \internal
+     * \ingroup fft3d
+     * \brief A single stage of a transform, either a reshape or a set of 1-D transforms (or a copy).
+     *
+     * Stages that perform a reshape will start the communication and record the state in the reshape_pending struct,
+     * all other stages ignore the struct and complete all work on exit.
+     * \endinternal
+     */
+    using transform_stage = std::function<void(reshape_pending &pending)>;
+
+    /*!
+     * \internal
+     * \ingroup fft3d
+     * \brief The ordered list of stages that define a transform, see compute_transform().
+     * \endinternal
+     */
+    using transform_schedule = std::vector<transform_stage>;
+
+    /*!
+     * \ingroup fft3d
+     * \brief Handle to a transform started with one of the asynchronous methods, e.g., heffte::fft3d::forward_async().
+     *
+     * The request holds the stages of the transform, i.e., the reshape and 1-D FFT operations,
+     * and moves through the stages every time the communication of the current reshape completes.
+     * The communication uses non-blocking MPI calls, e.g., MPI_Ialltoallv(), and the request
+     * is progressed by calls to test() or wait(), or by a helper thread, see progress_in_background().
+     * The work between two reshapes (unpacking, 1-D transforms, packing) is performed
+     * by the thread that made the call to test() or wait(), or by the helper thread.
+     *
+     * The input, output and workspace buffers and the fft3d object used to create the request
+     * must remain valid until the request is complete and, similar to the non-blocking MPI calls,
+     * the buffers should not be accessed while the request is in progress.
+     * Only one transform can be in progress on the same workspace buffer and the same MPI communicator,
+     * which means that each fft3d object should have at most one request in progress at a time.
+     * The destructor will block until the transform is complete.
+     *
+     * Example:
+     * \code
+     *  auto request = fft.forward_async(input.data(), output.data());
+     *  // ... other work that does not touch input or output ...
+     *  while(not request.test()){
+     *      // ... more work ...
+     *  }
+     *  // the output is ready
+     * \endcode
+     *
+     * The reshape algorithms based on reshape_algorithm::alltoallv and reshape_algorithm::alltoall
+     * use non-blocking collectives, the point-to-point algorithms are completed at the time they are started.
+     */
+    class fft_request{
+    public:
+        //! \brief Creates an empty request, which is always complete.
+        fft_request();
+        /*!
+         * \brief Creates a request that will run the given stages and starts the first one, primarily for internal use.
+         *
+         * The stages use \b num_threads OpenMP threads regardless of the thread that progresses the request,
+         * see heffte::plan_options::num_threads.
+         */
+        fft_request(transform_schedule &&stages, std::shared_ptr<void> workspace_owner = std::shared_ptr<void>(), int num_threads = 0);
+        //! \brief Move constructor.
+        fft_request(fft_request &&other);
+        //! \brief Move assignment, completes the current transform first.
+        fft_request& operator = (fft_request &&other);
+        //! \brief Blocks until the transform is complete.
+        ~fft_request();
+
+        //! \brief Makes progress on the transform and returns true if the transform is complete, never blocks.
+        bool test();
+        //! \brief Blocks until the transform is complete.
+        void wait();
+        /*!
+         * \brief Launches a helper thread that makes progress on the transform.
+         *
+         * The helper thread calls MPI methods concurrently with the main thread, which requires
+         * MPI_THREAD_MULTIPLE support from the MPI implementation, see MPI_Init_thread().
+         * After this call, test() will only check whether the helper has completed the transform.
+         *
+         * \throws std::runtime_error if MPI has not been initialized with MPI_THREAD_MULTIPLE
+         */
+        void progress_in_background();
+
+    private:
+        //! \brief Holds the stages and the state of the transform.
+        struct progress_state;
+        //! \brief Heap allocated state, can be shared with the helper thread.
+        std::unique_ptr<progress_state> state;
+    };
+
     /*!
      * \internal
      * \ingroup fft3d
@@ -43,6 +133,13 @@ namespace heffte {
      * \param shaper are the four stages of the reshape operations
      * \param executor holds the three stages of the one dimensional FFT algorithm
      * \param dir indicates whether to use the forward or backward method of the executor
+     * \param schedule if set to nullptr, the transform is performed immediately,
+     *                 otherwise, the stages of the transform are appended to the schedule and the
+     *                 pointers to the input, output and workspace must remain valid until the stages are executed
+     * \param swap_buffer if not nullptr, the low-memory mode is used (see plan_options::use_low_memory)
+     *                    and the reshapes are never applied in-place, instead the data alternates between
+     *                    the internal temp buffer and the swap buffer; the swap buffer must have the same size
+     *                    as the temp buffer and can be the same as the output (but not the input, unless the input is the output)
      * \endinternal
      */
     template<typename location_tag, typename index, typename scalar_type>
@@ -50,9 +147,9 @@ namespace heffte {
                         int const batch_size,
                         scalar_type const input[], scalar_type output[], scalar_type workspace[],
                         size_t executor_buffer_offset, size_t size_comm_buffers,
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper,
+                        std::array<reshape3d_base<index>*, 4> const &shaper,
                         std::array<executor_base*, 3> const &executor,
-                        direction dir);
+                        direction dir, transform_schedule *schedule = nullptr, scalar_type swap_buffer[] = nullptr);
     /*!
      * \internal
      * \ingroup fft3d
@@ -75,8 +172,9 @@ namespace heffte {
                         scalar_type const input[], std::complex<scalar_type> output[],
                         std::complex<scalar_type> workspace[],
                         size_t executor_buffer_offset, size_t size_comm_buffers,
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper,
-                        std::array<executor_base*, 3> const &executor, direction);
+                        std::array<reshape3d_base<index>*, 4> const &shaper,
+                        std::array<executor_base*, 3> const &executor, direction,
+                        transform_schedule *schedule = nullptr, std::complex<scalar_type> swap_buffer[] = nullptr);
     /*!
      * \internal
      * \ingroup fft3d
@@ -90,7 +188,7 @@ namespace heffte {
      *                             std::complex<scalar_type> *workspace);
      * \endcode
      *
-     * The \b direction parameter is ignored.
+     * The \b direction parameter is ignored and the \b swap_buffer cannot be the same as the real output.
      * \endinternal
      */
     template<typename location_tag, typename index, typename scalar_type>
@@ -99,8 +197,9 @@ namespace heffte {
                         std::complex<scalar_type> const input[], scalar_type output[],
                         std::complex<scalar_type> workspace[],
                         size_t executor_buffer_offset, size_t size_comm_buffers,
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper,
-                        std::array<executor_base*, 3> const &executor, direction);
+                        std::array<reshape3d_base<index>*, 4> const &shaper,
+                        std::array<executor_base*, 3> const &executor, direction,
+                        transform_schedule *schedule = nullptr, std::complex<scalar_type> swap_buffer[] = nullptr);
 
 }
 
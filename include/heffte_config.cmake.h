@@ -16,6 +16,8 @@
 #cmakedefine Heffte_ENABLE_AVX
 #cmakedefine Heffte_ENABLE_AVX512
 
+#cmakedefine Heffte_ENABLE_OPENMP
+
 #cmakedefine Heffte_ENABLE_FFTW
 #cmakedefine Heffte_ENABLE_MKL
 #cmakedefine Heffte_ENABLE_CUDA
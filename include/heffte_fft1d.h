@@ -0,0 +1,317 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+*/
+
+#ifndef HEFFTE_FFT1D_H
+#define HEFFTE_FFT1D_H
+
+#include "heffte_fft3d.h"
+
+namespace heffte {
+
+/*!
+ * \ingroup fft3d
+ * \brief Defines the layout of the output of the distributed heffte::fft1d transform.
+ */
+enum class output_order{
+    //! \brief The output is in the natural order, each rank holds a contiguous range of the frequencies.
+    natural,
+    //! \brief The output is in the transposed order of the six-step algorithm, which skips the final reshape.
+    transposed
+};
+
+/*!
+ * \ingroup fft3d
+ * \brief One dimensional discrete Fourier transform of a very long signal distributed across an MPI communicator.
+ *
+ * \par Overview
+ * The transform uses the six-step algorithm, the signal of size N = N1 * N2 is viewed as a two dimensional
+ * N1 by N2 matrix where the input index is n = n1 + N1 * n2 and the output index is k = k2 + N2 * k1.
+ * The transform consists of N1 transforms of size N2, multiplication by the twiddle factors exp(-2 pi i n1 k2 / N),
+ * and N2 transforms of size N1, where the data is moved between the ranks with the same reshape operations
+ * used by heffte::fft3d. The twiddle factors are applied while the data is unpacked by the reshape
+ * between the two sets of 1-D transforms, i.e., without a separate pass over the data.
+ *
+ * \par Data Distribution
+ * The data is always distributed in contiguous blocks of the 1-D signal:
+ * - the input of the forward transform on each rank covers the entries N1 * inbox().low[1] to N1 * (inbox().high[1] + 1) - 1
+ * - in the heffte::output_order::natural order, the output covers the frequencies N2 * outbox().low[0]
+ *   to N2 * (outbox().high[0] + 1) - 1
+ * - in the heffte::output_order::transposed order, the output on each rank holds the k1 index in the fast dimension
+ *   and a block of k2 in the slow dimension, which saves one reshape; the backward transform accepts the same layout
+ *
+ * The global index of each local entry can be computed with input_index() and output_index().
+ * The boxes are two dimensional and describe the N1 by N2 matrix, where the first index is n1 or k1
+ * and the second is n2 or k2.
+ *
+ * \par Restrictions
+ * The transform is complex-to-complex and works only with backends that use the CPU.
+ * Both N1 and N2 must be at least as large as the number of ranks, and plan_options::use_low_memory
+ * and plan_options::use_reorder are ignored since the layout is set by the algorithm.
+ *
+ * Example:
+ * \code
+ *  heffte::fft1d<heffte::backend::fftw> fft(1LL << 34, comm);
+ *  std::vector<std::complex<double>> x(fft.size_inbox()), y(fft.size_outbox());
+ *  // x[i] holds the entry with global index fft.input_index(i)
+ *  fft.forward(x.data(), y.data());
+ * \endcode
+ */
+template<typename backend_tag, typename index = int>
+class fft1d : public backend::device_instance<typename backend::buffer_traits<backend_tag>::location>{
+public:
+    //! \brief Type-tag that is either tag::cpu or tag::gpu to indicate the location of the data.
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+
+    /*!
+     * \brief Constructor creating a plan for the transform of the given size, the size is factored with default_factors().
+     *
+     * \param size is the total number of entries of the signal
+     * \param comm is the MPI communicator with all ranks that will participate in the FFT
+     * \param options is a set of options that define the reshape algorithm, see heffte::plan_options
+     * \param order indicates the layout of the output of the forward transform
+     */
+    fft1d(long long size, MPI_Comm const comm, plan_options const options = default_options<backend_tag>(),
+          output_order order = output_order::natural) :
+        fft1d(default_factors(size, mpi::comm_size(comm)), comm, options, order)
+    {}
+    /*!
+     * \brief Constructor using the given factors N1 and N2 of the signal size, the two factors must be at least the number of ranks.
+     */
+    fft1d(std::array<index, 2> const factors, MPI_Comm const comm, plan_options const options = default_options<backend_tag>(),
+          output_order order = output_order::natural) :
+        world({0, 0, 0}, {factors[0] - 1, factors[1] - 1, 0}), transposed(order == output_order::transposed),
+        scale_factor(1.0 / static_cast<double>(world.count())), num_threads(options.num_threads)
+    {
+        static_assert(backend::is_enabled<backend_tag>::value, "The requested backend is invalid or has not been enabled.");
+        static_assert(backend::uses_fft_types<backend_tag>::value, "The fft1d class requires a backend that computes the Fourier transform.");
+        static_assert(std::is_same<location_tag, tag::cpu>::value, "The fft1d class works only with backends that use the CPU.");
+
+        int const num_ranks = mpi::comm_size(comm);
+        int const me = mpi::comm_rank(comm);
+        if (factors[0] < num_ranks or factors[1] < num_ranks)
+            throw std::invalid_argument("heffte::fft1d requires that both factors of the size are at least the number of MPI ranks");
+
+        plan_options reshape_options = set_options<backend_tag>(options);
+        reshape_options.use_low_memory = false; // the reshape between the two sets of 1-D transforms is done in-place
+
+        // blocks of n2 (or k2) with n1 in the fast dimension, e.g., the input
+        std::vector<box3d<index>> const rows = split_world(world, {1, num_ranks, 1});
+        // blocks of n1 (or k1) with n2 in the fast dimension, e.g., the natural order output
+        std::vector<box3d<index>> const columns = reorder(split_world(world, {num_ranks, 1, 1}), {1, 0, 2});
+
+        pinbox    = std::unique_ptr<box3d<index>>(new box3d<index>(rows[me]));
+        poutbox   = std::unique_ptr<box3d<index>>(new box3d<index>((transposed) ? rows[me] : columns[me]));
+        pcolumns  = std::unique_ptr<box3d<index>>(new box3d<index>(columns[me]));
+        prows     = std::unique_ptr<box3d<index>>(new box3d<index>(rows[me]));
+
+        // forward: rows -> columns, fft n2, twiddle + columns -> rows, fft n1, rows -> columns (natural order only)
+        forward_shaper[0] = make_reshape3d<backend_tag>(this->stream(), rows, columns, comm, reshape_options);
+        forward_shaper[1] = make_reshape3d<backend_tag>(this->stream(), columns, rows, comm, reshape_options);
+        if (not transposed)
+            forward_shaper[3] = make_reshape3d<backend_tag>(this->stream(), rows, columns, comm, reshape_options);
+        // backward: columns -> rows (natural order only), ifft k1, rows -> columns + twiddle, ifft k2, columns -> rows
+        if (not transposed)
+            backward_shaper[0] = make_reshape3d<backend_tag>(this->stream(), columns, rows, comm, reshape_options);
+        backward_shaper[1] = make_reshape3d<backend_tag>(this->stream(), rows, columns, comm, reshape_options);
+        backward_shaper[3] = make_reshape3d<backend_tag>(this->stream(), columns, rows, comm, reshape_options);
+
+        column_executor = make_executor<backend_tag>(this->stream(), columns[me], 1);
+        row_executor    = make_executor<backend_tag>(this->stream(), rows[me], 0);
+
+        std::array<executor_base*, 3> const all_executors = {column_executor.get(), row_executor.get(), nullptr};
+        size_t const executor_workspace_size = get_max_work_size(all_executors);
+        comm_buffer_offset = std::max(get_workspace_size(forward_shaper), get_workspace_size(backward_shaper));
+        size_buffer_work = comm_buffer_offset + get_max_box_size(all_executors) + executor_workspace_size;
+        executor_buffer_offset = (executor_workspace_size == 0) ? 0 : size_buffer_work - executor_workspace_size;
+
+        // exp(-2 pi i m / N) = high[m / block] * low[m % block], where block is a power of 2 close to sqrt(N)
+        long long const num_entries = world.count();
+        twiddle_shift = 0;
+        while((1LL << (2 * twiddle_shift)) < num_entries) twiddle_shift++;
+        long long const block = 1LL << twiddle_shift;
+        double const theta = -2.0 * 3.14159265358979323846 / static_cast<double>(num_entries);
+        twiddle_low.resize(block);
+        for(long long m=0; m<block; m++)
+            twiddle_low[m] = std::polar(1.0, theta * static_cast<double>(m));
+        twiddle_high.resize((num_entries + block - 1) / block);
+        for(size_t m=0; m<twiddle_high.size(); m++)
+            twiddle_high[m] = std::polar(1.0, theta * static_cast<double>(static_cast<long long>(m) * block));
+    }
+
+    /*!
+     * \brief Returns the factors N1 and N2 used by default for a signal of the given size and number of ranks.
+     *
+     * N1 is the largest divisor of the size that does not exceed the square root of the size,
+     * where both N1 and N2 = size / N1 must be at least the number of ranks.
+     *
+     * \throws std::invalid_argument if the size cannot be factored into two large enough factors, e.g., if the size is prime
+     */
+    static std::array<index, 2> default_factors(long long size, int num_ranks){
+        long long n1 = static_cast<long long>(std::sqrt(static_cast<double>(size)));
+        while(n1 * n1 > size) n1--;
+        while((n1 + 1) * (n1 + 1) <= size) n1++;
+        while(n1 >= num_ranks and size % n1 != 0) n1--;
+        if (n1 < num_ranks or n1 < 1 or size / n1 > static_cast<long long>(std::numeric_limits<index>::max()))
+            throw std::invalid_argument("heffte::fft1d cannot factor the size " + std::to_string(size)
+                                        + " into two factors that are at least the number of ranks " + std::to_string(num_ranks));
+        return {static_cast<index>(n1), static_cast<index>(size / n1)};
+    }
+
+    //! \brief Returns the total size of the signal.
+    long long size() const{ return world.count(); }
+    //! \brief Returns the two factors of the size, N1 and N2.
+    std::array<index, 2> factors() const{ return {world.size[0], world.size[1]}; }
+    //! \brief Returns the number of entries of the input on this rank.
+    long long size_inbox() const{ return pinbox->count(); }
+    //! \brief Returns the number of entries of the output on this rank.
+    long long size_outbox() const{ return poutbox->count(); }
+    //! \brief Returns the input box in terms of the N1 by N2 matrix (n1, n2).
+    box3d<index> inbox() const{ return *pinbox; }
+    //! \brief Returns the output box in terms of the N1 by N2 matrix (k1, k2), the order of the box indicates the layout.
+    box3d<index> outbox() const{ return *poutbox; }
+    //! \brief Returns the global index n of the i-th local entry of the input.
+    long long input_index(long long i) const{
+        return static_cast<long long>(pinbox->low[1]) * world.size[0] + i;
+    }
+    //! \brief Returns the global frequency k of the i-th local entry of the output.
+    long long output_index(long long i) const{
+        if (transposed){
+            long long const k1 = i % world.size[0];
+            long long const k2 = poutbox->low[1] + i / world.size[0];
+            return k2 + static_cast<long long>(world.size[1]) * k1;
+        }else{
+            return static_cast<long long>(poutbox->low[0]) * world.size[1] + i;
+        }
+    }
+    //! \brief Returns the workspace size that will be used, size is measured in complex numbers.
+    size_t size_workspace() const{ return size_buffer_work; }
+
+    /*!
+     * \brief Performs the forward transform, the input and output follow the layout of inbox() and outbox().
+     *
+     * \tparam scalar_type is a complex type, e.g., std::complex<double>, see heffte::fft3d
+     *
+     * \param input is an array of size at least size_inbox()
+     * \param output is an array of size at least size_outbox(), can be the same as the input
+     * \param workspace is an array of size at least size_workspace()
+     * \param scaling defines the type of scaling to apply (default no-scaling)
+     */
+    template<typename scalar_type>
+    void forward(scalar_type const input[], scalar_type output[], scalar_type workspace[], scale scaling = scale::none) const{
+        forward(1, input, output, workspace, scaling);
+    }
+    //! \brief Overload that allocates the workspace internally.
+    template<typename scalar_type>
+    void forward(scalar_type const input[], scalar_type output[], scale scaling = scale::none) const{
+        std::vector<scalar_type> workspace(size_workspace());
+        forward(1, input, output, workspace.data(), scaling);
+    }
+    //! \brief Batch overload, the workspace must have size batch_size * size_workspace().
+    template<typename scalar_type>
+    void forward(int const batch_size, scalar_type const input[], scalar_type output[], scalar_type workspace[],
+                 scale scaling = scale::none) const{
+        static_assert(is_ccomplex<scalar_type>::value or is_zcomplex<scalar_type>::value,
+                      "The fft1d class works only with complex types.");
+        compute(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                direction::forward, scaling);
+    }
+
+    /*!
+     * \brief Performs the backward transform, the input and output follow the layout of outbox() and inbox().
+     */
+    template<typename scalar_type>
+    void backward(scalar_type const input[], scalar_type output[], scalar_type workspace[], scale scaling = scale::none) const{
+        backward(1, input, output, workspace, scaling);
+    }
+    //! \brief Overload that allocates the workspace internally.
+    template<typename scalar_type>
+    void backward(scalar_type const input[], scalar_type output[], scale scaling = scale::none) const{
+        std::vector<scalar_type> workspace(size_workspace());
+        backward(1, input, output, workspace.data(), scaling);
+    }
+    //! \brief Batch overload, the workspace must have size batch_size * size_workspace().
+    template<typename scalar_type>
+    void backward(int const batch_size, scalar_type const input[], scalar_type output[], scalar_type workspace[],
+                  scale scaling = scale::none) const{
+        static_assert(is_ccomplex<scalar_type>::value or is_zcomplex<scalar_type>::value,
+                      "The fft1d class works only with complex types.");
+        compute(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                direction::backward, scaling);
+    }
+
+    //! \brief Returns the scale factor for the given scaling.
+    double get_scale_factor(scale scaling) const{
+        return (scaling == scale::symmetric) ? std::sqrt(scale_factor) : scale_factor;
+    }
+
+private:
+    /*!
+     * \brief Runs the reshapes and the 1-D transforms.
+     *
+     * The twiddle factors are fused into the middle reshape and the scaling into the last one,
+     * if the last reshape is skipped, the scaling is applied in a separate pass.
+     */
+    template<typename scalar_type>
+    void compute(int const batch_size, scalar_type const input[], scalar_type output[], scalar_type workspace[],
+                 direction dir, scale scaling) const{
+        thread_scope threads(num_threads);
+        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper = (dir == direction::forward) ? forward_shaper : backward_shaper;
+        std::array<reshape3d_base<index>*, 4> shapers = {shaper[0].get(), shaper[1].get(), nullptr, shaper[3].get()};
+        std::array<executor_base*, 3> const executors = (dir == direction::forward) ?
+                                        std::array<executor_base*, 3>{column_executor.get(), row_executor.get(), nullptr} :
+                                        std::array<executor_base*, 3>{row_executor.get(), column_executor.get(), nullptr};
+
+        using precision = typename define_standard_type<scalar_type>::type::value_type;
+        bool const conjugate = (dir == direction::backward);
+        int const shift = twiddle_shift;
+        long long const mask = (1LL << twiddle_shift) - 1;
+        std::complex<double> const *high = twiddle_high.data();
+        std::complex<double> const *low  = twiddle_low.data();
+        pointwise_callback<scalar_type, index> const twiddle(
+            [=](index n1, index k2, index, scalar_type &value)->void{
+                long long const m = static_cast<long long>(n1) * static_cast<long long>(k2);
+                std::complex<double> const w = high[m >> shift] * low[m & mask];
+                value *= scalar_type(static_cast<precision>(w.real()), static_cast<precision>((conjugate) ? -w.imag() : w.imag()));
+            });
+        reshape3d_callback<scalar_type, index> twiddle_shaper(shapers[1], (dir == direction::forward) ? *prows : *pcolumns, twiddle);
+        shapers[1] = &twiddle_shaper;
+
+        pointwise_callback<scalar_type, index> const no_callback; // the scaling is fused into the last reshape without a callback
+        std::unique_ptr<reshape3d_base<index>> store_shaper;
+        if (shapers[3] != nullptr and scaling != scale::none){
+            store_shaper = std::unique_ptr<reshape3d_base<index>>(
+                new reshape3d_callback<scalar_type, index>(shapers[3], (dir == direction::forward) ? *poutbox : *pinbox,
+                                                           no_callback, get_scale_factor(scaling)));
+            shapers[3] = store_shaper.get();
+        }
+
+        compute_transform<location_tag, index>(this->stream(), batch_size, input, output, workspace,
+                                               executor_buffer_offset, comm_buffer_offset, shapers, executors, dir);
+
+        if (not store_shaper and scaling != scale::none){
+            add_trace name("scale");
+            data_scaling::apply(this->stream(), batch_size * ((dir == direction::forward) ? size_outbox() : size_inbox()),
+                                output, get_scale_factor(scaling));
+        }
+    }
+
+    box3d<index> const world;
+    bool const transposed;
+    double const scale_factor;
+    int const num_threads;
+    std::unique_ptr<box3d<index>> pinbox, poutbox, pcolumns, prows;
+    std::array<std::unique_ptr<reshape3d_base<index>>, 4> forward_shaper, backward_shaper;
+    std::unique_ptr<executor_base> column_executor, row_executor;
+
+    size_t size_buffer_work, comm_buffer_offset, executor_buffer_offset;
+
+    int twiddle_shift;
+    std::vector<std::complex<double>> twiddle_high, twiddle_low;
+};
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 #define HEFFTE_FFT3D_H
 
 #include "heffte_compute_transform.h"
+#include "heffte_callbacks.h"
 
 /*!
  * \defgroup fft3d Fast Fourier Transform
@@ -146,6 +147,118 @@ enum class scale{
     symmetric
 };
 
+/*!
+ * \ingroup fft3d
+ * \brief Times a forward and backward transform for each candidate set of options and returns the fastest.
+ *
+ * \tparam fft_type is either heffte::fft3d or heffte::fft3d_r2c
+ * \tparam input_type is the input type for the forward transform used in the timing
+ * \tparam output_type is the output type for the forward transform used in the timing
+ * \tparam plan_maker is a callable that accepts heffte::plan_options and returns an instance of fft_type
+ *
+ * \param comm is the communicator used by the plans
+ * \param candidates is the list of options to compare, use_autotune and grid_search must be disabled
+ * \param make_plan creates a plan from a candidate set of options
+ *
+ * \returns the options used by the fastest plan, where all ranks return the same options
+ *
+ * Each candidate plan is timed with a forward and backward transform using dummy buffers,
+ * the best of three runs is taken on each rank and the maximum time across the ranks
+ * (computed with MPI_Allreduce) is used to compare the candidates.
+ */
+template<typename fft_type, typename input_type, typename output_type, typename plan_maker>
+plan_options measure_options(MPI_Comm const comm, std::vector<plan_options> const &candidates, plan_maker make_plan){
+    int const num_runs = 3;
+
+    plan_options best = candidates.front();
+    double best_time = std::numeric_limits<double>::max();
+
+    for(auto const &candidate : candidates){
+        auto fft = make_plan(candidate);
+        auto input     = make_buffer_container<input_type>(fft.stream(), fft.size_inbox());
+        auto output    = make_buffer_container<output_type>(fft.stream(), fft.size_outbox());
+        auto workspace = make_buffer_container<output_type>(fft.stream(), fft.size_workspace());
+
+        fft.forward(input.data(), output.data(), workspace.data()); // warmup
+        fft.backward(output.data(), input.data(), workspace.data());
+        fft.synchronize_device();
+
+        double local_time = std::numeric_limits<double>::max();
+        for(int i=0; i<num_runs; i++){
+            MPI_Barrier(comm);
+            double t = -MPI_Wtime();
+            fft.forward(input.data(), output.data(), workspace.data());
+            fft.backward(output.data(), input.data(), workspace.data());
+            fft.synchronize_device();
+            t += MPI_Wtime();
+            local_time = std::min(local_time, t);
+        }
+
+        double max_time = 0.0;
+        MPI_Allreduce(&local_time, &max_time, 1, MPI_DOUBLE, MPI_MAX, comm);
+        if (max_time < best_time){
+            best_time = max_time;
+            best = fft.get_options(); // the backend may have adjusted the candidate
+        }
+    }
+
+    return best;
+}
+
+/*!
+ * \ingroup fft3d
+ * \brief Selects the processor grid, the reshape algorithm and the reorder options as requested by the plan_options.
+ *
+ * Used internally by heffte::fft3d and heffte::fft3d_r2c when plan_options::use_autotune is set
+ * or plan_options::grid_search is not grid_selection::heuristic.
+ * The processor grid and the pencil/slab decomposition are selected first, using heffte::rank_proc_grids()
+ * and, for grid_selection::measured, timing the three candidates with the lowest estimated cost.
+ * Then, if use_autotune is set, all combinations of heffte::reshape_algorithm and use_reorder are timed
+ * on the selected grid.
+ *
+ * \param inbox is the input box of this rank
+ * \param outbox is the output box of this rank
+ * \param r2c_direction is the r2c direction or -1 for the c2c case
+ * \param comm is the communicator used by the plans
+ * \param options are the options to tune
+ * \param make_plan creates a plan from a candidate set of options, see heffte::measure_options()
+ *
+ * \returns the selected options with use_autotune and grid_search disabled,
+ *          i.e., the result can be used to create the plan without repeating the tuning
+ */
+template<typename fft_type, typename input_type, typename output_type, typename index, typename plan_maker>
+plan_options autotune_options(box3d<index> const inbox, box3d<index> const outbox, int r2c_direction, MPI_Comm const comm,
+                              plan_options const options, plan_maker make_plan){
+    plan_options result = options;
+    result.use_autotune = false;
+    result.grid_search  = grid_selection::heuristic;
+
+    if (options.grid_search != grid_selection::heuristic){
+        std::vector<plan_options> grids = rank_proc_grids(mpi::gather_boxes(inbox, outbox, comm), r2c_direction, result, comm);
+        if (options.grid_search == grid_selection::measured and grids.size() > 1){
+            if (grids.size() > 3) grids.erase(grids.begin() + 3, grids.end());
+            result = measure_options<fft_type, input_type, output_type>(comm, grids, make_plan);
+        }else{
+            result = grids.front();
+        }
+    }
+
+    if (options.use_autotune){
+        std::vector<plan_options> candidates;
+        for(reshape_algorithm alg : std::array<reshape_algorithm, 4>{reshape_algorithm::alltoallv, reshape_algorithm::alltoall,
+                                                                     reshape_algorithm::p2p_plined, reshape_algorithm::p2p}){
+            for(bool reorder : std::array<bool, 2>{true, false}){
+                candidates.push_back(result);
+                candidates.back().algorithm   = alg;
+                candidates.back().use_reorder = reorder;
+            }
+        }
+        result = measure_options<fft_type, input_type, output_type>(comm, candidates, make_plan);
+    }
+
+    return result;
+}
+
 /*!
  * \ingroup fft3d
  * \brief Defines the plan for a 3-dimensional discrete Fourier transform performed on a MPI distributed data.
@@ -269,7 +382,8 @@ public:
      */
     fft3d(box3d<index> const inbox, box3d<index> const outbox, MPI_Comm const comm,
           plan_options const options = default_options<backend_tag>()) :
-        fft3d(plan_operations(mpi::gather_boxes(inbox, outbox, comm), -1, set_options<backend_tag>(options), mpi::comm_rank(comm)), comm){
+        fft3d(plan_operations(mpi::gather_boxes(inbox, outbox, comm), -1,
+                              set_options<backend_tag>(autotune(nullptr, inbox, outbox, comm, options)), mpi::comm_rank(comm)), comm){
         static_assert(backend::is_enabled<backend_tag>::value, "The requested backend is invalid or has not been enabled.");
     }
     /*!
@@ -292,7 +406,8 @@ public:
     fft3d(typename backend::device_instance<location_tag>::stream_type gpu_stream,
           box3d<index> const inbox, box3d<index> const outbox, MPI_Comm const comm,
           plan_options const options = default_options<backend_tag>()) :
-        fft3d(gpu_stream, plan_operations(mpi::gather_boxes(inbox, outbox, comm), -1, set_options<backend_tag>(options), mpi::comm_rank(comm)), comm){
+        fft3d(gpu_stream, plan_operations(mpi::gather_boxes(inbox, outbox, comm), -1,
+                                          set_options<backend_tag>(autotune(&gpu_stream, inbox, outbox, comm, options)), mpi::comm_rank(comm)), comm){
         static_assert(backend::is_enabled<backend_tag>::value, "The requested backend is invalid or has not been enabled.");
     }
 
@@ -328,6 +443,8 @@ public:
     long long size_outbox() const{ return poutbox->count(); }
     //! \brief Returns the inbox.
     box3d<index> inbox() const{ return *pinbox; }
+    //! \brief Returns the options used to create the plan, e.g., the options selected by plan_options::use_autotune or grid_search.
+    plan_options get_options() const{ return options; }
     //! \brief Returns the outbox.
     box3d<index> outbox() const{ return *poutbox; }
 
@@ -355,7 +472,7 @@ public:
         static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<typename transform_output<typename define_standard_type<output_type>::type, backend_tag>::type>(this->stream(), size_workspace());
+        auto workspace = make_pooled_workspace<typename transform_output<typename define_standard_type<output_type>::type, backend_tag>::type>(pool, this->stream(), size_workspace());
         forward(convert_to_standard(input), convert_to_standard(output), workspace.data(), scaling);
     }
 
@@ -376,11 +493,8 @@ public:
         static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), forward_shaper,
-                                               forward_executors(), direction::forward);
-        apply_scale(1, direction::forward, scaling, convert_to_standard(output));
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::forward, scaling);
     }
     /*!
      * \brief An overload allowing for a batch of FFTs to be performed in a single command.
@@ -394,11 +508,8 @@ public:
         static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), batch_size, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), forward_shaper,
-                                               forward_executors(), direction::forward);
-        apply_scale(batch_size, direction::forward, scaling, convert_to_standard(output));
+        compute_and_scale(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::forward, scaling);
     }
     /*!
      * \brief An overload that allocates workspace internally.
@@ -408,7 +519,7 @@ public:
         static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<typename transform_output<typename define_standard_type<output_type>::type, backend_tag>::type>(this->stream(), batch_size * size_workspace());
+        auto workspace = make_pooled_workspace<typename transform_output<typename define_standard_type<output_type>::type, backend_tag>::type>(pool, this->stream(), batch_size * size_workspace());
 
         forward(batch_size, input, output, workspace.data(), scaling);
     }
@@ -470,7 +581,7 @@ public:
         static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<typename transform_output<input_type, backend_tag>::type>(this->stream(), size_workspace());
+        auto workspace = make_pooled_workspace<typename transform_output<input_type, backend_tag>::type>(pool, this->stream(), size_workspace());
         backward(input, output, workspace.data(), scaling);
     }
 
@@ -482,11 +593,8 @@ public:
         static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), backward_shaper,
-                                               backward_executors(), direction::backward);
-        apply_scale(1, direction::backward, scaling, convert_to_standard(output));
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::backward, scaling);
     }
     /*!
      * \brief Overload for batch transforms, see the corresponding overload of forward().
@@ -497,11 +605,8 @@ public:
         static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), batch_size, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), backward_shaper,
-                                               backward_executors(), direction::backward);
-        apply_scale(batch_size, direction::backward, scaling, convert_to_standard(output));
+        compute_and_scale(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::backward, scaling);
     }
     /*!
      * \brief Overload for batch transforms with internally allocated workspace.
@@ -511,10 +616,155 @@ public:
         static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
                       "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<typename transform_output<input_type, backend_tag>::type>(this->stream(), batch_size * size_workspace());
+        auto workspace = make_pooled_workspace<typename transform_output<input_type, backend_tag>::type>(pool, this->stream(), batch_size * size_workspace());
         backward(batch_size, input, output, workspace.data(), scaling);
     }
 
+    /*!
+     * \brief Forward transform that applies pointwise callbacks to the input and the output, see heffte::pointwise_callback.
+     *
+     * The \b callbacks.load is applied to each entry of the input and \b callbacks.store is applied to each entry
+     * of the output before the scaling. The callbacks are fused into the first and last reshape operations,
+     * i.e., each block of data is processed right after it has been unpacked;
+     * if the corresponding reshape is not needed, the load is fused with the copy into the internal buffers
+     * and the store makes an extra pass over the output.
+     * The callbacks are supported only for backends that work on the CPU.
+     * The other parameters are the same as in the overload of forward() with a workspace.
+     */
+    template<typename input_type, typename output_type>
+    void forward(input_type const input[], output_type output[], output_type workspace[],
+                 transform_callbacks<typename define_standard_type<input_type>::type,
+                                     typename define_standard_type<output_type>::type, index> const &callbacks,
+                 scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        static_assert(std::is_same<location_tag, tag::cpu>::value, "Pointwise callbacks work only with backends that use the CPU.");
+
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::forward, scaling, callbacks);
+    }
+    //! \brief Overload of forward() with callbacks that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void forward(input_type const input[], output_type output[],
+                 transform_callbacks<typename define_standard_type<input_type>::type,
+                                     typename define_standard_type<output_type>::type, index> const &callbacks,
+                 scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<typename transform_output<typename define_standard_type<output_type>::type, backend_tag>::type>(pool, this->stream(), size_workspace());
+        forward(convert_to_standard(input), convert_to_standard(output), workspace.data(), callbacks, scaling);
+    }
+    //! \brief Backward transform with pointwise callbacks, see the forward() overload with callbacks.
+    template<typename input_type, typename output_type>
+    void backward(input_type const input[], output_type output[], input_type workspace[],
+                  transform_callbacks<typename define_standard_type<input_type>::type,
+                                      typename define_standard_type<output_type>::type, index> const &callbacks,
+                  scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        static_assert(std::is_same<location_tag, tag::cpu>::value, "Pointwise callbacks work only with backends that use the CPU.");
+
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::backward, scaling, callbacks);
+    }
+    //! \brief Overload of backward() with callbacks that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void backward(input_type const input[], output_type output[],
+                  transform_callbacks<typename define_standard_type<input_type>::type,
+                                      typename define_standard_type<output_type>::type, index> const &callbacks,
+                  scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<typename transform_output<input_type, backend_tag>::type>(pool, this->stream(), size_workspace());
+        backward(convert_to_standard(input), convert_to_standard(output), workspace.data(), callbacks, scaling);
+    }
+
+    /*!
+     * \brief Starts a forward Fourier transform that will complete asynchronously.
+     *
+     * The inputs are the same as in forward(), but the method returns after the first reshape
+     * operation has been packed and the communication has been started.
+     * The transform is progressed and completed with the methods of the returned heffte::fft_request,
+     * e.g., test() and wait(); the data in the output is not valid until the request is complete.
+     * The workspace is allocated internally and is held by the request.
+     */
+    template<typename input_type, typename output_type>
+    fft_request forward_async(input_type const input[], output_type output[], scale scaling = scale::none) const{
+        return forward_async(1, input, output, scaling);
+    }
+    /*!
+     * \brief Overload with user-provided workspace buffer, see forward_async() and the corresponding overload of forward().
+     */
+    template<typename input_type, typename output_type>
+    fft_request forward_async(input_type const input[], output_type output[], output_type workspace[], scale scaling = scale::none) const{
+        return forward_async(1, input, output, workspace, scaling);
+    }
+    /*!
+     * \brief Overload for batch transforms, see forward_async() and the corresponding overload of forward().
+     */
+    template<typename input_type, typename output_type>
+    fft_request forward_async(int const batch_size, input_type const input[], output_type output[],
+                              output_type workspace[], scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                            std::shared_ptr<void>(), direction::forward, scaling);
+    }
+    /*!
+     * \brief Overload for batch transforms with internally allocated workspace.
+     */
+    template<typename input_type, typename output_type>
+    fft_request forward_async(int const batch_size, input_type const input[], output_type output[], scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        using workspace_type = typename define_standard_type<output_type>::type;
+        auto workspace = std::make_shared<buffer_container<workspace_type>>(
+                            make_buffer_container<workspace_type>(this->stream(), batch_size * size_workspace()));
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), workspace->data(),
+                            workspace, direction::forward, scaling);
+    }
+
+    /*!
+     * \brief Starts a backward Fourier transform that will complete asynchronously, see forward_async().
+     */
+    template<typename input_type, typename output_type>
+    fft_request backward_async(input_type const input[], output_type output[], scale scaling = scale::none) const{
+        return backward_async(1, input, output, scaling);
+    }
+    /*!
+     * \brief Overload with user-provided workspace buffer, see forward_async() and the corresponding overload of backward().
+     */
+    template<typename input_type, typename output_type>
+    fft_request backward_async(input_type const input[], output_type output[], input_type workspace[], scale scaling = scale::none) const{
+        return backward_async(1, input, output, workspace, scaling);
+    }
+    /*!
+     * \brief Overload for batch transforms, see forward_async() and the corresponding overload of backward().
+     */
+    template<typename input_type, typename output_type>
+    fft_request backward_async(int const batch_size, input_type const input[], output_type output[],
+                               input_type workspace[], scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                            std::shared_ptr<void>(), direction::backward, scaling);
+    }
+    /*!
+     * \brief Overload for batch transforms with internally allocated workspace.
+     */
+    template<typename input_type, typename output_type>
+    fft_request backward_async(int const batch_size, input_type const input[], output_type output[], scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        using workspace_type = typename define_standard_type<input_type>::type;
+        auto workspace = std::make_shared<buffer_container<workspace_type>>(
+                            make_buffer_container<workspace_type>(this->stream(), batch_size * size_workspace()));
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), workspace->data(),
+                            workspace, direction::backward, scaling);
+    }
+
     /*!
      * \brief Perform complex-to-complex backward FFT using vector API.
      */
@@ -546,11 +796,170 @@ public:
         return (scaling == scale::symmetric) ? std::sqrt(scale_factor) : scale_factor;
     }
 
-    //! \brief Returns the workspace size that will be used, size is measured in complex numbers.
+    /*!
+     * \brief Returns the workspace size that will be used, size is measured in complex numbers.
+     *
+     * If plan_options::use_low_memory is set, the workspace holds only the largest message sent
+     * and received by a reshape and one buffer for the intermediate stages of the transform,
+     * the output array is used as the second buffer if it is large enough.
+     * In this mode, the backward transform with real output allocates the second buffer internally,
+     * unless the workspace already contains it.
+     */
     size_t size_workspace() const{ return size_buffer_work; }
     //! \brief Returns the size used by the communication workspace buffers (internal use).
     size_t size_comm_buffers() const{ return comm_buffer_offset; }
 
+    /*!
+     * \brief Returns the box of the spectrum, i.e., the layout of the data after the last 1-D transform.
+     *
+     * The spectrum box is the layout used internally by the last stage of the transform,
+     * the outbox is obtained with one more reshape.
+     * See forward_spectrum() and convolve().
+     */
+    box3d<index> spectrum_box() const{ return *pspectrum; }
+    //! \brief Returns the size of the spectrum_box().
+    long long size_spectrum() const{ return pspectrum->count(); }
+    //! \brief Returns the size of the workspace used by convolve() and correlate(), measured in complex numbers.
+    size_t size_convolution_workspace() const{ return size_workspace() + 2 * static_cast<size_t>(size_spectrum()); }
+
+    /*!
+     * \brief Attaches a workspace pool that will be used by the overloads that do not accept a workspace.
+     *
+     * The pool can be shared between multiple plans, see heffte::workspace_pool for details.
+     * Passing a null pointer detaches the pool and the workspace will be allocated on every call.
+     */
+    void set_workspace_pool(std::shared_ptr<workspace_pool<location_tag>> const &new_pool){
+        pool = new_pool;
+        if (not pool) return;
+        pool->register_client(size_convolution_workspace());
+        for(auto &s : forward_shaper) if (s) s->set_staging_buffers(pool->send_buffer(), pool->recv_buffer());
+        for(auto &s : backward_shaper) if (s) s->set_staging_buffers(pool->send_buffer(), pool->recv_buffer());
+    }
+    //! \brief Returns the workspace pool attached to the plan, could be null.
+    std::shared_ptr<workspace_pool<location_tag>> const& get_workspace_pool() const{ return pool; }
+
+    /*!
+     * \brief Creates a plan from a file written by heffte::save_plan(), the file is validated by heffte::load_plan().
+     *
+     * Loading the plan skips the gather of the boxes across the communicator, the analysis of the reshapes
+     * and any tuning requested by the options used to create the saved plan,
+     * the reshapes and the 1-D plans of the backend are still created.
+     */
+    static fft3d<backend_tag, index> load(std::string const &filename, box3d<index> const inbox, box3d<index> const outbox, MPI_Comm const comm){
+        return fft3d<backend_tag, index>(check_loaded(load_plan(filename, inbox, outbox, -1, comm)), comm);
+    }
+    //! \brief Same as the other load() but accepts a GPU stream, see the constructors for the type of the stream.
+    static fft3d<backend_tag, index> load(typename backend::device_instance<location_tag>::stream_type gpu_stream,
+                                          std::string const &filename, box3d<index> const inbox, box3d<index> const outbox, MPI_Comm const comm){
+        return fft3d<backend_tag, index>(gpu_stream, check_loaded(load_plan(filename, inbox, outbox, -1, comm)), comm);
+    }
+
+    /*!
+     * \brief Performs a forward Fourier transform but leaves the result in the spectrum_box().
+     *
+     * Same as forward() but skips the final reshape from the internal layout to the outbox,
+     * the \b spectrum must have size at least size_spectrum().
+     * The method is intended for operations in Fourier space where the layout is not important,
+     * e.g., applying a kernel that depends only on the global indexes of the spectrum_box(),
+     * followed by a call to backward_spectrum().
+     */
+    template<typename input_type, typename output_type>
+    void forward_spectrum(input_type const input[], output_type spectrum[], output_type workspace[], scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, input_type, output_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        thread_scope threads(options.num_threads);
+
+        std::shared_ptr<void> swap_owner;
+        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(input), convert_to_standard(spectrum),
+                                               convert_to_standard(workspace),
+                                               executor_buffer_offset, size_comm_buffers(), forward_shapers(true),
+                                               forward_executors(), direction::forward, nullptr,
+                                               get_swap_buffer(1, convert_to_standard(spectrum), size_spectrum(),
+                                                               convert_to_standard(workspace), swap_owner));
+        apply_scale(size_spectrum(), scaling, convert_to_standard(spectrum));
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void forward_spectrum(input_type const input[], output_type spectrum[], scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<typename transform_output<typename define_standard_type<output_type>::type, backend_tag>::type>(pool, this->stream(), size_workspace());
+        forward_spectrum(convert_to_standard(input), convert_to_standard(spectrum), workspace.data(), scaling);
+    }
+    /*!
+     * \brief Performs a backward Fourier transform starting from the spectrum_box() layout.
+     *
+     * Inverts forward_spectrum(), the \b spectrum must have size at least size_spectrum()
+     * and the \b output corresponds to the inbox.
+     */
+    template<typename input_type, typename output_type>
+    void backward_spectrum(input_type const spectrum[], output_type output[], input_type workspace[], scale scaling = scale::none) const{
+        static_assert(backend::check_types<backend_tag, output_type, input_type>::value,
+                      "Using either an unknown complex type or an incompatible pair of types!");
+
+        thread_scope threads(options.num_threads);
+
+        std::shared_ptr<void> swap_owner;
+        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(spectrum), convert_to_standard(output),
+                                               convert_to_standard(workspace),
+                                               executor_buffer_offset, size_comm_buffers(), backward_shapers(true),
+                                               backward_executors(), direction::backward, nullptr,
+                                               get_swap_buffer(1, convert_to_standard(output), size_inbox(),
+                                                               convert_to_standard(workspace), swap_owner));
+        apply_scale(size_inbox(), scaling, convert_to_standard(output));
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void backward_spectrum(input_type const spectrum[], output_type output[], scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<typename transform_output<input_type, backend_tag>::type>(pool, this->stream(), size_workspace());
+        backward_spectrum(spectrum, output, workspace.data(), scaling);
+    }
+
+    /*!
+     * \brief Computes the circular convolution of \b x and \b y, i.e., IFFT( FFT(x) .* FFT(y) ).
+     *
+     * The inputs \b x and \b y and the \b result correspond to the inbox and the \b result can alias either input.
+     * The product of the spectrums is computed in the spectrum_box() layout, which skips
+     * the two reshapes to and from the outbox needed by the equivalent calls to forward() and backward().
+     * The \b scaling is applied to the backward transform, the default scale::full gives the circular convolution
+     * and the scaling is fused with the product of the spectrums.
+     *
+     * \param x is the first input of size size_inbox()
+     * \param y is the second input of size size_inbox()
+     * \param result is the result of size size_inbox()
+     * \param workspace has size size_convolution_workspace() and holds the two spectrums and the workspace of the transforms
+     * \param scaling is the scaling to apply to the backward transform
+     */
+    template<typename input_type, typename output_type, typename spectrum_type>
+    void convolve(input_type const x[], input_type const y[], output_type result[], spectrum_type workspace[],
+                  scale scaling = scale::full) const{
+        spectral_product(convert_to_standard(x), convert_to_standard(y), convert_to_standard(result),
+                         convert_to_standard(workspace), false, scaling);
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void convolve(input_type const x[], input_type const y[], output_type result[], scale scaling = scale::full) const{
+        auto workspace = make_pooled_workspace<typename transform_output<typename define_standard_type<input_type>::type, backend_tag>::type>(pool, this->stream(), size_convolution_workspace());
+        convolve(x, y, result, workspace.data(), scaling);
+    }
+    /*!
+     * \brief Computes the circular cross-correlation of \b x and \b y, i.e., IFFT( conj(FFT(x)) .* FFT(y) ).
+     *
+     * Identical to convolve() with the conjugate of the spectrum of \b x,
+     * the result at global index k is the sum over n of conj(x[n]) y[n + k].
+     */
+    template<typename input_type, typename output_type, typename spectrum_type>
+    void correlate(input_type const x[], input_type const y[], output_type result[], spectrum_type workspace[],
+                   scale scaling = scale::full) const{
+        spectral_product(convert_to_standard(x), convert_to_standard(y), convert_to_standard(result),
+                         convert_to_standard(workspace), true, scaling);
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void correlate(input_type const x[], input_type const y[], output_type result[], scale scaling = scale::full) const{
+        auto workspace = make_pooled_workspace<typename transform_output<typename define_standard_type<input_type>::type, backend_tag>::type>(pool, this->stream(), size_convolution_workspace());
+        correlate(x, y, result, workspace.data(), scaling);
+    }
+
 private:
     /*!
      * \brief Initialize the class using the provided plan and communicator.
@@ -574,7 +983,8 @@ private:
     fft3d(logic_plan3d<index> const &plan, MPI_Comm const comm)  :
         backend::device_instance<location_tag>(),
         pinbox(new box3d<index>(plan.in_shape[0][plan.mpi_rank])), poutbox(new box3d<index>(plan.out_shape[3][plan.mpi_rank])),
-        scale_factor(1.0 / static_cast<double>(plan.index_count))
+        pfirst(new box3d<index>(plan.out_shape[0][plan.mpi_rank])), pspectrum(new box3d<index>(plan.out_shape[2][plan.mpi_rank])),
+        scale_factor(1.0 / static_cast<double>(plan.index_count)), options(plan.options)
         #ifdef Heffte_ENABLE_MAGMA
         , hmagma(this->stream())
         #endif
@@ -587,7 +997,8 @@ private:
           logic_plan3d<index> const &plan, MPI_Comm const comm) :
         backend::device_instance<location_tag>(gpu_stream),
         pinbox(new box3d<index>(plan.in_shape[0][plan.mpi_rank])), poutbox(new box3d<index>(plan.out_shape[3][plan.mpi_rank])),
-        scale_factor(1.0 / static_cast<double>(plan.index_count))
+        pfirst(new box3d<index>(plan.out_shape[0][plan.mpi_rank])), pspectrum(new box3d<index>(plan.out_shape[2][plan.mpi_rank])),
+        scale_factor(1.0 / static_cast<double>(plan.index_count)), options(plan.options)
         #ifdef Heffte_ENABLE_MAGMA
         , hmagma(this->stream())
         #endif
@@ -595,6 +1006,29 @@ private:
         setup(plan, comm);
     }
 
+    /*!
+     * \brief Returns the options to use in the plan, runs heffte::autotune_options() if the options request tuning.
+     *
+     * The gpu_stream is either nullptr (use the default stream) or a pointer to the stream passed to the constructor.
+     */
+    static plan_options autotune(typename std::remove_reference<typename backend::device_instance<location_tag>::stream_type>::type *gpu_stream,
+                                 box3d<index> const inbox, box3d<index> const outbox, MPI_Comm const comm, plan_options const options){
+        if (not options.use_autotune and options.grid_search == grid_selection::heuristic) return options;
+        using tune_type = typename std::conditional<backend::uses_fft_types<backend_tag>::value, std::complex<double>, double>::type;
+        return autotune_options<fft3d<backend_tag, index>, tune_type, tune_type>(inbox, outbox, -1, comm, options,
+            [&](plan_options const &candidate)->fft3d<backend_tag, index>{
+                return (gpu_stream == nullptr) ? fft3d<backend_tag, index>(inbox, outbox, comm, candidate)
+                                               : fft3d<backend_tag, index>(*gpu_stream, inbox, outbox, comm, candidate);
+            });
+    }
+
+    //! \brief Throws if the loaded plan uses options that are not supported by the backend.
+    static logic_plan3d<index> const& check_loaded(logic_plan3d<index> const &plan){
+        if (set_options<backend_tag>(plan.options).use_reorder != plan.options.use_reorder)
+            throw std::runtime_error("heffte::fft3d::load(), the plan was saved with options not supported by backend " + backend::name<backend_tag>());
+        return plan;
+    }
+
     //! \brief Setup the executors and the reshapes.
     void setup(logic_plan3d<index> const &plan, MPI_Comm const comm){
         for(int i=0; i<4; i++){
@@ -617,19 +1051,34 @@ private:
                                                           plan.fft_direction[1], plan.fft_direction[2]);
             }
         }else{
-            executors[0] = make_executor<backend_tag>(this->stream(), plan.out_shape[0][my_rank], plan.fft_direction[0]);
-            executors[1] = make_executor<backend_tag>(this->stream(), plan.out_shape[1][my_rank], plan.fft_direction[1]);
-            executors[2] = make_executor<backend_tag>(this->stream(), plan.out_shape[2][my_rank], plan.fft_direction[2]);
+            for(int i=0; i<3; i++){
+                if (backend::uses_fft_types<backend_tag>::value and is_trivial_stage(plan, i))
+                    executors[i] = std::unique_ptr<executor_base>(new identity_executor(plan.out_shape[i][my_rank]));
+                else
+                    executors[i] = make_executor<backend_tag>(this->stream(), plan.out_shape[i][my_rank], plan.fft_direction[i]);
+            }
         }
 
         size_t executor_workspace_size = get_max_work_size(executors);
         comm_buffer_offset = std::max(get_workspace_size(forward_shaper), get_workspace_size(backward_shaper));
-        // the last junk of (fft0->box_size() + 1) / 2 is used only when doing complex-to-real backward transform
-        // maybe update the API to call for different size buffers for different complex/real types
-        int last_chunk = (executors[0] == nullptr) ? 0 : (((backward_shaper[3]) ? (executors[0]->box_size() + 1) / 2 : 0));
-        size_buffer_work =  comm_buffer_offset + executor_workspace_size
-                          + get_max_box_size(executors)
-                          + last_chunk;
+        max_stage_size = get_max_box_size(executors);
+        swap_buffer_offset = 0;
+        if (plan.options.use_low_memory){
+            // the swap buffer is needed only if the output cannot hold the intermediate stages
+            bool const output_as_swap = (pinbox->count() >= static_cast<long long>(max_stage_size)
+                                         and poutbox->count() >= static_cast<long long>(max_stage_size));
+            if (not output_as_swap)
+                swap_buffer_offset = comm_buffer_offset + max_stage_size;
+            size_buffer_work = comm_buffer_offset + executor_workspace_size
+                             + ((output_as_swap) ? 1 : 2) * max_stage_size;
+        }else{
+            // the last junk of (fft0->box_size() + 1) / 2 is used only when doing complex-to-real backward transform
+            // maybe update the API to call for different size buffers for different complex/real types
+            int last_chunk = (executors[0] == nullptr) ? 0 : (((backward_shaper[3]) ? (executors[0]->box_size() + 1) / 2 : 0));
+            size_buffer_work =  comm_buffer_offset + executor_workspace_size
+                              + max_stage_size
+                              + last_chunk;
+        }
         executor_buffer_offset = (executor_workspace_size == 0) ? 0 : size_buffer_work - executor_workspace_size;
 
         if (not backend::uses_fft_types<backend_tag>::value){
@@ -649,6 +1098,16 @@ private:
             }
         }
     }
+    //! \brief Return references to the reshapes in forward order, the spectrum variant skips the reshape to the outbox.
+    std::array<reshape3d_base<index>*, 4> forward_shapers(bool spectrum = false) const{
+        return std::array<reshape3d_base<index>*, 4>{forward_shaper[0].get(), forward_shaper[1].get(), forward_shaper[2].get(),
+                                                     (spectrum) ? nullptr : forward_shaper[3].get()};
+    }
+    //! \brief Return references to the reshapes in backward order, the spectrum variant skips the reshape from the outbox.
+    std::array<reshape3d_base<index>*, 4> backward_shapers(bool spectrum = false) const{
+        return std::array<reshape3d_base<index>*, 4>{(spectrum) ? nullptr : backward_shaper[0].get(), backward_shaper[1].get(),
+                                                     backward_shaper[2].get(), backward_shaper[3].get()};
+    }
     //! \brief Return references to the executors in forward order.
     std::array<executor_base*, 3> forward_executors() const{
         return std::array<executor_base*, 3>{executors[0].get(), executors[1].get(), executors[2].get()};
@@ -658,27 +1117,143 @@ private:
         return std::array<executor_base*, 3>{executors[2].get(), executors[1].get(), executors[0].get()};
     }
 
+    /*!
+     * \brief Performs the transform, applies the callbacks and the scaling.
+     *
+     * On the CPU, the scaling and the store callback are fused into the unpack stage of the last reshape,
+     * and the load callback into the first reshape (or the copy into the internal buffers).
+     * If there is no last reshape, the store callback and the scaling are applied in one pass over the output.
+     */
+    template<typename input_type, typename output_type, typename workspace_type>
+    void compute_and_scale(int const batch_size, input_type const input[], output_type output[], workspace_type workspace[],
+                           direction dir, scale scaling,
+                           transform_callbacks<input_type, output_type, index> const &callbacks = transform_callbacks<input_type, output_type, index>()) const{
+        thread_scope threads(options.num_threads);
+        std::array<reshape3d_base<index>*, 4> shapers = (dir == direction::forward) ? forward_shapers() : backward_shapers();
+        box3d<index> const load_box  = (dir == direction::forward) ? *pfirst : *pspectrum;
+        box3d<index> const store_box = (dir == direction::forward) ? *poutbox : *pinbox;
+        double const store_scale = (scaling == scale::none) ? 1.0 : get_scale_factor(scaling);
+
+        std::unique_ptr<reshape3d_base<index>> load_shaper, store_shaper;
+        if (callbacks.load){
+            load_shaper = std::unique_ptr<reshape3d_base<index>>(new reshape3d_callback<input_type, index>(shapers[0], load_box, callbacks.load));
+            shapers[0] = load_shaper.get();
+        }
+        // the unpack hooks can access the data only on the CPU
+        if (std::is_same<location_tag, tag::cpu>::value and shapers[3] != nullptr and (callbacks.store or scaling != scale::none)){
+            store_shaper = std::unique_ptr<reshape3d_base<index>>(
+                new reshape3d_callback<output_type, index>(shapers[3], store_box, callbacks.store, store_scale));
+            shapers[3] = store_shaper.get();
+        }
+
+        std::shared_ptr<void> swap_owner;
+        compute_transform<location_tag, index>(this->stream(), batch_size, input, output, workspace,
+                                               executor_buffer_offset, size_comm_buffers(), shapers,
+                                               (dir == direction::forward) ? forward_executors() : backward_executors(), dir, nullptr,
+                                               get_swap_buffer(batch_size, output, (dir == direction::forward) ? size_outbox() : size_inbox(),
+                                                               workspace, swap_owner));
+
+        if (not store_shaper){
+            if (callbacks.store){ // callback and scaling in one pass
+                reshape3d_callback<output_type, index>(nullptr, store_box, callbacks.store, store_scale).apply(batch_size, output, output, nullptr);
+            }else{
+                apply_scale(batch_size, dir, scaling, output);
+            }
+        }
+    }
+
+    //! \brief Creates a request for the transform in the given direction, the workspace_owner may be empty.
+    template<typename input_type, typename output_type, typename workspace_type>
+    fft_request make_request(int const batch_size, input_type const input[], output_type output[], workspace_type workspace[],
+                             std::shared_ptr<void> workspace_owner, direction dir, scale scaling) const{
+        transform_schedule schedule;
+        std::shared_ptr<void> swap_owner;
+        workspace_type *swap_buffer = get_swap_buffer(batch_size, output, (dir == direction::forward) ? size_outbox() : size_inbox(),
+                                                      workspace, swap_owner);
+        if (dir == direction::forward){
+            compute_transform<location_tag, index>(this->stream(), batch_size, input, output, workspace,
+                                                   executor_buffer_offset, size_comm_buffers(), forward_shapers(),
+                                                   forward_executors(), direction::forward, &schedule, swap_buffer);
+        }else{
+            compute_transform<location_tag, index>(this->stream(), batch_size, input, output, workspace,
+                                                   executor_buffer_offset, size_comm_buffers(), backward_shapers(),
+                                                   backward_executors(), direction::backward, &schedule, swap_buffer);
+        }
+        if (scaling != scale::none)
+            schedule.push_back([=](reshape_pending&)->void{ apply_scale(batch_size, dir, scaling, output); });
+        if (swap_owner)
+            workspace_owner = std::make_shared<std::array<std::shared_ptr<void>, 2>>(std::array<std::shared_ptr<void>, 2>{{workspace_owner, swap_owner}});
+        return fft_request(std::move(schedule), std::move(workspace_owner), options.num_threads);
+    }
+
+    /*!
+     * \brief Returns the buffer that alternates with the internal temp buffer in the low-memory mode, nullptr otherwise.
+     *
+     * The \b output is used if it can hold the intermediate stages, otherwise the buffer is taken from the workspace
+     * or, if the workspace has no room (complex-to-real transform), the buffer is allocated and held by the \b owner.
+     */
+    template<typename output_type, typename workspace_type>
+    workspace_type* get_swap_buffer(int const batch_size, output_type output[], long long output_size, workspace_type workspace[],
+                                    std::shared_ptr<void> &owner) const{
+        if (not options.use_low_memory) return nullptr;
+        if (std::is_same<output_type, workspace_type>::value and output_size >= static_cast<long long>(max_stage_size))
+            return reinterpret_cast<workspace_type*>(output);
+        if (swap_buffer_offset != 0)
+            return workspace + batch_size * swap_buffer_offset;
+        using container_type = decltype(make_buffer_container<workspace_type>(this->stream(), 0));
+        auto buffer = std::make_shared<container_type>(make_buffer_container<workspace_type>(this->stream(), batch_size * max_stage_size));
+        owner = buffer;
+        return buffer->data();
+    }
+
     //! \brief Applies the scaling factor to the data.
     template<typename scalar_type>
     void apply_scale(int const batch_size, direction dir, scale scaling, scalar_type data[]) const{
+        apply_scale(batch_size * ((dir == direction::forward) ? size_outbox() : size_inbox()), scaling, data);
+    }
+    //! \brief Applies the scaling factor to the given number of entries.
+    template<typename scalar_type>
+    void apply_scale(long long num_entries, scale scaling, scalar_type data[]) const{
         if (scaling != scale::none){
             add_trace name("scale");
             #ifdef Heffte_ENABLE_MAGMA
             if (std::is_same<typename backend::buffer_traits<backend_tag>::location, tag::gpu>::value){
-                hmagma.scal(batch_size * ((dir == direction::forward) ? size_outbox() : size_inbox()),
-                            get_scale_factor(scaling), data);
+                hmagma.scal(num_entries, get_scale_factor(scaling), data);
                 return;
             }
             #endif
-            data_scaling::apply(
-                this->stream(),
-                batch_size * ((dir == direction::forward) ? size_outbox() : size_inbox()),
-                data, get_scale_factor(scaling));
+            data_scaling::apply(this->stream(), num_entries, data, get_scale_factor(scaling));
         }
     }
 
+    //! \brief Implements convolve() and correlate(), the workspace holds the two spectrums followed by the transform workspace.
+    template<typename input_type, typename output_type, typename spectrum_type>
+    void spectral_product(input_type const x[], input_type const y[], output_type result[], spectrum_type workspace[],
+                          bool conjugate, scale scaling) const{
+        static_assert(backend::uses_fft_types<backend_tag>::value,
+                      "Convolution requires a backend that computes the Fourier transform, e.g., not the sine or cosine transforms.");
+        static_assert(backend::check_types<backend_tag, input_type, spectrum_type>::value
+                      and backend::check_types<backend_tag, output_type, spectrum_type>::value,
+                      "Using either an unknown complex type or an incompatible set of types!");
+
+        thread_scope threads(options.num_threads);
+        spectrum_type *xhat = workspace + size_workspace();
+        spectrum_type *yhat = xhat + size_spectrum();
+        forward_spectrum(x, xhat, workspace);
+        forward_spectrum(y, yhat, workspace);
+        {
+            add_trace name("product");
+            data_scaling::multiply(this->stream(), size_spectrum(), xhat, yhat, conjugate,
+                                   (scaling == scale::none) ? 1.0 : get_scale_factor(scaling));
+        }
+        backward_spectrum(static_cast<spectrum_type const*>(yhat), result, workspace);
+    }
+
     std::unique_ptr<box3d<index>> pinbox, poutbox; // inbox/output for this process
+    std::unique_ptr<box3d<index>> pfirst; // layout before the first 1-D transform
+    std::unique_ptr<box3d<index>> pspectrum; // layout after the last 1-D transform
     double scale_factor;
+    plan_options options;
     std::array<std::unique_ptr<reshape3d_base<index>>, 4> forward_shaper;
     std::array<std::unique_ptr<reshape3d_base<index>>, 4> backward_shaper;
 
@@ -689,6 +1264,9 @@ private:
 
     // cache some values for faster read
     size_t size_buffer_work, comm_buffer_offset, executor_buffer_offset;
+    size_t max_stage_size, swap_buffer_offset; // the swap buffer offset is zero if the workspace does not hold a swap buffer
+
+    std::shared_ptr<workspace_pool<location_tag>> pool;
 };
 
 /*!
@@ -762,6 +1340,44 @@ fft3d<backend_tag, index> make_fft3d(box3d<index> const inbox, box3d<index> cons
     return fft3d<backend_tag, index>(inbox, outbox, comm, options);
 }
 
+/*!
+ * \ingroup fft3d
+ * \brief Computes the analytical cost of an existing plan, see heffte::estimate_plan_cost().
+ *
+ * The plan logic is recomputed from the boxes of all ranks and the options returned by fft.get_options(),
+ * which requires MPI_Allgather() on the \b comm used to create the \b fft.
+ * Unlike the estimate computed from a heffte::logic_plan3d, the workspace is exact and includes
+ * the workspace of the backend.
+ *
+ * \param fft is an existing plan
+ * \param comm is the communicator used to create the plan
+ * \param element_size is the size of the scalar type of the transform, e.g., sizeof(std::complex<float>)
+ */
+template<typename backend_tag, typename index>
+plan_cost estimate_plan_cost(fft3d<backend_tag, index> const &fft, MPI_Comm const comm,
+                             size_t element_size = sizeof(std::complex<double>)){
+    plan_cost cost = estimate_plan_cost(plan_operations(mpi::gather_boxes(fft.inbox(), fft.outbox(), comm), -1,
+                                                        fft.get_options(), mpi::comm_rank(comm)),
+                                        element_size);
+    long long const workspace = static_cast<long long>(fft.size_workspace() * element_size);
+    MPI_Allgather(&workspace, 1, MPI_LONG_LONG, cost.workspace_bytes.data(), 1, MPI_LONG_LONG, comm);
+    cost.max_workspace_bytes = *std::max_element(cost.workspace_bytes.begin(), cost.workspace_bytes.end());
+    return cost;
+}
+
+/*!
+ * \ingroup fft3d
+ * \brief Saves the plan to a file, the plan can be created again with fft3d::load().
+ *
+ * The method repeats the gather of the boxes and the analysis of the plan (but not the tuning)
+ * and writes the result with heffte::save_plan(), the call is collective across the \b comm.
+ */
+template<typename backend_tag, typename index>
+void save_plan(std::string const &filename, fft3d<backend_tag, index> const &fft, MPI_Comm const comm){
+    save_plan(filename, plan_operations(mpi::gather_boxes(fft.inbox(), fft.outbox(), comm), -1, fft.get_options(), mpi::comm_rank(comm)),
+              -1, comm);
+}
+
 }
 
 #endif
@@ -0,0 +1,539 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+*/
+
+#ifndef HEFFTE_FFT3D_MIXED_H
+#define HEFFTE_FFT3D_MIXED_H
+
+#include "heffte_fft3d_r2c.h"
+
+namespace heffte {
+
+namespace backend {
+    /*!
+     * \ingroup fft3dbackend
+     * \brief Defines the backend tag for the sine or cosine transform of the given kind that uses the same library as the backend_tag.
+     *
+     * The type is void if the backend does not support the transform.
+     */
+    template<typename backend_tag, transform_kind kind> struct r2r_variant{
+        //! \brief The kind is not supported by the backend.
+        using type = void;
+    };
+    /*!
+     * \ingroup fft3dbackend
+     * \brief Defines true if the r2r backend calls the sine and cosine transforms of the library directly (affects the scaling).
+     */
+    template<typename r2r_tag> struct is_native_r2r : std::false_type{};
+
+    //! \brief Type I cosine transform for the stock backend.
+    template<> struct r2r_variant<stock, transform_kind::dct1>{ using type = stock_cos1; };
+    //! \brief Type II cosine transform for the stock backend.
+    template<> struct r2r_variant<stock, transform_kind::dct2>{ using type = stock_cos; };
+    //! \brief Type II sine transform for the stock backend.
+    template<> struct r2r_variant<stock, transform_kind::dst2>{ using type = stock_sin; };
+
+    //! \brief Type I cosine transform for the fftw backend.
+    template<> struct r2r_variant<fftw, transform_kind::dct1>{ using type = fftw_cos1; };
+    //! \brief Type II cosine transform for the fftw backend.
+    template<> struct r2r_variant<fftw, transform_kind::dct2>{ using type = fftw_cos; };
+    //! \brief Type I sine transform for the fftw backend.
+    template<> struct r2r_variant<fftw, transform_kind::dst1>{ using type = fftw_sin1; };
+    //! \brief Type II sine transform for the fftw backend.
+    template<> struct r2r_variant<fftw, transform_kind::dst2>{ using type = fftw_sin; };
+    //! \brief The fftw transforms are native.
+    template<> struct is_native_r2r<fftw_cos1> : std::true_type{};
+    //! \brief The fftw transforms are native.
+    template<> struct is_native_r2r<fftw_cos> : std::true_type{};
+    //! \brief The fftw transforms are native.
+    template<> struct is_native_r2r<fftw_sin1> : std::true_type{};
+    //! \brief The fftw transforms are native.
+    template<> struct is_native_r2r<fftw_sin> : std::true_type{};
+
+    //! \brief Type II cosine transform for the mkl backend.
+    template<> struct r2r_variant<mkl, transform_kind::dct2>{ using type = mkl_cos; };
+    //! \brief Type II sine transform for the mkl backend.
+    template<> struct r2r_variant<mkl, transform_kind::dst2>{ using type = mkl_sin; };
+
+    //! \brief Type I cosine transform for the cufft backend.
+    template<> struct r2r_variant<cufft, transform_kind::dct1>{ using type = cufft_cos1; };
+    //! \brief Type II cosine transform for the cufft backend.
+    template<> struct r2r_variant<cufft, transform_kind::dct2>{ using type = cufft_cos; };
+    //! \brief Type II sine transform for the cufft backend.
+    template<> struct r2r_variant<cufft, transform_kind::dst2>{ using type = cufft_sin; };
+
+    //! \brief Type I cosine transform for the rocfft backend.
+    template<> struct r2r_variant<rocfft, transform_kind::dct1>{ using type = rocfft_cos1; };
+    //! \brief Type II cosine transform for the rocfft backend.
+    template<> struct r2r_variant<rocfft, transform_kind::dct2>{ using type = rocfft_cos; };
+    //! \brief Type II sine transform for the rocfft backend.
+    template<> struct r2r_variant<rocfft, transform_kind::dst2>{ using type = rocfft_sin; };
+
+    //! \brief Type II cosine transform for the onemkl backend.
+    template<> struct r2r_variant<onemkl, transform_kind::dct2>{ using type = onemkl_cos; };
+    //! \brief Type II sine transform for the onemkl backend.
+    template<> struct r2r_variant<onemkl, transform_kind::dst2>{ using type = onemkl_sin; };
+}
+
+/*!
+ * \ingroup fft3dbackend
+ * \brief Creates the executor for the sine or cosine transform associated with the r2r_tag.
+ */
+template<typename r2r_tag>
+struct r2r_executor_factory{
+    //! \brief Returns the executor for the box and dimension, or null if the box is empty.
+    template<typename stream_type, typename index>
+    static std::unique_ptr<executor_base> make(stream_type stream, box3d<index> const box, int dimension, transform_kind){
+        return make_executor<r2r_tag>(stream, box, dimension);
+    }
+    //! \brief Returns the factor that scales the pair of forward and backward transforms of the given size.
+    static double scale(transform_kind kind, long long size){
+        double const pair = (backend::is_native_r2r<r2r_tag>::value) ? 2.0 : 4.0;
+        if (kind == transform_kind::dct1)
+            return 1.0 / (pair * static_cast<double>(size - 1));
+        else if (kind == transform_kind::dst1)
+            return 1.0 / (pair * static_cast<double>(size + 1));
+        return 1.0 / (pair * static_cast<double>(size));
+    }
+};
+/*!
+ * \ingroup fft3dbackend
+ * \brief Specialization indicating that the backend does not support the kind.
+ */
+template<>
+struct r2r_executor_factory<void>{
+    //! \brief Throws std::invalid_argument.
+    template<typename stream_type, typename index>
+    static std::unique_ptr<executor_base> make(stream_type, box3d<index> const, int, transform_kind){
+        throw std::invalid_argument("The transform_kind requested for heffte::fft3d_mixed is not supported by the backend.");
+    }
+    //! \brief Never used.
+    static double scale(transform_kind, long long){ return 1.0; }
+};
+
+/*!
+ * \ingroup fft3d
+ * \brief Three dimensional transform with a different kind of 1-D transform in each direction.
+ *
+ * \par Overview
+ * Problems that are periodic in some directions and have walls in the others, e.g., channel flows,
+ * combine the Fourier transform with the sine or cosine transforms.
+ * Instead of using one heffte::fft3d_r2c and one heffte::rtransform plan with reshapes or copies in-between,
+ * the heffte::fft3d_mixed plan applies a heffte::transform_kind in each direction within one set of reshapes.
+ * The input is always real, the real-to-real directions are transformed first, and if any direction uses
+ * transform_kind::fft, then exactly one direction must use transform_kind::fft_r2c which shortens the data
+ * in the same way as heffte::fft3d_r2c. The output is complex if the kinds include the Fourier transform
+ * and real otherwise.
+ *
+ * Example, periodic in x and y and using a cosine basis in z:
+ * \code
+ *  heffte::fft3d_mixed<heffte::backend::fftw> fft(inbox, outbox,
+ *                                                 {heffte::transform_kind::fft_r2c, heffte::transform_kind::fft,
+ *                                                  heffte::transform_kind::dct2}, comm);
+ *  std::vector<double> x(fft.size_inbox());
+ *  std::vector<std::complex<double>> y(fft.size_outbox());
+ *  fft.forward(x.data(), y.data());
+ * \endcode
+ *
+ * \par Backends
+ * The backend_tag is one of the Fourier transform backends, e.g., heffte::backend::fftw,
+ * and the sine and cosine transforms use the corresponding variants, e.g., heffte::backend::fftw_cos;
+ * see heffte::backend::r2r_variant for the supported kinds.
+ * The plan always uses pencils and plan_options::use_reorder is enabled if the kinds include
+ * a real-to-real transform, the other options have the same meaning as in heffte::fft3d.
+ * The scale::full factor inverts the pair of forward and backward transforms, i.e., uses the same
+ * normalization as the backends used for each direction.
+ */
+template<typename backend_tag, typename index = int>
+class fft3d_mixed : public backend::device_instance<typename backend::buffer_traits<backend_tag>::location>{
+public:
+    //! \brief Type-tag that is either tag::cpu or tag::gpu to indicate the location of the data.
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    //! \brief Alias to the container template associated with the backend (allows for RAII memory management).
+    template<typename T> using buffer_container = typename backend::buffer_traits<backend_tag>::template container<T>;
+
+    /*!
+     * \brief Constructor creating a plan for the transform across the given communicator and using the box geometry.
+     *
+     * \param inbox is the box for the real input data of the forward() transform
+     * \param outbox is the box for the transformed data, shortened in the transform_kind::fft_r2c direction (if any)
+     * \param kinds is the transform to apply in each direction
+     * \param comm is the MPI communicator with all ranks that will participate in the transform
+     * \param options is a set of options that define the plan, see heffte::plan_options
+     *
+     * \throws std::invalid_argument if the combination of kinds is not valid or not supported by the backend
+     */
+    fft3d_mixed(box3d<index> const inbox, box3d<index> const outbox, std::array<transform_kind, 3> const &kinds,
+                MPI_Comm const comm, plan_options const options = default_options<backend_tag>()) :
+        fft3d_mixed(plan_mixed_operations(mpi::gather_boxes(inbox, outbox, comm), kinds, mixed_options(kinds, options),
+                                          mpi::comm_rank(comm)), kinds, comm){
+        static_assert(backend::is_enabled<backend_tag>::value, "The requested backend is invalid or has not been enabled.");
+        static_assert(backend::uses_fft_types<backend_tag>::value, "The fft3d_mixed class requires a Fourier transform backend.");
+    }
+    //! \brief Same as the other constructor but accepts a GPU stream.
+    fft3d_mixed(typename backend::device_instance<location_tag>::stream_type gpu_stream,
+                box3d<index> const inbox, box3d<index> const outbox, std::array<transform_kind, 3> const &kinds,
+                MPI_Comm const comm, plan_options const options = default_options<backend_tag>()) :
+        fft3d_mixed(gpu_stream, plan_mixed_operations(mpi::gather_boxes(inbox, outbox, comm), kinds, mixed_options(kinds, options),
+                                                      mpi::comm_rank(comm)), kinds, comm){
+        static_assert(backend::is_enabled<backend_tag>::value, "The requested backend is invalid or has not been enabled.");
+        static_assert(backend::uses_fft_types<backend_tag>::value, "The fft3d_mixed class requires a Fourier transform backend.");
+    }
+
+    //! \brief Returns the size of the inbox defined in the constructor.
+    long long size_inbox() const{ return pinbox->count(); }
+    //! \brief Returns the size of the outbox defined in the constructor.
+    long long size_outbox() const{ return poutbox->count(); }
+    //! \brief Returns the inbox.
+    box3d<index> inbox() const{ return *pinbox; }
+    //! \brief Returns the outbox.
+    box3d<index> outbox() const{ return *poutbox; }
+    //! \brief Returns the kind of transform used in each direction.
+    std::array<transform_kind, 3> get_kinds() const{ return kinds; }
+    //! \brief Returns true if the output of the forward transform is complex, i.e., if the kinds include transform_kind::fft_r2c.
+    bool complex_output() const{ return (r2c_stage != -1); }
+    //! \brief Returns the options used to create the plan.
+    plan_options get_options() const{ return options; }
+    /*!
+     * \brief Returns the workspace size, measured in the output type of the forward transform.
+     *
+     * The workspace holds the communication buffers, two buffers for the intermediate stages
+     * (either real or complex) and the workspace of the 1-D executors.
+     */
+    size_t size_workspace() const{ return (complex_output()) ? (size_real_work + 1) / 2 : size_real_work; }
+
+    /*!
+     * \brief Performs the forward transform.
+     *
+     * \tparam input_type is either float or double
+     * \tparam output_type is complex if complex_output() is true and the same as the input_type otherwise
+     *
+     * \param input is an array of size at least size_inbox()
+     * \param output is an array of size at least size_outbox()
+     * \param workspace is an array of size at least size_workspace()
+     * \param scaling defines the type of scaling to apply (default no-scaling)
+     *
+     * \throws std::invalid_argument if the output type does not match complex_output()
+     */
+    template<typename input_type, typename output_type>
+    void forward(input_type const input[], output_type output[], output_type workspace[], scale scaling = scale::none) const{
+        static_assert(std::is_same<input_type, float>::value or std::is_same<input_type, double>::value,
+                      "The input of the forward transform must be real, i.e., either float or double.");
+        static_assert(std::is_same<input_type, output_type>::value
+                   or (std::is_same<input_type, float>::value and is_ccomplex<output_type>::value)
+                   or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+        check_output_type<output_type>();
+        compute_forward(input, convert_to_standard(output), reinterpret_cast<input_type*>(workspace), scaling);
+    }
+    //! \brief Overload that allocates the workspace internally.
+    template<typename input_type, typename output_type>
+    void forward(input_type const input[], output_type output[], scale scaling = scale::none) const{
+        auto workspace = make_buffer_container<typename define_standard_type<output_type>::type>(this->stream(), size_workspace());
+        forward(input, output, reinterpret_cast<output_type*>(workspace.data()), scaling);
+    }
+
+    /*!
+     * \brief Performs the backward transform, the input and output correspond to the output and input of forward().
+     */
+    template<typename input_type, typename output_type>
+    void backward(input_type const input[], output_type output[], input_type workspace[], scale scaling = scale::none) const{
+        static_assert(std::is_same<output_type, float>::value or std::is_same<output_type, double>::value,
+                      "The output of the backward transform must be real, i.e., either float or double.");
+        static_assert(std::is_same<input_type, output_type>::value
+                   or (std::is_same<output_type, float>::value and is_ccomplex<input_type>::value)
+                   or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+        check_output_type<input_type>();
+        compute_backward(convert_to_standard(input), output, reinterpret_cast<output_type*>(workspace), scaling);
+    }
+    //! \brief Overload that allocates the workspace internally.
+    template<typename input_type, typename output_type>
+    void backward(input_type const input[], output_type output[], scale scaling = scale::none) const{
+        auto workspace = make_buffer_container<typename define_standard_type<input_type>::type>(this->stream(), size_workspace());
+        backward(input, output, reinterpret_cast<input_type*>(workspace.data()), scaling);
+    }
+
+    //! \brief Returns the scale factor for the given scaling.
+    double get_scale_factor(scale scaling) const{ return (scaling == scale::symmetric) ? std::sqrt(scale_factor) : scale_factor; }
+
+private:
+    //! \brief Enables the reorder if the kinds include a sine or cosine transform, the executors work only in the leading direction.
+    static plan_options mixed_options(std::array<transform_kind, 3> const &kinds, plan_options options){
+        if (is_real_kind(kinds[0]) or is_real_kind(kinds[1]) or is_real_kind(kinds[2]))
+            options.use_reorder = true;
+        return options;
+    }
+    //! \brief Constructor using the plan.
+    fft3d_mixed(logic_plan3d<index> const &plan, std::array<transform_kind, 3> const &ikinds, MPI_Comm const comm) :
+        pinbox(new box3d<index>(plan.in_shape[0][plan.mpi_rank])), poutbox(new box3d<index>(plan.out_shape[3][plan.mpi_rank])),
+        kinds(ikinds), options(plan.options)
+    {
+        setup(plan, comm);
+    }
+    //! \brief Constructor using the plan and a GPU stream.
+    fft3d_mixed(typename backend::device_instance<location_tag>::stream_type gpu_stream,
+                logic_plan3d<index> const &plan, std::array<transform_kind, 3> const &ikinds, MPI_Comm const comm) :
+        backend::device_instance<location_tag>(gpu_stream),
+        pinbox(new box3d<index>(plan.in_shape[0][plan.mpi_rank])), poutbox(new box3d<index>(plan.out_shape[3][plan.mpi_rank])),
+        kinds(ikinds), options(plan.options)
+    {
+        setup(plan, comm);
+    }
+
+    //! \brief Returns the executor for the sine or cosine transform of the given kind.
+    template<typename stream_type>
+    static std::unique_ptr<executor_base> make_r2r_executor(stream_type stream, transform_kind kind, box3d<index> const box, int dimension){
+        switch(kind){
+            case transform_kind::dct1:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dct1>::type>::make(stream, box, dimension, kind);
+            case transform_kind::dct2:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dct2>::type>::make(stream, box, dimension, kind);
+            case transform_kind::dst1:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dst1>::type>::make(stream, box, dimension, kind);
+            default:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dst2>::type>::make(stream, box, dimension, kind);
+        }
+    }
+    //! \brief Returns the scale factor for the pair of forward and backward transforms in one direction.
+    static double direction_scale(transform_kind kind, long long size){
+        switch(kind){
+            case transform_kind::dct1:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dct1>::type>::scale(kind, size);
+            case transform_kind::dct2:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dct2>::type>::scale(kind, size);
+            case transform_kind::dst1:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dst1>::type>::scale(kind, size);
+            case transform_kind::dst2:
+                return r2r_executor_factory<typename backend::r2r_variant<backend_tag, transform_kind::dst2>::type>::scale(kind, size);
+            default:
+                return 1.0 / static_cast<double>(size);
+        }
+    }
+
+    //! \brief Setup the executors, the reshapes and the workspace offsets.
+    void setup(logic_plan3d<index> const &plan, MPI_Comm const comm){
+        for(int i=0; i<4; i++){
+            forward_shaper[i]    = make_reshape3d<backend_tag>(this->stream(), plan.in_shape[i], plan.out_shape[i], comm, plan.options);
+            backward_shaper[3-i] = make_reshape3d<backend_tag>(this->stream(), plan.out_shape[i], plan.in_shape[i], comm, plan.options);
+        }
+
+        int const my_rank = plan.mpi_rank;
+        r2c_stage = -1;
+        scale_factor = 1.0;
+        for(int i=0; i<3; i++){
+            int const dir = plan.fft_direction[i];
+            box3d<index> const box = plan.out_shape[i][my_rank];
+            if (is_real_kind(kinds[dir])){
+                executors[i] = make_r2r_executor(this->stream(), kinds[dir], box, dir);
+            }else if (kinds[dir] == transform_kind::fft_r2c){
+                r2c_stage = i;
+                executors[i] = make_executor_r2c<backend_tag>(this->stream(), box, dir);
+            }else{
+                executors[i] = make_executor<backend_tag>(this->stream(), box, dir);
+            }
+            scale_factor *= direction_scale(kinds[dir], plan.fft_sizes[dir]);
+        }
+
+        // the data before the i-th forward reshape (and after the (3-i)-th backward one) is complex after the r2c stage
+        // all sizes are measured in real numbers and rounded up to even, so that the complex buffers are aligned
+        auto even = [](size_t s)->size_t{ return s + (s % 2); };
+        size_t comm_size = 0, stage_size = 0, exec_size = 0;
+        for(int i=0; i<4; i++){
+            size_t const width = (is_complex_reshape(i)) ? 2 : 1;
+            data_count[i] = plan.in_shape[i][my_rank].count();
+            if (forward_shaper[i])
+                comm_size = std::max(comm_size, width * forward_shaper[i]->size_workspace());
+            if (backward_shaper[3-i])
+                comm_size = std::max(comm_size, width * backward_shaper[3-i]->size_workspace());
+            stage_size = std::max(stage_size, width * static_cast<size_t>(plan.in_shape[i][my_rank].count()));
+            stage_size = std::max(stage_size, width * static_cast<size_t>(plan.out_shape[i][my_rank].count()));
+        }
+        for(int i=0; i<3; i++){
+            if (executors[i])
+                exec_size = std::max(exec_size, ((is_real_kind(kinds[plan.fft_direction[i]])) ? 1 : 2) * executors[i]->workspace_size());
+        }
+        comm_offset  = 0;
+        stage_offset = even(comm_size);
+        stage_stride = even(stage_size);
+        exec_offset  = (exec_size == 0) ? 0 : stage_offset + 2 * stage_stride;
+        size_real_work = stage_offset + 2 * stage_stride + even(exec_size);
+    }
+
+    //! \brief Returns true if the forward reshape i moves complex data.
+    bool is_complex_reshape(int i) const{ return (r2c_stage != -1 and i > r2c_stage); }
+
+    //! \brief Throws if the type of the complex data does not match the kinds.
+    template<typename scalar_type>
+    void check_output_type() const{
+        if (complex_output() != (is_ccomplex<scalar_type>::value or is_zcomplex<scalar_type>::value))
+            throw std::invalid_argument(std::string("The fft3d_mixed transform uses ") + ((complex_output()) ? "complex" : "real")
+                                        + " output, which does not match the type of the arrays.");
+    }
+
+    /*!
+     * \brief Moves the data into the next shape, or into the next stage buffer if the data is still the user input.
+     *
+     * Returns the pointer to the data in the new shape, the input is never overwritten.
+     */
+    template<typename scalar_type>
+    scalar_type* next_shape(reshape3d_base<index> const *shaper, scalar_type const data[], long long count, bool is_input,
+                            scalar_type *buffers[2], int &next, scalar_type workspace[]) const{
+        if (shaper){
+            shaper->apply(1, data, buffers[next], workspace);
+        }else if (is_input){
+            backend::data_manipulator<location_tag>::copy_n(this->stream(), data, count, buffers[next]);
+        }else{
+            return const_cast<scalar_type*>(data);
+        }
+        scalar_type *result = buffers[next];
+        next = 1 - next;
+        return result;
+    }
+    //! \brief Moves the data into the final shape, i.e., the user output.
+    template<typename scalar_type>
+    void last_shape(reshape3d_base<index> const *shaper, scalar_type const data[], long long count,
+                    scalar_type output[], scalar_type workspace[]) const{
+        if (shaper)
+            shaper->apply(1, data, output, workspace);
+        else
+            backend::data_manipulator<location_tag>::copy_n(this->stream(), data, count, output);
+    }
+
+    //! \brief Implements the forward transform, the output is either real_type or std::complex<real_type>.
+    template<typename real_type, typename output_type>
+    void compute_forward(real_type const input[], output_type output[], real_type workspace[], scale scaling) const{
+        thread_scope threads(options.num_threads);
+        using complex_type = std::complex<real_type>;
+        real_type *rbuffers[2]    = {workspace + stage_offset, workspace + stage_offset + stage_stride};
+        complex_type *cbuffers[2] = {reinterpret_cast<complex_type*>(rbuffers[0]), reinterpret_cast<complex_type*>(rbuffers[1])};
+        real_type *rcomm = workspace + comm_offset;
+        complex_type *ccomm = reinterpret_cast<complex_type*>(rcomm);
+        real_type *exec_work = (exec_offset == 0) ? nullptr : workspace + exec_offset;
+        complex_type *cexec_work = reinterpret_cast<complex_type*>(exec_work);
+
+        int next = 0;
+        real_type const *rdata = input;
+        complex_type *cdata = nullptr;
+        for(int i=0; i<3; i++){
+            if (r2c_stage == -1 or i < r2c_stage){
+                real_type *data = next_shape(forward_shaper[i].get(), rdata, data_count[i], (rdata == input), rbuffers, next, rcomm);
+                if (executors[i]) executors[i]->forward(data, exec_work);
+                rdata = data;
+            }else if (i == r2c_stage){
+                real_type const *data = (forward_shaper[i]) ?
+                    next_shape(forward_shaper[i].get(), rdata, data_count[i], (rdata == input), rbuffers, next, rcomm) : rdata;
+                cdata = cbuffers[next];
+                next = 1 - next;
+                if (executors[i]) executors[i]->forward(data, cdata, cexec_work);
+            }else{
+                cdata = next_shape(forward_shaper[i].get(), static_cast<complex_type const*>(cdata), data_count[i], false,
+                                   cbuffers, next, ccomm);
+                if (executors[i]) executors[i]->forward(cdata, cexec_work);
+            }
+        }
+        finish_forward(rdata, cdata, output, rcomm, ccomm);
+        apply_scale(size_outbox(), scaling, output);
+    }
+    //! \brief Moves the real result into the output.
+    template<typename real_type>
+    void finish_forward(real_type const rdata[], std::complex<real_type> const*, real_type output[],
+                        real_type rcomm[], std::complex<real_type>*) const{
+        last_shape(forward_shaper[3].get(), rdata, data_count[3], output, rcomm);
+    }
+    //! \brief Moves the complex result into the output.
+    template<typename real_type>
+    void finish_forward(real_type const*, std::complex<real_type> const cdata[], std::complex<real_type> output[],
+                        real_type*, std::complex<real_type> ccomm[]) const{
+        last_shape(forward_shaper[3].get(), cdata, data_count[3], output, ccomm);
+    }
+
+    //! \brief Implements the backward transform, the input is either real_type or std::complex<real_type>.
+    template<typename input_type, typename real_type>
+    void compute_backward(input_type const input[], real_type output[], real_type workspace[], scale scaling) const{
+        thread_scope threads(options.num_threads);
+        using complex_type = std::complex<real_type>;
+        real_type *rbuffers[2]    = {workspace + stage_offset, workspace + stage_offset + stage_stride};
+        complex_type *cbuffers[2] = {reinterpret_cast<complex_type*>(rbuffers[0]), reinterpret_cast<complex_type*>(rbuffers[1])};
+        real_type *rcomm = workspace + comm_offset;
+        complex_type *ccomm = reinterpret_cast<complex_type*>(rcomm);
+        real_type *exec_work = (exec_offset == 0) ? nullptr : workspace + exec_offset;
+        complex_type *cexec_work = reinterpret_cast<complex_type*>(exec_work);
+
+        int next = 0;
+        real_type const *rinput = nullptr;
+        complex_type const *cinput = nullptr;
+        set_input(input, rinput, cinput);
+        real_type *rdata = const_cast<real_type*>(rinput);
+        complex_type *cdata = const_cast<complex_type*>(cinput);
+        for(int i=2; i>=0; i--){
+            // backward_shaper[2-i] moves the data from the output of the i-th forward stage into its input
+            if (r2c_stage != -1 and i > r2c_stage){
+                cdata = next_shape(backward_shaper[2-i].get(), static_cast<complex_type const*>(cdata), data_count[i+1],
+                                   (cdata == cinput), cbuffers, next, ccomm);
+                if (executors[i]) executors[i]->backward(cdata, cexec_work);
+            }else if (i == r2c_stage){
+                // the complex-to-real transform can overwrite the input, always work on a copy
+                cdata = next_shape(backward_shaper[2-i].get(), static_cast<complex_type const*>(cdata), data_count[i+1],
+                                   (cdata == cinput), cbuffers, next, ccomm);
+                rdata = rbuffers[next];
+                next = 1 - next;
+                if (executors[i]) executors[i]->backward(cdata, rdata, cexec_work);
+            }else{
+                rdata = next_shape(backward_shaper[2-i].get(), static_cast<real_type const*>(rdata), data_count[i+1],
+                                   (rdata == rinput), rbuffers, next, rcomm);
+                if (executors[i]) executors[i]->backward(rdata, exec_work);
+            }
+        }
+        last_shape(backward_shaper[3].get(), static_cast<real_type const*>(rdata), data_count[0], output, rcomm);
+        apply_scale(size_inbox(), scaling, output);
+    }
+    //! \brief Sets the real input.
+    template<typename real_type>
+    static void set_input(real_type const input[], real_type const* &rinput, std::complex<real_type> const*&){ rinput = input; }
+    //! \brief Sets the complex input.
+    template<typename real_type>
+    static void set_input(std::complex<real_type> const input[], real_type const*&, std::complex<real_type> const* &cinput){ cinput = input; }
+
+    //! \brief Applies the scaling factor to the given number of entries.
+    template<typename scalar_type>
+    void apply_scale(long long num_entries, scale scaling, scalar_type data[]) const{
+        if (scaling != scale::none)
+            data_scaling::apply(this->stream(), num_entries, data, get_scale_factor(scaling));
+    }
+
+    std::unique_ptr<box3d<index>> pinbox, poutbox;
+    std::array<transform_kind, 3> const kinds;
+    plan_options options;
+    double scale_factor;
+    int r2c_stage; // the stage that performs the r2c transform, -1 if all stages are real-to-real
+    std::array<std::unique_ptr<reshape3d_base<index>>, 4> forward_shaper;
+    std::array<std::unique_ptr<reshape3d_base<index>>, 4> backward_shaper;
+    std::array<std::unique_ptr<executor_base>, 3> executors;
+
+    // data_count[i] is the size of the data before the i-th forward reshape, measured in real or complex numbers
+    std::array<long long, 4> data_count;
+    // offsets in the workspace measured in real numbers
+    size_t size_real_work, comm_offset, stage_offset, stage_stride, exec_offset;
+};
+
+/*!
+ * \ingroup fft3d
+ * \brief Factory method that auto-detects the index type based on the box.
+ */
+template<typename backend_tag, typename index>
+fft3d_mixed<backend_tag, index> make_fft3d_mixed(box3d<index> const inbox, box3d<index> const outbox,
+                                                 std::array<transform_kind, 3> const &kinds, MPI_Comm const comm,
+                                                 plan_options const options = default_options<backend_tag>()){
+    static_assert(std::is_same<index, int>::value or std::is_same<index, long long>::value,
+                  "heFFTe works with 'int' and 'long long' indexing only");
+    static_assert(backend::is_enabled<backend_tag>::value,
+                  "The backend_tag is not valid, perhaps it needs to be enabled in the build system");
+    return fft3d_mixed<backend_tag, index>(inbox, outbox, kinds, comm, options);
+}
+
+}
+
+#endif
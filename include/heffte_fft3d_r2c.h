@@ -75,7 +75,9 @@ public:
      */
     fft3d_r2c(box3d<index> const inbox, box3d<index> const outbox, int r2c_direction, MPI_Comm const comm,
               plan_options const options = default_options<backend_tag>()) :
-        fft3d_r2c(plan_operations(mpi::gather_boxes(inbox, outbox, comm), r2c_direction, set_options<backend_tag, true>(options), mpi::comm_rank(comm)), comm){
+        fft3d_r2c(plan_operations(mpi::gather_boxes(inbox, outbox, comm), r2c_direction,
+                                  set_options<backend_tag, true>(autotune(nullptr, inbox, outbox, r2c_direction, comm, options)),
+                                  mpi::comm_rank(comm)), comm){
         assert(r2c_direction == 0 or r2c_direction == 1 or r2c_direction == 2);
         static_assert(backend::is_enabled<backend_tag>::value, "The requested backend is invalid or has not been enabled.");
     }
@@ -86,7 +88,9 @@ public:
               box3d<index> const inbox, box3d<index> const outbox, int r2c_direction, MPI_Comm const comm,
               plan_options const options = default_options<backend_tag>()) :
         fft3d_r2c(gpu_stream,
-                  plan_operations(mpi::gather_boxes(inbox, outbox, comm), r2c_direction, set_options<backend_tag, true>(options), mpi::comm_rank(comm)),
+                  plan_operations(mpi::gather_boxes(inbox, outbox, comm), r2c_direction,
+                                  set_options<backend_tag, true>(autotune(&gpu_stream, inbox, outbox, r2c_direction, comm, options)),
+                                  mpi::comm_rank(comm)),
                   comm){
         assert(r2c_direction == 0 or r2c_direction == 1 or r2c_direction == 2);
         static_assert(backend::is_enabled<backend_tag>::value, "The requested backend is invalid or has not been enabled.");
@@ -125,7 +129,15 @@ public:
     box3d<index> inbox() const{ return *pinbox; }
     //! \brief Returns the outbox.
     box3d<index> outbox() const{ return *poutbox; }
-    //! \brief Returns the workspace size that will be used, size is measured in complex numbers.
+    //! \brief Returns the options used to create the plan, e.g., the options selected by plan_options::use_autotune or grid_search.
+    plan_options get_options() const{ return options; }
+    /*!
+     * \brief Returns the workspace size that will be used, size is measured in complex numbers.
+     *
+     * If plan_options::use_low_memory is set, the workspace holds only the largest message sent
+     * and received by a reshape and two buffers for the intermediate stages of the transform,
+     * since the real output of the backward transform cannot hold the complex stages.
+     */
     size_t size_workspace() const{ return size_buffer_work; }
     //! \brief Returns the size used by the communication workspace buffers (internal use).
     size_t size_comm_buffers() const{ return comm_buffer_offset; }
@@ -149,7 +161,7 @@ public:
                    or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<output_type>(this->stream(), size_workspace());
+        auto workspace = make_pooled_workspace<output_type>(pool, this->stream(), size_workspace());
         forward(input, output, workspace.data(), scaling);
     }
 
@@ -160,11 +172,8 @@ public:
                    or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), forward_shaper,
-                                               forward_executors(), direction::forward);
-        apply_scale(1, direction::forward, scaling, convert_to_standard(output));
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::forward, scaling);
     }
     //! \brief Overload utilizing a batch transform.
     template<typename input_type, typename output_type>
@@ -174,11 +183,8 @@ public:
                    or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), batch_size, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), forward_shaper,
-                                               forward_executors(), direction::forward);
-        apply_scale(batch_size, direction::forward, scaling, convert_to_standard(output));
+        compute_and_scale(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::forward, scaling);
     }
     //! \brief Overload utilizing a batch transform using internally allocated workspace.
     template<typename input_type, typename output_type>
@@ -187,7 +193,7 @@ public:
                    or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<output_type>(this->stream(), batch_size * size_workspace());
+        auto workspace = make_pooled_workspace<output_type>(pool, this->stream(), batch_size * size_workspace());
         forward(batch_size, input, output, workspace.data(), scaling);
     }
 
@@ -237,7 +243,7 @@ public:
                    or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<input_type>(this->stream(), size_workspace());
+        auto workspace = make_pooled_workspace<input_type>(pool, this->stream(), size_workspace());
         backward(input, output, workspace.data(), scaling);
     }
 
@@ -248,11 +254,8 @@ public:
                    or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), backward_shaper,
-                                               backward_executors(), direction::backward);
-        apply_scale(1, direction::backward, scaling, convert_to_standard(output));
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::backward, scaling);
     }
     //! \brief Overload that performs a batch transform.
     template<typename input_type, typename output_type>
@@ -262,11 +265,8 @@ public:
                    or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        compute_transform<location_tag, index>(this->stream(), batch_size, convert_to_standard(input), convert_to_standard(output),
-                                               convert_to_standard(workspace),
-                                               executor_buffer_offset, size_comm_buffers(), backward_shaper,
-                                               backward_executors(), direction::backward);
-        apply_scale(batch_size, direction::backward, scaling, convert_to_standard(output));
+        compute_and_scale(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::backward, scaling);
     }
     //! \brief Overload that performs a batch transform using internally allocated workspace.
     template<typename input_type, typename output_type>
@@ -275,10 +275,129 @@ public:
                    or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
                 "Using either an unknown complex type or an incompatible pair of types!");
 
-        auto workspace = make_buffer_container<input_type>(this->stream(), batch_size * size_workspace());
+        auto workspace = make_pooled_workspace<input_type>(pool, this->stream(), batch_size * size_workspace());
         backward(batch_size, input, output, workspace.data(), scaling);
     }
 
+    //! \brief Forward transform with pointwise callbacks, the load is real and the store is complex, see heffte::fft3d::forward().
+    template<typename input_type, typename output_type>
+    void forward(input_type const input[], output_type output[], output_type workspace[],
+                 transform_callbacks<input_type, typename define_standard_type<output_type>::type, index> const &callbacks,
+                 scale scaling = scale::none) const{
+        static_assert((std::is_same<input_type, float>::value and is_ccomplex<output_type>::value)
+                   or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        static_assert(std::is_same<location_tag, tag::cpu>::value, "Pointwise callbacks work only with backends that use the CPU.");
+
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::forward, scaling, callbacks);
+    }
+    //! \brief Overload of forward() with callbacks that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void forward(input_type const input[], output_type output[],
+                 transform_callbacks<input_type, typename define_standard_type<output_type>::type, index> const &callbacks,
+                 scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<output_type>(pool, this->stream(), size_workspace());
+        forward(input, output, workspace.data(), callbacks, scaling);
+    }
+    //! \brief Backward transform with pointwise callbacks, the load is complex and the store is real, see heffte::fft3d::forward().
+    template<typename input_type, typename output_type>
+    void backward(input_type const input[], output_type output[], input_type workspace[],
+                  transform_callbacks<typename define_standard_type<input_type>::type, output_type, index> const &callbacks,
+                  scale scaling = scale::none) const{
+        static_assert((std::is_same<output_type, float>::value and is_ccomplex<input_type>::value)
+                   or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        static_assert(std::is_same<location_tag, tag::cpu>::value, "Pointwise callbacks work only with backends that use the CPU.");
+
+        compute_and_scale(1, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                          direction::backward, scaling, callbacks);
+    }
+    //! \brief Overload of backward() with callbacks that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void backward(input_type const input[], output_type output[],
+                  transform_callbacks<typename define_standard_type<input_type>::type, output_type, index> const &callbacks,
+                  scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<input_type>(pool, this->stream(), size_workspace());
+        backward(input, output, workspace.data(), callbacks, scaling);
+    }
+
+    /*!
+     * \brief Starts a forward transform that will complete asynchronously, see heffte::fft3d::forward_async().
+     */
+    template<typename input_type, typename output_type>
+    fft_request forward_async(input_type const input[], output_type output[], scale scaling = scale::none) const{
+        return forward_async(1, input, output, scaling);
+    }
+    //! \brief Overload utilizing a user provided buffer.
+    template<typename input_type, typename output_type>
+    fft_request forward_async(input_type const input[], output_type output[], output_type workspace[], scale scaling = scale::none) const{
+        return forward_async(1, input, output, workspace, scaling);
+    }
+    //! \brief Overload utilizing a batch transform.
+    template<typename input_type, typename output_type>
+    fft_request forward_async(int batch_size, input_type const input[], output_type output[],
+                              output_type workspace[], scale scaling = scale::none) const{
+        static_assert((std::is_same<input_type, float>::value and is_ccomplex<output_type>::value)
+                   or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                            std::shared_ptr<void>(), direction::forward, scaling);
+    }
+    //! \brief Overload utilizing a batch transform using internally allocated workspace.
+    template<typename input_type, typename output_type>
+    fft_request forward_async(int batch_size, input_type const input[], output_type output[], scale scaling = scale::none) const{
+        static_assert((std::is_same<input_type, float>::value and is_ccomplex<output_type>::value)
+                   or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        using workspace_type = typename define_standard_type<output_type>::type;
+        auto workspace = std::make_shared<buffer_container<workspace_type>>(
+                            make_buffer_container<workspace_type>(this->stream(), batch_size * size_workspace()));
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), workspace->data(),
+                            workspace, direction::forward, scaling);
+    }
+
+    /*!
+     * \brief Starts a backward transform that will complete asynchronously, see heffte::fft3d::forward_async().
+     */
+    template<typename input_type, typename output_type>
+    fft_request backward_async(input_type const input[], output_type output[], scale scaling = scale::none) const{
+        return backward_async(1, input, output, scaling);
+    }
+    //! \brief Overload utilizing a user provided buffer.
+    template<typename input_type, typename output_type>
+    fft_request backward_async(input_type const input[], output_type output[], input_type workspace[], scale scaling = scale::none) const{
+        return backward_async(1, input, output, workspace, scaling);
+    }
+    //! \brief Overload that performs a batch transform.
+    template<typename input_type, typename output_type>
+    fft_request backward_async(int batch_size, input_type const input[], output_type output[],
+                               input_type workspace[], scale scaling = scale::none) const{
+        static_assert((std::is_same<output_type, float>::value and is_ccomplex<input_type>::value)
+                   or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), convert_to_standard(workspace),
+                            std::shared_ptr<void>(), direction::backward, scaling);
+    }
+    //! \brief Overload that performs a batch transform using internally allocated workspace.
+    template<typename input_type, typename output_type>
+    fft_request backward_async(int batch_size, input_type const input[], output_type output[], scale scaling = scale::none) const{
+        static_assert((std::is_same<output_type, float>::value and is_ccomplex<input_type>::value)
+                   or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        using workspace_type = typename define_standard_type<input_type>::type;
+        auto workspace = std::make_shared<buffer_container<workspace_type>>(
+                            make_buffer_container<workspace_type>(this->stream(), batch_size * size_workspace()));
+        return make_request(batch_size, convert_to_standard(input), convert_to_standard(output), workspace->data(),
+                            workspace, direction::backward, scaling);
+    }
+
     /*!
      * \brief Variant of backward() that uses buffer_container for RAII style of resource management.
      */
@@ -296,11 +415,117 @@ public:
      */
     double get_scale_factor(scale scaling) const{ return (scaling == scale::symmetric) ? std::sqrt(scale_factor) : scale_factor; }
 
+    //! \brief Returns the box of the spectrum, see fft3d::spectrum_box().
+    box3d<index> spectrum_box() const{ return *pspectrum; }
+    //! \brief Returns the size of the spectrum_box().
+    long long size_spectrum() const{ return pspectrum->count(); }
+    //! \brief Returns the size of the workspace used by convolve() and correlate(), measured in complex numbers.
+    size_t size_convolution_workspace() const{ return size_workspace() + 2 * static_cast<size_t>(size_spectrum()); }
+
+    //! \brief Attaches a workspace pool, see fft3d::set_workspace_pool().
+    void set_workspace_pool(std::shared_ptr<workspace_pool<location_tag>> const &new_pool){
+        pool = new_pool;
+        if (not pool) return;
+        pool->register_client(size_convolution_workspace());
+        for(auto &s : forward_shaper) if (s) s->set_staging_buffers(pool->send_buffer(), pool->recv_buffer());
+        for(auto &s : backward_shaper) if (s) s->set_staging_buffers(pool->send_buffer(), pool->recv_buffer());
+    }
+    //! \brief Returns the workspace pool attached to the plan, could be null.
+    std::shared_ptr<workspace_pool<location_tag>> const& get_workspace_pool() const{ return pool; }
+
+    //! \brief Creates a plan from a file written by heffte::save_plan(), see fft3d::load().
+    static fft3d_r2c<backend_tag, index> load(std::string const &filename, box3d<index> const inbox, box3d<index> const outbox,
+                                              int r2c_direction, MPI_Comm const comm){
+        return fft3d_r2c<backend_tag, index>(check_loaded(load_plan(filename, inbox, outbox, r2c_direction, comm)), comm);
+    }
+    //! \brief Same as the other load() but accepts a GPU stream.
+    static fft3d_r2c<backend_tag, index> load(typename backend::device_instance<location_tag>::stream_type gpu_stream,
+                                              std::string const &filename, box3d<index> const inbox, box3d<index> const outbox,
+                                              int r2c_direction, MPI_Comm const comm){
+        return fft3d_r2c<backend_tag, index>(gpu_stream, check_loaded(load_plan(filename, inbox, outbox, r2c_direction, comm)), comm);
+    }
+
+    //! \brief Forward transform with the result in the spectrum_box(), see fft3d::forward_spectrum().
+    template<typename input_type, typename output_type>
+    void forward_spectrum(input_type const input[], output_type spectrum[], output_type workspace[], scale scaling = scale::none) const{
+        static_assert((std::is_same<input_type, float>::value and is_ccomplex<output_type>::value)
+                   or (std::is_same<input_type, double>::value and is_zcomplex<output_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        thread_scope threads(options.num_threads);
+
+        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(input), convert_to_standard(spectrum),
+                                               convert_to_standard(workspace),
+                                               executor_buffer_offset, size_comm_buffers(), forward_shapers(true),
+                                               forward_executors(), direction::forward, nullptr,
+                                               get_swap_buffer(1, convert_to_standard(workspace)));
+        apply_scale(size_spectrum(), scaling, convert_to_standard(spectrum));
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void forward_spectrum(input_type const input[], output_type spectrum[], scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<output_type>(pool, this->stream(), size_workspace());
+        forward_spectrum(input, spectrum, workspace.data(), scaling);
+    }
+    //! \brief Backward transform starting from the spectrum_box(), see fft3d::backward_spectrum().
+    template<typename input_type, typename output_type>
+    void backward_spectrum(input_type const spectrum[], output_type output[], input_type workspace[], scale scaling = scale::none) const{
+        static_assert((std::is_same<output_type, float>::value and is_ccomplex<input_type>::value)
+                   or (std::is_same<output_type, double>::value and is_zcomplex<input_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        thread_scope threads(options.num_threads);
+
+        compute_transform<location_tag, index>(this->stream(), 1, convert_to_standard(spectrum), convert_to_standard(output),
+                                               convert_to_standard(workspace),
+                                               executor_buffer_offset, size_comm_buffers(), backward_shapers(true),
+                                               backward_executors(), direction::backward, nullptr,
+                                               get_swap_buffer(1, convert_to_standard(workspace)));
+        apply_scale(size_inbox(), scaling, convert_to_standard(output));
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type, typename output_type>
+    void backward_spectrum(input_type const spectrum[], output_type output[], scale scaling = scale::none) const{
+        auto workspace = make_pooled_workspace<input_type>(pool, this->stream(), size_workspace());
+        backward_spectrum(spectrum, output, workspace.data(), scaling);
+    }
+
+    /*!
+     * \brief Computes the circular convolution of two real arrays, see fft3d::convolve().
+     *
+     * The \b x, \b y and \b result are real arrays corresponding to the inbox,
+     * the \b workspace has size_convolution_workspace() complex numbers.
+     */
+    template<typename input_type, typename spectrum_type>
+    void convolve(input_type const x[], input_type const y[], input_type result[], spectrum_type workspace[],
+                  scale scaling = scale::full) const{
+        spectral_product(x, y, result, workspace, false, scaling);
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type>
+    void convolve(input_type const x[], input_type const y[], input_type result[], scale scaling = scale::full) const{
+        auto workspace = make_pooled_workspace<std::complex<input_type>>(pool, this->stream(), size_convolution_workspace());
+        convolve(x, y, result, workspace.data(), scaling);
+    }
+    //! \brief Computes the circular cross-correlation of two real arrays, see fft3d::correlate().
+    template<typename input_type, typename spectrum_type>
+    void correlate(input_type const x[], input_type const y[], input_type result[], spectrum_type workspace[],
+                   scale scaling = scale::full) const{
+        spectral_product(x, y, result, workspace, true, scaling);
+    }
+    //! \brief Overload that allocates workspace internally.
+    template<typename input_type>
+    void correlate(input_type const x[], input_type const y[], input_type result[], scale scaling = scale::full) const{
+        auto workspace = make_pooled_workspace<std::complex<input_type>>(pool, this->stream(), size_convolution_workspace());
+        correlate(x, y, result, workspace.data(), scaling);
+    }
+
 private:
     //! \brief Same as in the fft3d case.
     fft3d_r2c(logic_plan3d<index> const &plan, MPI_Comm const comm) :
         pinbox(new box3d<index>(plan.in_shape[0][plan.mpi_rank])), poutbox(new box3d<index>(plan.out_shape[3][plan.mpi_rank])),
-        scale_factor(1.0 / static_cast<double>(plan.index_count))
+        pfirst(new box3d<index>(plan.out_shape[0][plan.mpi_rank])), pspectrum(new box3d<index>(plan.out_shape[2][plan.mpi_rank])),
+        scale_factor(1.0 / static_cast<double>(plan.index_count)), options(plan.options)
         #ifdef Heffte_ENABLE_MAGMA
         , hmagma(this->stream())
         #endif
@@ -313,7 +538,8 @@ private:
               logic_plan3d<index> const &plan, MPI_Comm const comm) :
         backend::device_instance<location_tag>(gpu_stream),
         pinbox(new box3d<index>(plan.in_shape[0][plan.mpi_rank])), poutbox(new box3d<index>(plan.out_shape[3][plan.mpi_rank])),
-        scale_factor(1.0 / static_cast<double>(plan.index_count))
+        pfirst(new box3d<index>(plan.out_shape[0][plan.mpi_rank])), pspectrum(new box3d<index>(plan.out_shape[2][plan.mpi_rank])),
+        scale_factor(1.0 / static_cast<double>(plan.index_count)), options(plan.options)
         #ifdef Heffte_ENABLE_MAGMA
         , hmagma(this->stream())
         #endif
@@ -321,6 +547,25 @@ private:
         setup(plan, comm);
     }
 
+    //! \brief Same as in the fft3d case.
+    static plan_options autotune(typename std::remove_reference<typename backend::device_instance<location_tag>::stream_type>::type *gpu_stream,
+                                 box3d<index> const inbox, box3d<index> const outbox, int r2c_direction, MPI_Comm const comm,
+                                 plan_options const options){
+        if (not options.use_autotune and options.grid_search == grid_selection::heuristic) return options;
+        return autotune_options<fft3d_r2c<backend_tag, index>, double, std::complex<double>>(inbox, outbox, r2c_direction, comm, options,
+            [&](plan_options const &candidate)->fft3d_r2c<backend_tag, index>{
+                return (gpu_stream == nullptr) ? fft3d_r2c<backend_tag, index>(inbox, outbox, r2c_direction, comm, candidate)
+                                               : fft3d_r2c<backend_tag, index>(*gpu_stream, inbox, outbox, r2c_direction, comm, candidate);
+            });
+    }
+
+    //! \brief Throws if the loaded plan uses options that are not supported by the backend.
+    static logic_plan3d<index> const& check_loaded(logic_plan3d<index> const &plan){
+        if (set_options<backend_tag, true>(plan.options).use_reorder != plan.options.use_reorder)
+            throw std::runtime_error("heffte::fft3d_r2c::load(), the plan was saved with options not supported by backend " + backend::name<backend_tag>());
+        return plan;
+    }
+
     //! \brief Setup the executors and the reshapes.
     void setup(logic_plan3d<index> const &plan, MPI_Comm const comm){
         for(int i=0; i<4; i++){
@@ -329,15 +574,31 @@ private:
         }
 
         executors[0] = make_executor_r2c<backend_tag>(this->stream(), plan.out_shape[0][mpi::comm_rank(comm)], plan.fft_direction[0]);
-        executors[1] = make_executor<backend_tag>(this->stream(), plan.out_shape[1][mpi::comm_rank(comm)], plan.fft_direction[1]);
-        executors[2] = make_executor<backend_tag>(this->stream(), plan.out_shape[2][mpi::comm_rank(comm)], plan.fft_direction[2]);
+        for(int i=1; i<3; i++){
+            if (is_trivial_stage(plan, i))
+                executors[i] = std::unique_ptr<executor_base>(new identity_executor(plan.out_shape[i][mpi::comm_rank(comm)]));
+            else
+                executors[i] = make_executor<backend_tag>(this->stream(), plan.out_shape[i][mpi::comm_rank(comm)], plan.fft_direction[i]);
+        }
 
         size_t executor_workspace_size = get_max_work_size(executors);
         comm_buffer_offset = std::max(get_workspace_size(forward_shaper), get_workspace_size(backward_shaper));
+        // the low-memory mode places the swap buffer after the temp buffer
+        swap_buffer_offset = (plan.options.use_low_memory) ? comm_buffer_offset + get_max_box_size_r2c(executors) : 0;
         size_buffer_work = comm_buffer_offset
-                        + get_max_box_size_r2c(executors) + executor_workspace_size;
+                        + ((plan.options.use_low_memory) ? 2 : 1) * get_max_box_size_r2c(executors) + executor_workspace_size;
         executor_buffer_offset = (executor_workspace_size == 0) ? 0 : size_buffer_work - executor_workspace_size;
     }
+    //! \brief Return references to the reshapes in forward order, the spectrum variant skips the reshape to the outbox.
+    std::array<reshape3d_base<index>*, 4> forward_shapers(bool spectrum = false) const{
+        return std::array<reshape3d_base<index>*, 4>{forward_shaper[0].get(), forward_shaper[1].get(), forward_shaper[2].get(),
+                                                     (spectrum) ? nullptr : forward_shaper[3].get()};
+    }
+    //! \brief Return references to the reshapes in backward order, the spectrum variant skips the reshape from the outbox.
+    std::array<reshape3d_base<index>*, 4> backward_shapers(bool spectrum = false) const{
+        return std::array<reshape3d_base<index>*, 4>{(spectrum) ? nullptr : backward_shaper[0].get(), backward_shaper[1].get(),
+                                                     backward_shaper[2].get(), backward_shaper[3].get()};
+    }
     //! \brief Return references to the executors in forward order.
     std::array<executor_base*, 3> forward_executors() const{
         return std::array<executor_base*, 3>{executors[0].get(), executors[1].get(), executors[2].get()};
@@ -347,26 +608,114 @@ private:
         return std::array<executor_base*, 3>{executors[2].get(), executors[1].get(), executors[0].get()};
     }
 
+    //! \brief Performs the transform, applies the callbacks and the scaling, same as in the fft3d case.
+    template<typename input_type, typename output_type, typename workspace_type>
+    void compute_and_scale(int const batch_size, input_type const input[], output_type output[], workspace_type workspace[],
+                           direction dir, scale scaling,
+                           transform_callbacks<input_type, output_type, index> const &callbacks = transform_callbacks<input_type, output_type, index>()) const{
+        thread_scope threads(options.num_threads);
+        std::array<reshape3d_base<index>*, 4> shapers = (dir == direction::forward) ? forward_shapers() : backward_shapers();
+        box3d<index> const load_box  = (dir == direction::forward) ? *pfirst : *pspectrum;
+        box3d<index> const store_box = (dir == direction::forward) ? *poutbox : *pinbox;
+        double const store_scale = (scaling == scale::none) ? 1.0 : get_scale_factor(scaling);
+
+        std::unique_ptr<reshape3d_base<index>> load_shaper, store_shaper;
+        if (callbacks.load){
+            load_shaper = std::unique_ptr<reshape3d_base<index>>(new reshape3d_callback<input_type, index>(shapers[0], load_box, callbacks.load));
+            shapers[0] = load_shaper.get();
+        }
+        // the unpack hooks can access the data only on the CPU
+        if (std::is_same<location_tag, tag::cpu>::value and shapers[3] != nullptr and (callbacks.store or scaling != scale::none)){
+            store_shaper = std::unique_ptr<reshape3d_base<index>>(
+                new reshape3d_callback<output_type, index>(shapers[3], store_box, callbacks.store, store_scale));
+            shapers[3] = store_shaper.get();
+        }
+
+        compute_transform<location_tag, index>(this->stream(), batch_size, input, output, workspace,
+                                               executor_buffer_offset, size_comm_buffers(), shapers,
+                                               (dir == direction::forward) ? forward_executors() : backward_executors(), dir, nullptr,
+                                               get_swap_buffer(batch_size, workspace));
+
+        if (not store_shaper){
+            if (callbacks.store){ // callback and scaling in one pass
+                reshape3d_callback<output_type, index>(nullptr, store_box, callbacks.store, store_scale).apply(batch_size, output, output, nullptr);
+            }else{
+                apply_scale(batch_size, dir, scaling, output);
+            }
+        }
+    }
+
+    //! \brief Creates a request for the transform in the given direction, same as in the fft3d case.
+    template<typename input_type, typename output_type, typename workspace_type>
+    fft_request make_request(int const batch_size, input_type const input[], output_type output[], workspace_type workspace[],
+                             std::shared_ptr<void> workspace_owner, direction dir, scale scaling) const{
+        transform_schedule schedule;
+        if (dir == direction::forward){
+            compute_transform<location_tag, index>(this->stream(), batch_size, input, output, workspace,
+                                                   executor_buffer_offset, size_comm_buffers(), forward_shapers(),
+                                                   forward_executors(), direction::forward, &schedule, get_swap_buffer(batch_size, workspace));
+        }else{
+            compute_transform<location_tag, index>(this->stream(), batch_size, input, output, workspace,
+                                                   executor_buffer_offset, size_comm_buffers(), backward_shapers(),
+                                                   backward_executors(), direction::backward, &schedule, get_swap_buffer(batch_size, workspace));
+        }
+        if (scaling != scale::none)
+            schedule.push_back([=](reshape_pending&)->void{ apply_scale(batch_size, dir, scaling, output); });
+        return fft_request(std::move(schedule), std::move(workspace_owner), options.num_threads);
+    }
+
+    //! \brief Returns the buffer that alternates with the internal temp buffer in the low-memory mode, nullptr otherwise.
+    template<typename workspace_type>
+    workspace_type* get_swap_buffer(int const batch_size, workspace_type workspace[]) const{
+        return (options.use_low_memory) ? workspace + batch_size * swap_buffer_offset : nullptr;
+    }
+
     //! \brief Applies the scaling factor to the data.
     template<typename scalar_type>
     void apply_scale(int const batch_size, direction dir, scale scaling, scalar_type data[]) const{
+        apply_scale(batch_size * ((dir == direction::forward) ? size_outbox() : size_inbox()), scaling, data);
+    }
+    //! \brief Applies the scaling factor to the given number of entries.
+    template<typename scalar_type>
+    void apply_scale(long long num_entries, scale scaling, scalar_type data[]) const{
         if (scaling != scale::none){
             add_trace name("scale");
             #ifdef Heffte_ENABLE_MAGMA
             if (std::is_same<location_tag, tag::gpu>::value){
-                hmagma.scal(batch_size * ((dir == direction::forward) ? size_outbox() : size_inbox()), get_scale_factor(scaling), data);
+                hmagma.scal(num_entries, get_scale_factor(scaling), data);
                 return;
             }
             #endif
-            data_scaling::apply(
-                this->stream(),
-                batch_size * ((dir == direction::forward) ? size_outbox() : size_inbox()),
-                data, get_scale_factor(scaling));
+            data_scaling::apply(this->stream(), num_entries, data, get_scale_factor(scaling));
         }
     }
 
+    //! \brief Implements convolve() and correlate(), same as in the fft3d case.
+    template<typename input_type, typename spectrum_type>
+    void spectral_product(input_type const x[], input_type const y[], input_type result[], spectrum_type workspace[],
+                          bool conjugate, scale scaling) const{
+        static_assert((std::is_same<input_type, float>::value and is_ccomplex<spectrum_type>::value)
+                   or (std::is_same<input_type, double>::value and is_zcomplex<spectrum_type>::value),
+                "Using either an unknown complex type or an incompatible pair of types!");
+
+        thread_scope threads(options.num_threads);
+        auto sworkspace = convert_to_standard(workspace);
+        auto xhat = sworkspace + size_workspace();
+        auto yhat = xhat + size_spectrum();
+        forward_spectrum(x, xhat, sworkspace);
+        forward_spectrum(y, yhat, sworkspace);
+        {
+            add_trace name("product");
+            data_scaling::multiply(this->stream(), size_spectrum(), xhat, yhat, conjugate,
+                                   (scaling == scale::none) ? 1.0 : get_scale_factor(scaling));
+        }
+        backward_spectrum(static_cast<typename std::remove_pointer<decltype(yhat)>::type const*>(yhat), result, sworkspace);
+    }
+
     std::unique_ptr<box3d<index>> pinbox, poutbox;
+    std::unique_ptr<box3d<index>> pfirst, pspectrum;
     double scale_factor;
+    plan_options options;
     std::array<std::unique_ptr<reshape3d_base<index>>, 4> forward_shaper;
     std::array<std::unique_ptr<reshape3d_base<index>>, 4> backward_shaper;
 
@@ -376,7 +725,9 @@ private:
     #endif
 
     // cache some values for faster read
-    size_t size_buffer_work, comm_buffer_offset, executor_buffer_offset;
+    size_t size_buffer_work, comm_buffer_offset, executor_buffer_offset, swap_buffer_offset;
+
+    std::shared_ptr<workspace_pool<location_tag>> pool;
 };
 
 /*!
@@ -401,6 +752,35 @@ fft3d_r2c<backend_tag, index> make_fft3d_r2c(box3d<index> const inbox, box3d<ind
     return fft3d_r2c<backend_tag, index>(inbox, outbox, r2c_direction, comm, options);
 }
 
+/*!
+ * \ingroup fft3d
+ * \brief Computes the analytical cost of an existing r2c plan, see heffte::estimate_plan_cost().
+ *
+ * Same as the heffte::fft3d variant, but requires the \b r2c_direction used to create the plan
+ * and the \b element_size is the size of the complex type.
+ */
+template<typename backend_tag, typename index>
+plan_cost estimate_plan_cost(fft3d_r2c<backend_tag, index> const &fft, int r2c_direction, MPI_Comm const comm,
+                             size_t element_size = sizeof(std::complex<double>)){
+    plan_cost cost = estimate_plan_cost(plan_operations(mpi::gather_boxes(fft.inbox(), fft.outbox(), comm), r2c_direction,
+                                                        fft.get_options(), mpi::comm_rank(comm)),
+                                        element_size, r2c_direction);
+    long long const workspace = static_cast<long long>(fft.size_workspace() * element_size);
+    MPI_Allgather(&workspace, 1, MPI_LONG_LONG, cost.workspace_bytes.data(), 1, MPI_LONG_LONG, comm);
+    cost.max_workspace_bytes = *std::max_element(cost.workspace_bytes.begin(), cost.workspace_bytes.end());
+    return cost;
+}
+
+/*!
+ * \ingroup fft3d
+ * \brief Saves the r2c plan to a file, see the heffte::fft3d variant, requires the \b r2c_direction used to create the plan.
+ */
+template<typename backend_tag, typename index>
+void save_plan(std::string const &filename, fft3d_r2c<backend_tag, index> const &fft, int r2c_direction, MPI_Comm const comm){
+    save_plan(filename, plan_operations(mpi::gather_boxes(fft.inbox(), fft.outbox(), comm), r2c_direction, fft.get_options(), mpi::comm_rank(comm)),
+              r2c_direction, comm);
+}
+
 }
 
 #endif
@@ -434,6 +434,93 @@ inline std::vector<box3d<index>> split_world(box3d<index> const world, std::arra
     }
 }
 
+/*!
+ * \ingroup fft3dgeometry
+ * \brief Describes the boxes created by heffte::split_world() without holding the list of boxes.
+ *
+ * The box of each rank and the ranks that overlap with a given box are computed analytically,
+ * which allows the plan logic to work with the regular grids in time proportional to the number
+ * of overlapping boxes, as opposed to scanning the boxes of all ranks.
+ */
+template<typename index>
+struct split_grid{
+    //! \brief The world box, also defines the order of all boxes.
+    box3d<index> world;
+    //! \brief Number of boxes in each dimension.
+    std::array<int, 3> proc_grid;
+
+    //! \brief Returns the number of boxes in the grid.
+    int count() const{ return proc_grid[0] * proc_grid[1] * proc_grid[2]; }
+    //! \brief Returns the first index of the i-th interval in the given dimension, uses the same split as heffte::split_world().
+    index split(int dimension, index i) const{
+        return world.low[dimension] + i * (world.size[dimension] / proc_grid[dimension])
+                + std::min(i, static_cast<index>(world.size[dimension] % proc_grid[dimension]));
+    }
+    //! \brief Returns the interval that contains the index in the given dimension, the index must be inside the world.
+    index interval(int dimension, index x) const{
+        index const q = world.size[dimension] / proc_grid[dimension];
+        index const r = world.size[dimension] % proc_grid[dimension];
+        index const offset = x - world.low[dimension];
+        return (offset < r * (q + 1)) ? offset / (q + 1) : r + (offset - r * (q + 1)) / q;
+    }
+    //! \brief Returns the box with the given rank, identical to split_world(world, proc_grid)[rank].
+    box3d<index> box(int rank) const{
+        std::array<index, 3> i = {rank % proc_grid[0], (rank / proc_grid[0]) % proc_grid[1], rank / (proc_grid[0] * proc_grid[1])};
+        return box3d<index>({split(0, i[0]), split(1, i[1]), split(2, i[2])},
+                            {split(0, i[0] + 1) - 1, split(1, i[1] + 1) - 1, split(2, i[2] + 1) - 1}, world.order);
+    }
+    /*!
+     * \brief Returns the range of intervals that overlap with the box in the given dimension.
+     *
+     * The result holds the first and last interval, the range is empty (first > last)
+     * if the box does not overlap with the world in this dimension.
+     */
+    std::array<index, 2> overlap(box3d<index> const &b, int dimension) const{
+        index const low  = std::max(b.low[dimension], world.low[dimension]);
+        index const high = std::min(b.high[dimension], world.high[dimension]);
+        if (low > high) return {1, 0};
+        return {interval(dimension, low), interval(dimension, high)};
+    }
+    //! \brief Returns the number of boxes in the grid that overlap with the given box.
+    long long count_overlaps(box3d<index> const &b) const{
+        long long result = 1;
+        for(int d=0; d<3; d++){
+            std::array<index, 2> range = overlap(b, d);
+            result *= std::max(static_cast<long long>(range[1] - range[0] + 1), 0LL);
+        }
+        return result;
+    }
+};
+
+/*!
+ * \ingroup fft3dgeometry
+ * \brief Checks whether the boxes are identical to the result of heffte::split_world() for some grid.
+ *
+ * \param boxes is a list of boxes, one per rank
+ *
+ * \returns a vector with the corresponding grid, if the boxes form a regular grid, or an empty vector otherwise;
+ *          the cost is linear in the number of boxes
+ */
+template<typename index>
+inline std::vector<split_grid<index>> find_split_grid(std::vector<box3d<index>> const &boxes){
+    if (boxes.empty()) return {};
+    for(auto const &b : boxes)
+        if (b.empty() or b.order != boxes.front().order) return {};
+    box3d<index> const bounds = find_world(boxes);
+    // the boxes in the first row/column/pillar of the grid start at the low corner in the other two dimensions
+    std::array<int, 3> proc_grid = {0, 0, 0};
+    for(auto const &b : boxes){
+        if (b.low[1] == bounds.low[1] and b.low[2] == bounds.low[2]) proc_grid[0]++;
+        if (b.low[0] == bounds.low[0] and b.low[2] == bounds.low[2]) proc_grid[1]++;
+        if (b.low[0] == bounds.low[0] and b.low[1] == bounds.low[1]) proc_grid[2]++;
+    }
+    split_grid<index> const grid = {box3d<index>(bounds.low, bounds.high, boxes.front().order), proc_grid};
+    if (static_cast<size_t>(grid.count()) != boxes.size()) return {};
+    for(size_t r=0; r<boxes.size(); r++)
+        if (boxes[r] != grid.box(static_cast<int>(r))) return {};
+    return {grid};
+}
+
 /*!
  * \ingroup fft3dgeometry
  * \brief Returns true if the shape forms pencils in the given direction.
@@ -522,6 +609,60 @@ inline std::vector<box3d<index>> maximize_overlap(std::vector<box3d<index>> cons
     return result;
 }
 
+/*!
+ * \ingroup fft3dgeometry
+ * \brief Overload of heffte::maximize_overlap() for new boxes that form a regular grid.
+ *
+ * Gives the same result as calling the general overload with split_world(grid.world, grid.proc_grid),
+ * but only the boxes that overlap with each of the old boxes are considered,
+ * which reduces the cost from quadratic to linear in the number of ranks (times the number of overlaps).
+ */
+template<typename index>
+inline std::vector<box3d<index>> maximize_overlap(split_grid<index> const &grid,
+                                                  std::vector<box3d<index>> const &old_boxes,
+                                                  std::array<int, 3> const order,
+                                                  rank_remap const &remap){
+    if (not remap.empty())
+        return maximize_overlap(split_world(grid.world, grid.proc_grid, remap), old_boxes, order, remap);
+
+    int const num_boxes = grid.count();
+    std::vector<box3d<index>> result;
+    result.reserve(num_boxes);
+    std::vector<bool> taken(num_boxes, false);
+    int first_free = 0; // all boxes before first_free are taken
+
+    for(size_t i=0; i<old_boxes.size(); i++){
+        // the general overload takes the first box with the largest overlap,
+        // if no overlapping box is available, the first box that is not taken has overlap 0
+        long long max_overlap = 0;
+        int max_index = -1;
+        std::array<std::array<index, 2>, 3> range = {grid.overlap(old_boxes[i], 0), grid.overlap(old_boxes[i], 1), grid.overlap(old_boxes[i], 2)};
+        for(index k=range[2][0]; k<=range[2][1]; k++){
+            for(index j=range[1][0]; j<=range[1][1]; j++){
+                for(index l=range[0][0]; l<=range[0][1]; l++){
+                    int const rank = static_cast<int>(l + grid.proc_grid[0] * (j + grid.proc_grid[1] * k));
+                    if (taken[rank]) continue;
+                    long long overlap = old_boxes[i].collide(grid.box(rank)).count();
+                    if (overlap > max_overlap){
+                        max_overlap = overlap;
+                        max_index = rank;
+                    }
+                }
+            }
+        }
+        if (max_index == -1){
+            while(taken[first_free]) first_free++;
+            max_index = first_free;
+        }
+        assert( max_index < num_boxes );
+        taken[max_index] = true;
+        box3d<index> const b = grid.box(max_index);
+        result.push_back(box3d<index>(b.low, b.high, order));
+    }
+
+    return result;
+}
+
 /*!
  * \ingroup fft3dgeometry
  * \brief Counts the number of point-to-point connections between the old and new box geometries.
@@ -543,6 +684,19 @@ inline long long count_connections(std::vector<box3d<index>> const &new_boxes, s
     return count;
 }
 
+/*!
+ * \ingroup fft3dgeometry
+ * \brief Overload of heffte::count_connections() that computes the overlaps with the grid analytically.
+ */
+template<typename index>
+inline long long count_connections(split_grid<index> const &grid, std::vector<box3d<index>> const &old_boxes){
+    long long count = 0;
+    for(auto &obox : old_boxes)
+        if (not obox.empty())
+            count += grid.count_overlaps(obox);
+    return count;
+}
+
 /*!
  * \ingroup fft3dgeometry
  * \brief Breaks the world into a grid of pencils and orders the pencils to the ranks that will minimize communication
@@ -578,15 +732,25 @@ inline std::vector<box3d<index>> make_pencils(box3d<index> const world,
 
     // create a list of boxes ordered in column major format (following the proc_grid box)
     // using two boxes corresponding to the two dimensions of proc-grid in both variants
-    std::vector<box3d<index>> pencilsA =
-        maximize_overlap(
-            split_world(world, make_procgrid2d(world, dimension, proc_grid), remap), source, order, remap);
+    if (not remap.empty()){
+        std::vector<box3d<index>> pencilsA =
+            maximize_overlap(
+                split_world(world, make_procgrid2d(world, dimension, proc_grid), remap), source, order, remap);
 
-    std::vector<box3d<index>> pencilsB =
-        maximize_overlap(
-            split_world(world, make_procgrid2d(world, dimension, std::array<int, 2>{proc_grid[1], proc_grid[0]}), remap), source, order, remap);
+        std::vector<box3d<index>> pencilsB =
+            maximize_overlap(
+                split_world(world, make_procgrid2d(world, dimension, std::array<int, 2>{proc_grid[1], proc_grid[0]}), remap), source, order, remap);
 
-    return (count_connections(pencilsB, source) < count_connections(pencilsA, source)) ? pencilsB : pencilsA;
+        return (count_connections(pencilsB, source) < count_connections(pencilsA, source)) ? pencilsB : pencilsA;
+    }
+
+    // the number of connections does not depend on the assignment of boxes to ranks,
+    // compare the two grids analytically and assign the boxes only for the selected grid
+    split_grid<index> const pencilsA = {world, make_procgrid2d(world, dimension, proc_grid)};
+    split_grid<index> const pencilsB = {world, make_procgrid2d(world, dimension, std::array<int, 2>{proc_grid[1], proc_grid[0]})};
+
+    return maximize_overlap((count_connections(pencilsB, source) < count_connections(pencilsA, source)) ? pencilsB : pencilsA,
+                            source, order, remap);
 }
 
 /*!
@@ -603,24 +767,24 @@ inline std::vector<box3d<index>> make_slabs(box3d<index> const world, int num_sl
                                             rank_remap const &remap
                                            ){
     assert( dimension1 != dimension2 );
-    std::vector<box3d<index>> slabs;
+    split_grid<index> slabs = {world, {1, 1, 1}};
     if (dimension1 == 0){
         if (dimension2 == 1){
-            slabs = split_world(world, {1, 1, num_slabs}, remap);
+            slabs.proc_grid = {1, 1, num_slabs};
         }else{
-            slabs = split_world(world, {1, num_slabs, 1}, remap);
+            slabs.proc_grid = {1, num_slabs, 1};
         }
     }else if (dimension1 == 1){
         if (dimension2 == 0){
-            slabs = split_world(world, {1, 1, num_slabs}, remap);
+            slabs.proc_grid = {1, 1, num_slabs};
         }else{
-            slabs = split_world(world, {num_slabs, 1, 1}, remap);
+            slabs.proc_grid = {num_slabs, 1, 1};
         }
     }else{ // third dimension
         if (dimension2 == 0){
-            slabs = split_world(world, {1, num_slabs, 1}, remap);
+            slabs.proc_grid = {1, num_slabs, 1};
         }else{
-            slabs = split_world(world, {num_slabs, 1, 1}, remap);
+            slabs.proc_grid = {num_slabs, 1, 1};
         }
     }
 
@@ -690,6 +854,67 @@ inline std::array<int, 3> proc_setup_min_surface(box3d<index> const world, int n
 }
 
 namespace mpi {
+/*!
+ * \ingroup hefftempi
+ * \brief Checks whether the input and output boxes across the comm form regular grids, see heffte::split_grid.
+ *
+ * Uses three reductions of a few integers, as opposed to gathering the boxes of all ranks.
+ * First, the world boxes are computed, then the size of the grids is inferred from the number
+ * of boxes that touch the low corner of the world, and finally each rank verifies that its boxes
+ * match the boxes of the grids.
+ *
+ * \returns a vector with the input and output grids, if both the inboxes and the outboxes are regular,
+ *          or an empty vector otherwise
+ */
+template<typename index>
+inline std::vector<split_grid<index>> find_split_grids(box3d<index> const my_inbox, box3d<index> const my_outbox, MPI_Comm const comm){
+    std::array<box3d<index> const*, 2> mine = {&my_inbox, &my_outbox};
+
+    // for each box: min of low and -high (i.e., max of high), min/max of the order and 0/1 for empty/non-empty
+    std::array<long long, 26> extent;
+    for(int b=0; b<2; b++){
+        for(int d=0; d<3; d++){
+            extent[13 * b + d]     = mine[b]->low[d];
+            extent[13 * b + 3 + d] = -static_cast<long long>(mine[b]->high[d]);
+            extent[13 * b + 6 + d] = mine[b]->order[d];
+            extent[13 * b + 9 + d] = -static_cast<long long>(mine[b]->order[d]);
+        }
+        extent[13 * b + 12] = (mine[b]->empty()) ? 0 : 1;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, extent.data(), 26, MPI_LONG_LONG, MPI_MIN, comm);
+    for(int b=0; b<2; b++){
+        if (extent[13 * b + 12] == 0) return {};
+        for(int d=0; d<3; d++)
+            if (extent[13 * b + 6 + d] != -extent[13 * b + 9 + d]) return {}; // different orders
+    }
+    auto world = [&](int b)->box3d<index>{
+        return box3d<index>({static_cast<index>(extent[13 * b]), static_cast<index>(extent[13 * b + 1]), static_cast<index>(extent[13 * b + 2])},
+                            {static_cast<index>(-extent[13 * b + 3]), static_cast<index>(-extent[13 * b + 4]), static_cast<index>(-extent[13 * b + 5])},
+                            mine[b]->order);
+    };
+
+    std::array<int, 6> counts;
+    for(int b=0; b<2; b++){
+        box3d<index> const w = world(b);
+        counts[3 * b + 0] = (mine[b]->low[1] == w.low[1] and mine[b]->low[2] == w.low[2]) ? 1 : 0;
+        counts[3 * b + 1] = (mine[b]->low[0] == w.low[0] and mine[b]->low[2] == w.low[2]) ? 1 : 0;
+        counts[3 * b + 2] = (mine[b]->low[0] == w.low[0] and mine[b]->low[1] == w.low[1]) ? 1 : 0;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, counts.data(), 6, MPI_INT, MPI_SUM, comm);
+
+    int const me = comm_rank(comm);
+    int const num_ranks = comm_size(comm);
+    std::vector<split_grid<index>> grids;
+    int regular = 1;
+    for(int b=0; b<2; b++){
+        grids.push_back(split_grid<index>{world(b), {counts[3 * b], counts[3 * b + 1], counts[3 * b + 2]}});
+        if (grids.back().count() != num_ranks or *mine[b] != grids.back().box(me))
+            regular = 0;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &regular, 1, MPI_INT, MPI_MIN, comm);
+    return (regular == 1) ? grids : std::vector<split_grid<index>>();
+}
+
 /*!
  * \ingroup hefftempi
  * \brief Gather all boxes across all ranks in the comm.
@@ -701,10 +926,15 @@ namespace mpi {
  *
  * \returns an \b ioboxes struct that holds all boxes across all ranks in the comm
  *
- * Uses MPI_Allgather().
+ * If the boxes form regular grids (see heffte::mpi::find_split_grids()), the boxes are
+ * computed locally with heffte::split_world(), otherwise uses MPI_Allgather().
  */
 template<typename index>
 inline ioboxes<index> gather_boxes(box3d<index> const my_inbox, box3d<index> const my_outbox, MPI_Comm const comm){
+    std::vector<split_grid<index>> grids = find_split_grids(my_inbox, my_outbox, comm);
+    if (not grids.empty())
+        return {split_world(grids[0].world, grids[0].proc_grid), split_world(grids[1].world, grids[1].proc_grid)};
+
     std::array<box3d<index>, 2> my_data = {my_inbox, my_outbox};
     std::vector<box3d<index>> all_boxes(2 * mpi::comm_size(comm), box3d<index>({0, 0, 0}, {0, 0, 0}));
     MPI_Allgather(&my_data, 2 * sizeof(box3d<index>), MPI_BYTE, all_boxes.data(), 2 * sizeof(box3d<index>), MPI_BYTE, comm);
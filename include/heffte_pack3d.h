@@ -9,6 +9,10 @@
 
 #include "heffte_common.h"
 
+#ifdef Heffte_ENABLE_AVX
+#include <immintrin.h>
+#endif
+
 /*!
  * \ingroup fft3d
  * \addtogroup hefftepacking Packing/Unpacking operations
@@ -64,6 +68,233 @@ inline std::ostream & operator << (std::ostream &os, pack_plan_3d<index> const &
     return os;
 }
 
+/*!
+ * \ingroup hefftepacking
+ * \brief Contains the CPU kernels that perform the data movement in the packers.
+ *
+ * The kernels are multi-threaded with OpenMP (if enabled in the build) and the
+ * transpose kernels work on cache blocks subdivided into small tiles that are transposed
+ * in registers, using AVX intrinsics if enabled.
+ * The helpers that decide the use of threads are in heffte_threads.h.
+ */
+namespace pack_kernels {
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Size of the cache blocks used in the transpose kernels.
+ *
+ * The source and destination block together take at most 16KB, which is half of a typical L1 cache,
+ * the rest of the L1 is left for the hardware prefetching of the next block of the line.
+ */
+template<typename scalar_type>
+struct transpose_block_size{
+    //! \brief The edge of the square block measured in number of entries.
+    static constexpr int size = (sizeof(scalar_type) <= 8) ? 32 : 16;
+};
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Transposes a small tile of entries, the specializations will use registers to hold the entire tile.
+ *
+ * Sets dst[i * dst_stride + j] = src[j * src_stride + i] for all i and j from 0 to size - 1.
+ */
+template<typename scalar_type>
+struct register_tile{
+    //! \brief The edge of the square tile measured in number of entries.
+    static constexpr int size = 4;
+    //! \brief Transpose the tile.
+    template<typename index>
+    static void apply(scalar_type const src[], index src_stride, scalar_type dst[], index dst_stride){
+        for(int i=0; i<size; i++)
+            for(int j=0; j<size; j++)
+                dst[i * dst_stride + j] = src[j * src_stride + i];
+    }
+};
+
+#ifdef Heffte_ENABLE_AVX
+/*!
+ * \ingroup hefftepacking
+ * \brief Transposes a 4 by 4 tile of single precision numbers using SSE registers.
+ */
+template<> struct register_tile<float>{
+    //! \brief The edge of the square tile measured in number of entries.
+    static constexpr int size = 4;
+    //! \brief Transpose the tile.
+    template<typename index>
+    static void apply(float const src[], index src_stride, float dst[], index dst_stride){
+        __m128 r0 = _mm_loadu_ps(src);
+        __m128 r1 = _mm_loadu_ps(src + src_stride);
+        __m128 r2 = _mm_loadu_ps(src + 2 * src_stride);
+        __m128 r3 = _mm_loadu_ps(src + 3 * src_stride);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(dst, r0);
+        _mm_storeu_ps(dst + dst_stride, r1);
+        _mm_storeu_ps(dst + 2 * dst_stride, r2);
+        _mm_storeu_ps(dst + 3 * dst_stride, r3);
+    }
+};
+/*!
+ * \ingroup hefftepacking
+ * \brief Transposes a 4 by 4 tile of 64-bit numbers using AVX registers, used for double and std::complex<float>.
+ */
+struct register_tile_avx64{
+    //! \brief The edge of the square tile measured in number of entries.
+    static constexpr int size = 4;
+    //! \brief Transpose the tile, the 64-bit entries are moved as doubles.
+    template<typename scalar_type, typename index>
+    static void apply(scalar_type const src[], index src_stride, scalar_type dst[], index dst_stride){
+        static_assert(sizeof(scalar_type) == sizeof(double), "register_tile_avx64 works only with 64-bit types");
+        double const *s = reinterpret_cast<double const*>(src);
+        double *d = reinterpret_cast<double*>(dst);
+        __m256d r0 = _mm256_loadu_pd(s);
+        __m256d r1 = _mm256_loadu_pd(s + src_stride);
+        __m256d r2 = _mm256_loadu_pd(s + 2 * src_stride);
+        __m256d r3 = _mm256_loadu_pd(s + 3 * src_stride);
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+        _mm256_storeu_pd(d,                  _mm256_permute2f128_pd(t0, t2, 0x20));
+        _mm256_storeu_pd(d + dst_stride,     _mm256_permute2f128_pd(t1, t3, 0x20));
+        _mm256_storeu_pd(d + 2 * dst_stride, _mm256_permute2f128_pd(t0, t2, 0x31));
+        _mm256_storeu_pd(d + 3 * dst_stride, _mm256_permute2f128_pd(t1, t3, 0x31));
+    }
+};
+/*!
+ * \ingroup hefftepacking
+ * \brief Specialization for double precision.
+ */
+template<> struct register_tile<double> : register_tile_avx64{};
+/*!
+ * \ingroup hefftepacking
+ * \brief Specialization for single precision complex numbers.
+ */
+template<> struct register_tile<std::complex<float>> : register_tile_avx64{};
+/*!
+ * \ingroup hefftepacking
+ * \brief Transposes a 2 by 2 tile of double precision complex numbers using AVX registers.
+ */
+template<> struct register_tile<std::complex<double>>{
+    //! \brief The edge of the square tile measured in number of entries.
+    static constexpr int size = 2;
+    //! \brief Transpose the tile.
+    template<typename index>
+    static void apply(std::complex<double> const src[], index src_stride, std::complex<double> dst[], index dst_stride){
+        __m256d r0 = _mm256_loadu_pd(reinterpret_cast<double const*>(src));
+        __m256d r1 = _mm256_loadu_pd(reinterpret_cast<double const*>(src + src_stride));
+        _mm256_storeu_pd(reinterpret_cast<double*>(dst), _mm256_permute2f128_pd(r0, r1, 0x20));
+        _mm256_storeu_pd(reinterpret_cast<double*>(dst + dst_stride), _mm256_permute2f128_pd(r0, r1, 0x31));
+    }
+};
+#endif
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Transposes a tile where each row spans a full 64-byte cache line, using multiple register tiles.
+ *
+ * Every line of the source and destination that is touched by the tile is used entirely,
+ * thus the tiles do not rely on cache reuse between each other.
+ */
+template<typename scalar_type>
+struct transpose_tile{
+    //! \brief The number of register tiles in each direction.
+    static constexpr int num_register_tiles = (64 / static_cast<int>(sizeof(scalar_type)) > register_tile<scalar_type>::size) ?
+                                              64 / static_cast<int>(sizeof(scalar_type)) / register_tile<scalar_type>::size : 1;
+    //! \brief The edge of the square tile measured in number of entries.
+    static constexpr int size = num_register_tiles * register_tile<scalar_type>::size;
+    //! \brief Transpose the tile.
+    template<typename index>
+    static void apply(scalar_type const src[], index src_stride, scalar_type dst[], index dst_stride){
+        constexpr index rsize = register_tile<scalar_type>::size;
+        for(index j=0; j<size; j+=rsize) // consume each source line before moving to the next rows
+            for(index i=0; i<size; i+=rsize)
+                register_tile<scalar_type>::apply(&src[j * src_stride + i], src_stride, &dst[i * dst_stride + j], dst_stride);
+    }
+};
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Copies \b num_planes by \b num_lines lines with \b line_size entries each.
+ *
+ * The lines are distributed across the threads.
+ */
+template<typename scalar_type, typename index>
+void copy_lines(index num_planes, index num_lines, index line_size,
+                scalar_type const src[], index src_plane_stride, index src_line_stride,
+                scalar_type dst[], index dst_plane_stride, index dst_line_stride){
+    index const total = num_planes * num_lines;
+    #ifdef Heffte_ENABLE_OPENMP
+    #pragma omp parallel for schedule(static) if(use_threads(static_cast<long long>(total) * line_size))
+    #endif
+    for(index t = 0; t < total; t++){
+        index const plane = t / num_lines;
+        index const line  = t % num_lines;
+        std::copy_n(&src[plane * src_plane_stride + line * src_line_stride], line_size,
+                    &dst[plane * dst_plane_stride + line * dst_line_stride]);
+    }
+}
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Transposes a single block of a two dimensional array.
+ *
+ * Sets dst[r * dst_stride + c] = src[c * src_stride + r] for all row_begin <= r < row_end and col_begin <= c < col_end.
+ * The block is split into register tiles and the remainder is handled with scalar loops.
+ */
+template<typename scalar_type, typename index>
+void transpose_block(index row_begin, index row_end, index col_begin, index col_end,
+                     scalar_type const src[], index src_stride, scalar_type dst[], index dst_stride){
+    constexpr index tile = transpose_tile<scalar_type>::size;
+    index const row_tiles_end = row_begin + ((row_end - row_begin) / tile) * tile;
+    index const col_tiles_end = col_begin + ((col_end - col_begin) / tile) * tile;
+    for(index c = col_begin; c < col_tiles_end; c += tile)
+        for(index r = row_begin; r < row_tiles_end; r += tile)
+            transpose_tile<scalar_type>::apply(&src[c * src_stride + r], src_stride, &dst[r * dst_stride + c], dst_stride);
+    for(index r = row_begin; r < row_tiles_end; r++)
+        for(index c = col_tiles_end; c < col_end; c++)
+            dst[r * dst_stride + c] = src[c * src_stride + r];
+    for(index r = row_tiles_end; r < row_end; r++)
+        for(index c = col_begin; c < col_end; c++)
+            dst[r * dst_stride + c] = src[c * src_stride + r];
+}
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Applies a two dimensional transpose to each of \b num_planes planes.
+ *
+ * For each plane p, sets dst[p * dst_plane_stride + r * dst_stride + c] = src[p * src_plane_stride + c * src_stride + r]
+ * for all r < num_rows and c < num_cols.
+ * The work is split into cache blocks that are distributed across the threads.
+ * If the plane strides are smaller than the row and column strides (e.g., when reversing the order of the three indexes),
+ * then the plane index moves fastest, i.e., the same block is processed for consecutive planes
+ * which keeps the working set within the same memory pages and reduces the TLB misses.
+ * Otherwise, each plane is processed block-by-block before moving to the next plane.
+ */
+template<typename scalar_type, typename index>
+void transpose_planes(index num_planes, index num_rows, index num_cols,
+                      scalar_type const src[], index src_plane_stride, index src_stride,
+                      scalar_type dst[], index dst_plane_stride, index dst_stride){
+    constexpr index block = transpose_block_size<scalar_type>::size;
+    index const row_blocks = (num_rows + block - 1) / block;
+    index const col_blocks = (num_cols + block - 1) / block;
+    index const total = row_blocks * col_blocks * num_planes;
+    bool const planes_inner = (src_plane_stride < src_stride and dst_plane_stride < dst_stride);
+    #ifdef Heffte_ENABLE_OPENMP
+    #pragma omp parallel for schedule(static) if(use_threads(static_cast<long long>(num_planes) * num_rows * num_cols))
+    #endif
+    for(index t = 0; t < total; t++){
+        index const plane = (planes_inner) ? t % num_planes : t / (row_blocks * col_blocks);
+        index const iblock = (planes_inner) ? t / num_planes : t % (row_blocks * col_blocks);
+        index const row_begin = (iblock / col_blocks) * block;
+        index const col_begin = (iblock % col_blocks) * block;
+        transpose_block(row_begin, (row_begin + block < num_rows) ? row_begin + block : num_rows,
+                        col_begin, (col_begin + block < num_cols) ? col_begin + block : num_cols,
+                        &src[plane * src_plane_stride], src_stride, &dst[plane * dst_plane_stride], dst_stride);
+    }
+}
+
+}
+
 /*!
  * \ingroup hefftepacking
  * \brief The packer needs to know whether the data will be on the CPU or GPU devices.
@@ -90,22 +321,16 @@ template<> struct direct_packer<tag::cpu>{
     //! \brief Execute the planned pack operation.
     template<typename scalar_type, typename index>
     void pack(void*, pack_plan_3d<index> const &plan, scalar_type const data[], scalar_type buffer[]) const{
-        scalar_type* buffer_iterator = buffer;
-        for(index slow = 0; slow < plan.size[2]; slow++){
-            for(index mid = 0; mid < plan.size[1]; mid++){
-                buffer_iterator = std::copy_n(&data[slow * plan.plane_stride + mid * plan.line_stride], plan.size[0], buffer_iterator);
-            }
-        }
+        pack_kernels::copy_lines(plan.size[2], plan.size[1], plan.size[0],
+                                 data, plan.plane_stride, plan.line_stride,
+                                 buffer, plan.size[1] * plan.size[0], plan.size[0]);
     }
     //! \brief Execute the planned unpack operation.
     template<typename scalar_type, typename index>
     void unpack(void*, pack_plan_3d<index> const &plan, scalar_type const buffer[], scalar_type data[]) const{
-        for(index slow = 0; slow < plan.size[2]; slow++){
-            for(index mid = 0; mid < plan.size[1]; mid++){
-                std::copy_n(&buffer[(slow * plan.size[1] + mid) * plan.size[0]],
-                            plan.size[0], &data[slow * plan.plane_stride + mid * plan.line_stride]);
-            }
-        }
+        pack_kernels::copy_lines(plan.size[2], plan.size[1], plan.size[0],
+                                 buffer, plan.size[1] * plan.size[0], plan.size[0],
+                                 data, plan.plane_stride, plan.line_stride);
     }
 };
 
@@ -129,70 +354,50 @@ template<> struct transpose_packer<tag::cpu>{
      * \brief Execute the planned unpack operation.
      *
      * Note that this will transpose the data in the process.
-     * The transpose is done in blocks to maximize cache reuse.
+     * The entry data[i * plane_stride + j * line_stride + k] is taken from the buffer with the indexes
+     * permuted according to the map. If the fast index k stays fast, the operation is a copy of lines,
+     * otherwise each of the plane is a two dimensional transpose done in cache blocks and register tiles,
+     * see heffte::pack_kernels::transpose_planes().
      */
     template<typename scalar_type, typename index>
     void unpack(void*, pack_plan_3d<index> const &plan, scalar_type const buffer[], scalar_type data[]) const{
-        constexpr index stride = 256 / sizeof(scalar_type);
         if (plan.map[0] == 0 and plan.map[1] == 1){
-            for(index i=0; i<plan.size[2]; i++)
-                for(index j=0; j<plan.size[1]; j++)
-                    for(index k=0; k<plan.size[0]; k++)
-                        data[i * plan.plane_stride + j * plan.line_stride + k]
-                            = buffer[ i * plan.buff_plane_stride + j * plan.buff_line_stride + k ];
+            // buffer[i * buff_plane_stride + j * buff_line_stride + k]
+            pack_kernels::copy_lines(plan.size[2], plan.size[1], plan.size[0],
+                                     buffer, plan.buff_plane_stride, plan.buff_line_stride,
+                                     data, plan.plane_stride, plan.line_stride);
 
         }else if (plan.map[0] == 0 and plan.map[1] == 2){
-            for(index bi=0; bi<plan.size[2]; bi+=stride)
-                for(index bj=0; bj<plan.size[1]; bj+=stride)
-                    for(index bk=0; bk<plan.size[0]; bk+=stride)
-                        for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
-                            for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
-                                for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
-                                    data[i * plan.plane_stride + j * plan.line_stride + k]
-                                        = buffer[ j * plan.buff_plane_stride + i * plan.buff_line_stride + k ];
+            // buffer[j * buff_plane_stride + i * buff_line_stride + k]
+            pack_kernels::copy_lines(plan.size[2], plan.size[1], plan.size[0],
+                                     buffer, plan.buff_line_stride, plan.buff_plane_stride,
+                                     data, plan.plane_stride, plan.line_stride);
 
         }else if (plan.map[0] == 1 and plan.map[1] == 0){
-            for(index bi=0; bi<plan.size[2]; bi+=stride)
-                for(index bj=0; bj<plan.size[1]; bj+=stride)
-                    for(index bk=0; bk<plan.size[0]; bk+=stride)
-                        for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
-                            for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
-                                for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
-                                    data[i * plan.plane_stride + j * plan.line_stride + k]
-                                        = buffer[ i * plan.buff_plane_stride + k * plan.buff_line_stride + j ];
+            // buffer[i * buff_plane_stride + k * buff_line_stride + j]
+            pack_kernels::transpose_planes(plan.size[2], plan.size[1], plan.size[0],
+                                           buffer, plan.buff_plane_stride, plan.buff_line_stride,
+                                           data, plan.plane_stride, plan.line_stride);
 
         }else if (plan.map[0] == 1 and plan.map[1] == 2){
-            for(index bi=0; bi<plan.size[2]; bi+=stride)
-                for(index bj=0; bj<plan.size[1]; bj+=stride)
-                    for(index bk=0; bk<plan.size[0]; bk+=stride)
-                        for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
-                            for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
-                                for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
-                                    data[i * plan.plane_stride + j * plan.line_stride + k]
-                                        = buffer[ k * plan.buff_plane_stride + i * plan.buff_line_stride + j ];
+            // buffer[k * buff_plane_stride + i * buff_line_stride + j]
+            pack_kernels::transpose_planes(plan.size[2], plan.size[1], plan.size[0],
+                                           buffer, plan.buff_line_stride, plan.buff_plane_stride,
+                                           data, plan.plane_stride, plan.line_stride);
 
         }else if (plan.map[0] == 2 and plan.map[1] == 0){
-            for(index bi=0; bi<plan.size[2]; bi+=stride)
-                for(index bj=0; bj<plan.size[1]; bj+=stride)
-                    for(index bk=0; bk<plan.size[0]; bk+=stride)
-                        for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
-                            for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
-                                for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
-                                    data[i * plan.plane_stride + j * plan.line_stride + k]
-                                        = buffer[ j * plan.buff_plane_stride + k * plan.buff_line_stride + i ];
+            // buffer[j * buff_plane_stride + k * buff_line_stride + i]
+            pack_kernels::transpose_planes(plan.size[1], plan.size[2], plan.size[0],
+                                           buffer, plan.buff_plane_stride, plan.buff_line_stride,
+                                           data, plan.line_stride, plan.plane_stride);
 
         }else{ // if (plan.map[0] == 2 and plan.map[1] == 1){
-            for(index bi=0; bi<plan.size[2]; bi+=stride)
-                for(index bj=0; bj<plan.size[1]; bj+=stride)
-                    for(index bk=0; bk<plan.size[0]; bk+=stride)
-                        for(index i=bi; i<std::min(bi + stride, plan.size[2]); i++)
-                            for(index j=bj; j<std::min(bj + stride, plan.size[1]); j++)
-                                for(index k=bk; k<std::min(bk + stride, plan.size[0]); k++)
-                                    data[i * plan.plane_stride + j * plan.line_stride + k]
-                                        = buffer[ k * plan.buff_plane_stride + j * plan.buff_line_stride + i ];
+            // buffer[k * buff_plane_stride + j * buff_line_stride + i]
+            pack_kernels::transpose_planes(plan.size[1], plan.size[2], plan.size[0],
+                                           buffer, plan.buff_line_stride, plan.buff_plane_stride,
+                                           data, plan.line_stride, plan.plane_stride);
 
         }
-
     }
 };
 
@@ -207,6 +412,9 @@ namespace data_scaling {
      */
     template<typename scalar_type, typename index>
     void apply(void*, index num_entries, scalar_type *data, double scale_factor){;
+        #ifdef Heffte_ENABLE_OPENMP
+        #pragma omp parallel for schedule(static) if(pack_kernels::use_threads(static_cast<long long>(num_entries)))
+        #endif
         for(index i=0; i<num_entries; i++) data[i] *= scale_factor;
     }
     /*!
@@ -230,6 +438,30 @@ namespace data_scaling {
     void apply(index num_entries, scalar_type *data, double scale_factor){
         apply(nullptr, num_entries, data, scale_factor);
     }
+    /*!
+     * \ingroup hefftepacking
+     * \brief Pointwise product of two complex arrays, y = scale_factor * x * y or y = scale_factor * conj(x) * y.
+     *
+     * Used by the convolution and correlation methods, the product uses real arithmetic for the same reasons
+     * as the complex scaling.
+     */
+    template<typename precision_type, typename index>
+    void multiply(void*, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                  bool conjugate, double scale_factor){
+        precision_type const *px = reinterpret_cast<precision_type const*>(x);
+        precision_type *py = reinterpret_cast<precision_type*>(y);
+        precision_type const sign  = (conjugate) ? -1.0 : 1.0;
+        precision_type const alpha = static_cast<precision_type>(scale_factor);
+        #ifdef Heffte_ENABLE_OPENMP
+        #pragma omp parallel for schedule(static) if(pack_kernels::use_threads(2 * static_cast<long long>(num_entries)))
+        #endif
+        for(index i=0; i<num_entries; i++){
+            precision_type const xr = alpha * px[2*i], xi = sign * alpha * px[2*i+1];
+            precision_type const yr = py[2*i], yi = py[2*i+1];
+            py[2*i]   = xr * yr - xi * yi;
+            py[2*i+1] = xr * yi + xi * yr;
+        }
+    }
 }
 
 }
@@ -31,8 +31,8 @@ namespace heffte {
  * although the specific cutoff point is dependent on the backend (and the version of the backend),
  * the version of MPI, the machine interconnect, and the specific optimizations that have been implemented in MPI.
  *
- * There is a plan of adding an auto-tuning framework in heFFTe to help users select the best
- * possible set of options; however, currently the users have to manually find the best option for their hardware.
+ * The best option can be selected by timing all candidates at plan time, see plan_options::use_autotune;
+ * otherwise, the users have to manually find the best option for their hardware.
  * The expected "best" algorithm is:
  * \code
  *      reshape_algorithm::alltoallv          : for larger FFT, many MPI ranks
@@ -56,6 +56,51 @@ enum class reshape_algorithm{
     p2p = 2
 };
 
+/*!
+ * \ingroup fft3d
+ * \brief Defines how the processor grid and the pencil/slab decomposition are selected.
+ *
+ * See plan_options::grid_search for details.
+ */
+enum class grid_selection{
+    //! \brief Use the grid with minimum surface area and the plan_options::use_pencils option (default option).
+    heuristic,
+    //! \brief Use the grid and decomposition with the lowest communication cost estimated by heffte::comm_cost_model.
+    model,
+    //! \brief Time the candidates with the lowest estimated cost and use the fastest one.
+    measured
+};
+
+/*!
+ * \ingroup fft3d
+ * \brief Defines the 1-D transform applied in one direction of a heffte::fft3d_mixed plan.
+ *
+ * The sine and cosine transforms use the same definitions as the corresponding backends,
+ * e.g., transform_kind::dct2 uses the same transform as heffte::backend::fftw_cos.
+ */
+enum class transform_kind{
+    //! \brief Complex Fourier transform, applied after the real-to-complex transform.
+    fft,
+    //! \brief Real-to-complex Fourier transform, the output is shortened to the unique (non-conjugate) coefficients.
+    fft_r2c,
+    //! \brief Discrete Cosine Transform type I.
+    dct1,
+    //! \brief Discrete Cosine Transform type II (the backward transform uses type III).
+    dct2,
+    //! \brief Discrete Sine Transform type I.
+    dst1,
+    //! \brief Discrete Sine Transform type II (the backward transform uses type III).
+    dst2
+};
+
+/*!
+ * \ingroup fft3d
+ * \brief Returns true if the kind is a real-to-real transform, i.e., one of the sine or cosine transforms.
+ */
+inline bool is_real_kind(transform_kind kind){
+    return (kind != transform_kind::fft and kind != transform_kind::fft_r2c);
+}
+
 /*!
  * \ingroup fft3d
  * \brief Defines a set of tweaks and options to use in the plan generation.
@@ -97,6 +142,38 @@ enum class reshape_algorithm{
  * the calls from the CPU (e.g., setting use_gpu_aware to false) can be faster
  * when using smaller problems compared to the number of MPI ranks.
  *
+ * \par Option use_autotune
+ * If set to true, the constructors of heffte::fft3d and heffte::fft3d_r2c will ignore the
+ * \b algorithm and \b use_reorder options and will instead time a forward and backward transform
+ * for each combination of the two options, the fastest combination is used to build the plan.
+ * The timing is agreed across all ranks, i.e., all ranks will select the same options.
+ * Autotuning increases the time to construct the plan and the selected options can be read with
+ * the get_options() method of the plan, then pinned in future runs so the tuning is done only once.
+ *
+ * \par Option grid_search or use_proc_grid
+ * By default, the intermediate pencils use the 2D processor grid with the smallest surface area
+ * and the decomposition is selected by use_pencils.
+ * The heuristic ignores the network and the boundaries between the nodes,
+ * which can result in noticeable slowdown when using thousands of MPI ranks.
+ * Setting grid_search to grid_selection::model will consider all 2D grids with both pencils and slabs,
+ * and will select the candidate with the lowest cost estimated from the overlap of the boxes
+ * and the node of each rank, see heffte::comm_cost_model.
+ * Setting grid_search to grid_selection::measured will time the three candidates with lowest estimated cost
+ * and will use the fastest one.
+ * The selected grid and decomposition are reported by the get_options() method of the plan
+ * and can be pinned in future runs with use_proc_grid() and use_pencils.
+ *
+ * \par Option num_threads
+ * Sets the number of OpenMP threads used by the CPU stages of the transform, i.e., the packing and unpacking,
+ * the 1-D transforms of the stock backend, the copies and the scaling, see \ref hefftethreads.
+ * Using fewer MPI ranks per node with multiple threads per rank reduces the number of messages in the reshapes.
+ *
+ * \par Option use_progress_thread
+ * Uses a helper thread that makes progress on the MPI messages of the reshapes while the main thread
+ * packs the data and computes the 1-D transforms, see \ref heffteprogress.
+ * The helper is useful with MPI implementations that do not progress the non-blocking communication
+ * in the background, combined with reshape_algorithm::p2p_plined or the asynchronous transforms.
+ *
  * \par Option use_subcomm or use_num_subranks
  * Restricts the intermediate reshape and FFT operations to a subset of the ranks
  * specified by the communicator given in the construction of heffte::fft3d and heffte::fft3d_r2c.
@@ -135,12 +212,21 @@ struct plan_options{
           algorithm(reshape_algorithm::alltoallv),
           use_pencils(true),
           use_gpu_aware(true),
+          use_autotune(false),
+          grid_search(grid_selection::heuristic),
+          use_low_memory(false),
+          use_2d_planner(true),
+          num_threads(0),
+          use_progress_thread(false),
           num_sub(-1),
-          subcomm(MPI_COMM_NULL)
+          subcomm(MPI_COMM_NULL),
+          proc_grid({0, 0})
     {}
     //! \brief Constructor, initializes each variable, primarily for internal use.
     plan_options(bool reorder, reshape_algorithm alg, bool pencils)
-        : use_reorder(reorder), algorithm(alg), use_pencils(pencils), use_gpu_aware(true), num_sub(-1), subcomm(MPI_COMM_NULL)
+        : use_reorder(reorder), algorithm(alg), use_pencils(pencils), use_gpu_aware(true), use_autotune(false),
+          grid_search(grid_selection::heuristic), use_low_memory(false), use_2d_planner(true), num_threads(0),
+          use_progress_thread(false), num_sub(-1), subcomm(MPI_COMM_NULL), proc_grid({0, 0})
     {}
     //! \brief Defines whether to transpose the data on reshape or to use strided 1-D ffts.
     bool use_reorder;
@@ -150,6 +236,47 @@ struct plan_options{
     bool use_pencils;
     //! \brief Defines whether to use MPI calls directly from the GPU or to move to the CPU first.
     bool use_gpu_aware;
+    //! \brief Defines whether to select the algorithm and reorder options by timing all candidates.
+    bool use_autotune;
+    //! \brief Defines how to select the processor grid and the pencil/slab decomposition.
+    grid_selection grid_search;
+    /*!
+     * \brief Defines whether to trade speed for a smaller workspace, see heffte::fft3d::size_workspace().
+     *
+     * The reshapes exchange the data with one rank at a time using buffers sized for the largest message,
+     * instead of buffers that hold all the data sent and received by the rank,
+     * and the intermediate stages of the transform alternate between the output array and a single
+     * internal buffer, i.e., the reshapes are never performed in-place.
+     * The point-to-point exchange replaces the reshape algorithm selected by plan_options::algorithm.
+     */
+    bool use_low_memory;
+    /*!
+     * \brief Defines whether two dimensional problems use the dedicated 2D planner.
+     *
+     * If the world box has exactly one direction of size one and the number of ranks does not exceed
+     * the size of the other two directions, the data is arranged in slabs along the first direction,
+     * transposed into slabs along the second direction and then moved to the output boxes.
+     * The reshapes that would only move the data across the direction of size one are skipped,
+     * e.g., slabs in the input and transposed slabs in the output require a single reshape.
+     * If disabled, or if the problem does not qualify, the 3D plan logic is used,
+     * i.e., plan_options::use_pencils and the processor grid apply.
+     */
+    bool use_2d_planner;
+    /*!
+     * \brief Defines the number of OpenMP threads used by the CPU stages of the transforms, see \ref hefftethreads.
+     *
+     * The threads are set for the duration of each transform and the default 0 uses the OpenMP default,
+     * e.g., the OMP_NUM_THREADS environment variable.
+     * The option is ignored if heFFTe is built without OpenMP.
+     */
+    int num_threads;
+    /*!
+     * \brief Defines whether a helper thread makes progress on the communication, see \ref heffteprogress.
+     *
+     * The option is checked when the plan is created, the helper requires MPI initialized with MPI_THREAD_MULTIPLE
+     * and the constructor of the plan throws std::runtime_error otherwise.
+     */
+    bool use_progress_thread;
     //! \brief Defines the number of ranks to use for the internal reshapes, set to -1 to use all ranks.
     void use_num_subranks(int num_subranks){ num_sub = num_subranks; }
     /*!
@@ -170,9 +297,19 @@ struct plan_options{
     }
     //! \brief Return the set number of sub-ranks.
     int get_subranks() const{ return num_sub; }
+    /*!
+     * \brief Set the 2D processor grid to use for the intermediate pencils.
+     *
+     * The product grid[0] * grid[1] must be equal to the number of ranks used in the intermediate reshapes.
+     * Using {0, 0} restores the default heuristic (minimum surface area).
+     */
+    void use_proc_grid(std::array<int, 2> const grid){ proc_grid = grid; }
+    //! \brief Return the set processor grid, {0, 0} indicates the default.
+    std::array<int, 2> get_proc_grid() const{ return proc_grid; }
 private:
     int num_sub;
     MPI_Comm subcomm;
+    std::array<int, 2> proc_grid;
 };
 
 /*!
@@ -191,7 +328,18 @@ inline std::ostream & operator << (std::ostream &os, plan_options const options)
        << ((options.use_reorder) ? "fft1d:contiguous" : "fft1d:strided") << ", "
        << algorithm << ", "
        << ((options.use_pencils) ? "decomposition:pencil" : "decomposition:slab") << ", "
-       << ((options.use_gpu_aware) ? "mpi:from-gpu" : "mpi:from-cpu") << ")";
+       << ((options.use_gpu_aware) ? "mpi:from-gpu" : "mpi:from-cpu");
+    if (options.use_low_memory)
+        os << ", memory:low";
+    if (not options.use_2d_planner)
+        os << ", planner:3d";
+    if (options.num_threads > 0)
+        os << ", threads:" << options.num_threads;
+    if (options.use_progress_thread)
+        os << ", progress:thread";
+    if (options.get_proc_grid()[0] > 0)
+        os << ", grid:" << options.get_proc_grid()[0] << "x" << options.get_proc_grid()[1];
+    os << ")";
     return os;
 }
 
@@ -290,6 +438,18 @@ struct logic_plan3d{
     int const mpi_rank;
 };
 
+/*!
+ * \ingroup fft3dplan
+ * \brief Returns true if the i-th stage of the plan works on a direction of size one, e.g., the third direction of a 2D problem.
+ *
+ * The Fourier transform of size one does not change the data, thus the stage uses heffte::identity_executor;
+ * the stages are never trivial if all directions have size one.
+ */
+template<typename index>
+inline bool is_trivial_stage(logic_plan3d<index> const &plan, int i){
+    return (plan.fft_sizes[plan.fft_direction[i]] == 1 and plan.index_count > 1);
+}
+
 /*!
  * \ingroup fft3dplan
  * \brief Returns true for each direction where the boxes form pencils (i.e., where the size matches the world size).
@@ -318,6 +478,25 @@ inline std::array<bool, 3> pencil_directions(box3d<index> const world, std::vect
 template<typename index>
 logic_plan3d<index> plan_operations(ioboxes<index> const &boxes, int r2c_direction, plan_options const options, int const mpi_rank);
 
+/*!
+ * \ingroup fft3dplan
+ * \brief Creates the logic plan for a transform that uses a different kind of 1-D transform in each direction.
+ *
+ * The real-to-real directions are transformed first, followed by the transform_kind::fft_r2c direction
+ * (if any) and the transform_kind::fft directions, thus the complex stages never mix with the real ones.
+ * The plan always uses pencils, since the sine and cosine executors work only in one direction,
+ * and the input and output worlds differ in the transform_kind::fft_r2c direction.
+ *
+ * \param boxes is the current distribution of the data across the MPI comm
+ * \param kinds is the transform to apply in each direction
+ * \param options is a set of heffte::plan_options to use
+ *
+ * \throws std::invalid_argument if the kinds use transform_kind::fft without exactly one transform_kind::fft_r2c direction
+ */
+template<typename index>
+logic_plan3d<index> plan_mixed_operations(ioboxes<index> const &boxes, std::array<transform_kind, 3> const &kinds,
+                                          plan_options const options, int const mpi_rank);
+
 /*!
  * \ingroup fft3dplan
  * \brief Assuming the shapes in the plan form grids, reverse engineer the grid dimensions (used in the benchmark).
@@ -325,6 +504,201 @@ logic_plan3d<index> plan_operations(ioboxes<index> const &boxes, int r2c_directi
 template<typename index>
 std::vector<std::array<int, 3>> compute_grids(logic_plan3d<index> const &plan);
 
+/*!
+ * \ingroup fft3dplan
+ * \brief Latency-bandwidth model for the cost of the reshape operations.
+ *
+ * A message between two ranks costs the latency plus the size of the message divided by the bandwidth,
+ * where the intra-node and inter-node messages use different latency and bandwidth.
+ * All ranks on a node share the inter-node bandwidth, i.e., the inter-node volume is accumulated
+ * across the node before dividing by the bandwidth.
+ * The defaults describe a generic cluster and only the relative cost between the candidate
+ * plans matters, the estimate is not meant to predict the actual time.
+ */
+struct comm_cost_model{
+    //! \brief Constructor, sets the default values.
+    comm_cost_model() : element_size(sizeof(std::complex<double>)),
+                        intra_node_latency(1.E-6), inter_node_latency(3.E-6),
+                        intra_node_bandwidth(2.E+10), inter_node_bandwidth(1.E+10)
+    {}
+    //! \brief Size of each entry in bytes, defaults to std::complex<double>.
+    size_t element_size;
+    //! \brief Latency of a message between two ranks on the same node (seconds).
+    double intra_node_latency;
+    //! \brief Latency of a message between two ranks on different nodes (seconds).
+    double inter_node_latency;
+    //! \brief Bandwidth for messages between ranks on the same node (bytes per second).
+    double intra_node_bandwidth;
+    //! \brief Bandwidth for the messages leaving or entering a node (bytes per second).
+    double inter_node_bandwidth;
+};
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Estimates the communication time of the four reshapes in the plan, as seen by the rank plan.mpi_rank.
+ *
+ * \param plan is the logic plan to analyze
+ * \param node_ids identifies the node of each rank, see heffte::mpi::node_ids()
+ * \param model defines the latency and bandwidth parameters
+ *
+ * \returns the estimated time for the four forward reshapes, the time for a reshape is zero
+ *          if the input and output shapes are the same (i.e., the reshape will be skipped)
+ */
+template<typename index>
+std::array<double, 4> estimate_comm_time(logic_plan3d<index> const &plan, std::vector<int> const &node_ids,
+                                         comm_cost_model const &model);
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Ranks all processor grids and pencil/slab decompositions by the estimated communication cost.
+ *
+ * \param boxes is the current distribution of the data across the MPI comm, i.e., mpi::gather_boxes()
+ * \param r2c_direction is the r2c direction or -1 for the c2c case
+ * \param options are the base options, the proc_grid and use_pencils will be set for each candidate
+ * \param comm is the communicator of the plan, all ranks must call the method
+ * \param model defines the parameters used in the cost estimate
+ *
+ * \returns a list of options sorted by increasing cost, where the cost of a candidate is the sum of the
+ *          maximum (across all ranks) estimated time of each reshape, ties are broken in favor of the
+ *          default heuristic
+ */
+template<typename index>
+std::vector<plan_options> rank_proc_grids(ioboxes<index> const &boxes, int r2c_direction, plan_options const options,
+                                          MPI_Comm const comm, comm_cost_model const &model = comm_cost_model());
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Communication statistics for one reshape stage, computed from the overlap of the boxes.
+ *
+ * The per-rank vectors are indexed by the MPI rank, the messages and bytes exclude the data
+ * that stays on the same rank. The imbalance is the ratio between the maximum and the average
+ * of the bytes sent by a rank, i.e., 1 indicates perfect balance.
+ */
+struct reshape_stats{
+    //! \brief Indicates whether the reshape is performed, inactive stages have input shape equal to the output.
+    bool active;
+    //! \brief Bytes sent by each rank.
+    std::vector<long long> send_bytes;
+    //! \brief Bytes received by each rank.
+    std::vector<long long> recv_bytes;
+    //! \brief Number of messages sent by each rank.
+    std::vector<int> send_messages;
+    //! \brief Number of messages received by each rank.
+    std::vector<int> recv_messages;
+    //! \brief Number of distinct ranks that each rank sends to or receives from.
+    std::vector<int> num_peers;
+    //! \brief Maximum bytes sent by a single rank.
+    long long max_send_bytes;
+    //! \brief Maximum bytes received by a single rank.
+    long long max_recv_bytes;
+    //! \brief Maximum number of messages sent or received by a single rank.
+    int max_messages;
+    //! \brief Maximum size of the peer set across the ranks.
+    int max_peers;
+    //! \brief Ratio between the maximum and average bytes sent by a rank.
+    double imbalance;
+    //! \brief Maximum size of the send and receive buffers across the ranks (bytes), the local data is included.
+    long long max_buffer_bytes;
+};
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Analytical cost of a plan, see heffte::estimate_plan_cost().
+ */
+struct plan_cost{
+    //! \brief Statistics for the four forward reshapes, the backward transform uses the same stages in reverse.
+    std::array<reshape_stats, 4> reshapes;
+    //! \brief Floating point operations of the 1-D transforms in each of the three stages, per rank.
+    std::array<std::vector<double>, 3> fft_flops;
+    //! \brief Maximum across the ranks of the flops in each stage.
+    std::array<double, 3> max_fft_flops;
+    //! \brief Workspace size per rank (bytes), the backend workspace is included only when computed from an existing plan.
+    std::vector<long long> workspace_bytes;
+    //! \brief Maximum workspace across the ranks (bytes).
+    long long max_workspace_bytes;
+};
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Computes the cost of the plan for all ranks, without MPI calls or allocating any data.
+ *
+ * \param plan is a plan created with heffte::plan_operations(), the rank stored in the plan is ignored
+ * \param element_size is the size of the scalar type that will be used in the transform, e.g., sizeof(std::complex<double>),
+ *        in the r2c case this is the size of the complex type and the reshape of the real input will use half the size
+ * \param r2c_direction is the direction of the r2c transform, -1 for the c2c case
+ *
+ * \returns the communication statistics of each reshape, the flops for the 1-D transforms
+ *          and an estimate of the workspace
+ *
+ * The flops follow the standard convention of 5 N log2(N) per complex 1-D transform of size N,
+ * which is halved for the r2c stage. The workspace is estimated as the sum of the largest
+ * communication buffers and the largest box, the internal workspace of the backend is not included.
+ * The cost of the analysis is proportional to the square of the number of ranks.
+ */
+template<typename index>
+plan_cost estimate_plan_cost(logic_plan3d<index> const &plan, size_t element_size, int r2c_direction = -1);
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Writes the plan to a binary file, the plan can be read back with heffte::load_plan().
+ *
+ * The file holds the shapes of all stages for all ranks, the directions of the 1-D transforms,
+ * the options and the r2c direction, followed by a checksum of the input and output boxes
+ * and a checksum of the entire content.
+ * Only rank 0 writes the file, the method is collective and returns after the file has been written.
+ *
+ * \param filename is the name of the file to create or overwrite
+ * \param plan is the plan computed by heffte::plan_operations()
+ * \param r2c_direction is the direction of the r2c transform, -1 for the c2c case
+ * \param comm is the communicator used to create the plan
+ */
+template<typename index>
+void save_plan(std::string const &filename, logic_plan3d<index> const &plan, int r2c_direction, MPI_Comm const comm);
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Reads a plan written by heffte::save_plan() and validates it against the current boxes.
+ *
+ * Each rank reads the file independently and the only communication is a single reduction
+ * that compares the checksum of the current boxes against the one stored in the file,
+ * thus the expensive gather of the boxes and the analysis in heffte::plan_operations() are skipped.
+ * The method is collective and throws std::runtime_error on all ranks if the file cannot be read,
+ * if the content is corrupted, or if the file was written for a different set of boxes,
+ * number of ranks, index type or r2c direction.
+ *
+ * \param filename is the name of the file written by heffte::save_plan()
+ * \param inbox is the input box of this rank
+ * \param outbox is the output box of this rank
+ * \param r2c_direction is the direction of the r2c transform, -1 for the c2c case
+ * \param comm is the communicator to be used by the plan
+ */
+template<typename index>
+logic_plan3d<index> load_plan(std::string const &filename, box3d<index> const inbox, box3d<index> const outbox,
+                              int r2c_direction, MPI_Comm const comm);
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Simple I/O for the plan cost, writes a table with one line per stage.
+ */
+inline std::ostream & operator << (std::ostream &os, plan_cost const &cost){
+    os << std::setw(8) << "stage" << std::setw(16) << "max send (B)" << std::setw(16) << "max recv (B)"
+       << std::setw(12) << "messages" << std::setw(8) << "peers" << std::setw(12) << "imbalance" << std::setw(16) << "flops" << "\n";
+    for(int i=0; i<4; i++){
+        reshape_stats const &r = cost.reshapes[i];
+        os << std::setw(8) << ("reshape" + std::to_string(i));
+        if (r.active)
+            os << std::setw(16) << r.max_send_bytes << std::setw(16) << r.max_recv_bytes
+               << std::setw(12) << r.max_messages << std::setw(8) << r.max_peers << std::setw(12) << r.imbalance;
+        else
+            os << std::setw(64) << "-";
+        os << "\n";
+        if (i < 3)
+            os << std::setw(8) << ("fft" + std::to_string(i)) << std::setw(80) << cost.max_fft_flops[i] << "\n";
+    }
+    os << "workspace: " << cost.max_workspace_bytes << " (B)\n";
+    return os;
+}
+
 }
 
 #endif
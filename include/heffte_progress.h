@@ -0,0 +1,110 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+*/
+
+#ifndef HEFFTE_PROGRESS_H
+#define HEFFTE_PROGRESS_H
+
+#include "heffte_utils.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/*!
+ * \ingroup hefftereshape
+ * \addtogroup heffteprogress Communication progress thread
+ *
+ * Many MPI implementations make progress on the non-blocking communication only
+ * while the application is inside an MPI call, e.g., the messages of the reshape3d_pointtopoint
+ * with reshape_algorithm::p2p_plined or the MPI_Ialltoallv() of an asynchronous transform
+ * will move only when the caller reaches MPI_Waitany() or fft_request::test().
+ * The progress engine is a helper thread that polls the MPI library while a reshape is
+ * communicating, so that the data moves while the main thread packs the messages and computes the 1-D transforms.
+ *
+ * The engine is enabled with heffte::plan_options::use_progress_thread and requires
+ * that MPI has been initialized with MPI_THREAD_MULTIPLE, see MPI_Init_thread().
+ * A single thread is shared by all plans in the process, the thread sleeps when no
+ * reshape is communicating and on Linux it is pinned to the last core in the affinity mask of the process.
+ */
+
+namespace heffte {
+
+/*!
+ * \ingroup heffteprogress
+ * \brief Helper thread that makes progress on the outstanding MPI messages.
+ *
+ * The engine polls the MPI library with MPI_Iprobe() on each communicator
+ * that has been activated and not yet deactivated, the polling pauses when there are no active communicators.
+ * The engine is created with shared() and the thread is joined when the last plan that uses it is destroyed.
+ */
+class progress_engine{
+public:
+    /*!
+     * \brief Returns the engine for the current process, creates a new one if no plan holds an engine.
+     *
+     * \throws std::runtime_error if MPI has not been initialized with MPI_THREAD_MULTIPLE
+     */
+    static std::shared_ptr<progress_engine> shared();
+    //! \brief Stops and joins the helper thread.
+    ~progress_engine();
+    //! \brief Cannot copy.
+    progress_engine(progress_engine const&) = delete;
+    //! \brief Cannot copy.
+    progress_engine& operator = (progress_engine const&) = delete;
+
+    //! \brief Starts polling the communicator, calls can be nested and each must be matched by deactivate().
+    void activate(MPI_Comm comm);
+    //! \brief Stops polling the communicator, on exit the helper is not using the communicator.
+    void deactivate(MPI_Comm comm);
+
+private:
+    //! \brief Constructor, launches the helper thread.
+    progress_engine();
+    //! \brief The loop executed by the helper thread.
+    void run();
+
+    //! \brief Guards the list of active communicators, held by the helper while polling.
+    std::mutex lock;
+    //! \brief Wakes up the helper when a communicator is activated or on shutdown.
+    std::condition_variable wakeup;
+    //! \brief Communicators with outstanding messages, a communicator appears once per activate() call.
+    std::vector<MPI_Comm> active;
+    //! \brief Indicates that the helper should exit.
+    bool shutdown;
+    //! \brief The helper thread.
+    std::thread helper;
+};
+
+/*!
+ * \ingroup heffteprogress
+ * \brief Keeps the engine polling the communicator for the lifetime of the object, does nothing if the engine is empty.
+ *
+ * The scope holds a reference to the engine, thus it can outlive the reshape that created it,
+ * e.g., when stored in heffte::reshape_pending.
+ */
+class progress_scope{
+public:
+    //! \brief Activates the communicator.
+    progress_scope(std::shared_ptr<progress_engine> const &cengine, MPI_Comm ccomm) : engine(cengine), comm(ccomm){
+        if (engine) engine->activate(comm);
+    }
+    //! \brief Deactivates the communicator.
+    ~progress_scope(){
+        if (engine) engine->deactivate(comm);
+    }
+    //! \brief Cannot copy.
+    progress_scope(progress_scope const&) = delete;
+    //! \brief Cannot copy.
+    progress_scope& operator = (progress_scope const&) = delete;
+
+private:
+    std::shared_ptr<progress_engine> engine;
+    MPI_Comm comm;
+};
+
+}
+
+#endif
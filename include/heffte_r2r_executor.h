@@ -223,12 +223,13 @@ struct real2real_executor : public executor_base{
         std::complex<scalar_type>* ctemp = align<fft_backend_tag>::pntr(reinterpret_cast<std::complex<scalar_type>*>(workspace + fft->box_size() + 1));
         std::complex<scalar_type>* fft_work = (fft->workspace_size() == 0) ? nullptr : ctemp + fft->complex_size();
 
-        for(int i=0; i<num_batch; i++){
+        pack_kernels::parallel_for(num_batch, threaded_entries(), [&](long long i)->void{
             prepost_processor::pre_forward(stream, length, data + i * length, temp + i * extended_length );
-        }
+        });
         fft->forward(temp, ctemp, fft_work);
-        for(int i=0; i<num_batch; i++)
+        pack_kernels::parallel_for(num_batch, threaded_entries(), [&](long long i)->void{
             prepost_processor::post_forward(stream, length, ctemp + i * ( extended_length/2 + 1 ), data + i * length);
+        });
     }
     //! \brief Inverse transform.
     template<typename scalar_type>
@@ -237,11 +238,13 @@ struct real2real_executor : public executor_base{
         std::complex<scalar_type>* ctemp = align<fft_backend_tag>::pntr(reinterpret_cast<std::complex<scalar_type>*>(workspace + fft->box_size() + 1));
         std::complex<scalar_type>* fft_work = (fft->workspace_size() == 0) ? nullptr : ctemp + fft->complex_size();
 
-        for(int i=0; i<num_batch; i++)
+        pack_kernels::parallel_for(num_batch, threaded_entries(), [&](long long i)->void{
             prepost_processor::pre_backward(stream, length, data + i * length, ctemp + i * ( extended_length/2 + 1));
+        });
         fft->backward(ctemp, temp, fft_work);
-        for(int i=0; i<num_batch; i++)
+        pack_kernels::parallel_for(num_batch, threaded_entries(), [&](long long i)->void{
             prepost_processor::post_backward(stream, length, temp + i * extended_length, data + i * length);
+        });
     }
 
     //! \brief Placeholder for template type consistency, should never be called.
@@ -270,6 +273,11 @@ struct real2real_executor : public executor_base{
     virtual void backward(double data[], double *workspace) const override{ backward<double>(data, workspace); }
 
 private:
+    //! \brief Returns the number of entries that decide the use of threads in the pre- and post-processing, zero on the GPU.
+    long long threaded_entries() const{
+        return (std::is_same<typename backend::buffer_traits<fft_backend_tag>::location, tag::cpu>::value) ? total_size : 0;
+    }
+
     typename backend::device_instance<typename backend::buffer_traits<fft_backend_tag>::location>::stream_type stream;
 
     int length, extended_length, num_batch, total_size;
@@ -9,6 +9,8 @@
 
 #include "heffte_plan_logic.h"
 #include "heffte_backends.h"
+#include "heffte_workspace_pool.h"
+#include "heffte_progress.h"
 
 /*!
  * \ingroup fft3d
@@ -39,6 +41,20 @@ namespace gpu { using namespace oneapi; }
 #endif
 #endif
 
+/*!
+ * \ingroup hefftereshape
+ * \brief Generates a pack or unpack plan where the boxes and the source have the same order.
+ *
+ * This method does not make any MPI calls, it computes the overlap between the \b source box
+ * and the set of \b boxes (e.g., the destination of a reshape) and the proc, offset, and sizes vectors
+ * of the corresponding messages, starting with the rank after \b me and wrapping around.
+ * The plans can be used with the direct packer, the method is also used by the offline plan simulator.
+ */
+template<typename index>
+void compute_overlap_map_direct_pack(int me, int nprocs, box3d<index> const source, std::vector<box3d<index>> const &boxes,
+                                     std::vector<int> &proc, std::vector<int> &offset, std::vector<int> &sizes,
+                                     std::vector<pack_plan_3d<index>> &plans);
+
 /*!
  * \ingroup hefftereshape
  * \brief Generates an unpack plan where the boxes and the destination do not have the same order.
@@ -52,6 +68,89 @@ template<typename index>
 void compute_overlap_map_transpose_pack(int me, int nprocs, box3d<index> const destination, std::vector<box3d<index>> const &boxes,
                                         std::vector<int> &proc, std::vector<int> &offset, std::vector<int> &sizes, std::vector<pack_plan_3d<index>> &plans);
 
+/*!
+ * \ingroup hefftereshape
+ * \brief Holds the state of a reshape that has been started with reshape3d_base::start() but not yet completed.
+ *
+ * The communication is completed once the \b request has completed, e.g., with MPI_Test() or MPI_Wait(),
+ * then the \b finish method (if set) has to be called to complete the reshape, e.g., to unpack the received data.
+ * If the \b request is MPI_REQUEST_NULL, the communication has either completed or was never started.
+ */
+struct reshape_pending{
+    //! \brief The request associated with the non-blocking communication.
+    MPI_Request request = MPI_REQUEST_NULL;
+    //! \brief Arrays passed to the non-blocking MPI call that must persist until the communication completes.
+    std::vector<int> counts;
+    //! \brief Keeps the progress engine polling the communication until the pending struct is reset, may be empty.
+    std::shared_ptr<progress_scope> progress;
+    //! \brief Completes the reshape after the communication, may be empty.
+    std::function<void()> finish;
+};
+
+/*!
+ * \ingroup hefftereshape
+ * \brief Function called on each block of the destination right after the block has been unpacked.
+ *
+ * The \b block points to the first unpacked entry in the destination array and the \b plan is the one used
+ * to unpack the block, i.e., the block holds plan.size[0] by plan.size[1] by plan.size[2] entries
+ * in the fast, mid and slow directions of the destination with strides 1, plan.line_stride and plan.plane_stride.
+ * The hook is called while the block is still in cache, which allows to fuse element-wise operations
+ * into the reshape, see heffte::pointwise_callback.
+ * The hook can be called concurrently from multiple threads but the blocks never overlap.
+ */
+template<typename scalar_type, typename index>
+using unpack_hook = std::function<void(scalar_type block[], pack_plan_3d<index> const &plan)>;
+
+/*!
+ * \ingroup hefftereshape
+ * \brief Returns the stride in the receive buffer between two consecutive slow planes of the destination.
+ *
+ * Zero indicates that the unpack cannot be split into slabs, e.g., for the GPU packers.
+ */
+template<typename packer_type, typename index>
+index unpack_slab_stride(packer_type const&, pack_plan_3d<index> const&){ return 0; }
+//! \brief Overload for the direct packer, the buffer holds the data in the destination order.
+template<typename index>
+index unpack_slab_stride(direct_packer<tag::cpu> const&, pack_plan_3d<index> const &plan){ return plan.size[0] * plan.size[1]; }
+//! \brief Overload for the transpose packer, the stride follows the map, see heffte::transpose_packer::unpack().
+template<typename index>
+index unpack_slab_stride(transpose_packer<tag::cpu> const&, pack_plan_3d<index> const &plan){
+    return (plan.map[0] == 2) ? 1 : ((plan.map[1] == 2) ? plan.buff_line_stride : plan.buff_plane_stride);
+}
+
+/*!
+ * \ingroup hefftereshape
+ * \brief Unpacks the \b buffer into the \b data and calls the \b hook on the result.
+ *
+ * If the packer works on the CPU, the block is unpacked in slabs of slow planes that fit in the L2 cache
+ * and the hook is called on each slab right after it has been unpacked,
+ * thus the hook works on data still in cache regardless of the size of the block.
+ * Otherwise, the hook is called once for the entire block.
+ */
+template<typename packer_type, typename stream_type, typename scalar_type, typename index>
+void unpack_with_hook(stream_type stream, packer_type const &packit, pack_plan_3d<index> const &plan,
+                      scalar_type const buffer[], scalar_type data[], unpack_hook<scalar_type, index> const &hook){
+    index const slab_stride = unpack_slab_stride(packit, plan);
+    if (not hook or slab_stride == 0){
+        packit.unpack(stream, plan, buffer, data);
+        if (hook) hook(data, plan);
+        return;
+    }
+    constexpr long long slab_bytes = 128 * 1024;
+    long long const plane_bytes = static_cast<long long>(plan.size[0]) * plan.size[1] * sizeof(scalar_type);
+    index slab = static_cast<index>(std::max(1ll, slab_bytes / std::max(1ll, plane_bytes)));
+    if (slab_stride == 1){ // the slow index of the destination is the fast one in the buffer, keep the transpose blocks whole
+        constexpr index block = pack_kernels::transpose_block_size<scalar_type>::size;
+        slab = ((slab + block - 1) / block) * block;
+    }
+    pack_plan_3d<index> sub = plan;
+    for(index s=0; s<plan.size[2]; s += slab){
+        sub.size[2] = std::min(slab, plan.size[2] - s);
+        packit.unpack(stream, sub, buffer + static_cast<long long>(s) * slab_stride, data + static_cast<long long>(s) * plan.plane_stride);
+        hook(data + static_cast<long long>(s) * plan.plane_stride, sub);
+    }
+}
+
 /*!
  * \ingroup hefftereshape
  * \brief Base reshape interface.
@@ -72,12 +171,71 @@ public:
     //! \brief Apply the reshape, double precision complex.
     virtual void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[]) const = 0;
 
+    //! \brief Apply the reshape and call the \b hook on each block of the destination after the block is unpacked, single precision.
+    virtual void apply(int batch_size, float const source[], float destination[], float workspace[],
+                       unpack_hook<float, index> const &hook) const = 0;
+    //! \brief Apply the reshape and call the \b hook after each unpack, double precision.
+    virtual void apply(int batch_size, double const source[], double destination[], double workspace[],
+                       unpack_hook<double, index> const &hook) const = 0;
+    //! \brief Apply the reshape and call the \b hook after each unpack, single precision complex.
+    virtual void apply(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+                       unpack_hook<std::complex<float>, index> const &hook) const = 0;
+    //! \brief Apply the reshape and call the \b hook after each unpack, double precision complex.
+    virtual void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+                       unpack_hook<std::complex<double>, index> const &hook) const = 0;
+
+    /*!
+     * \brief Starts the reshape using non-blocking communication, single precision.
+     *
+     * On exit, the \b pending struct holds the state of the communication and the reshape is complete
+     * once the pending request completes and pending.finish() has been called.
+     * The source, destination and workspace buffers must remain valid until the reshape is complete.
+     * The default implementation performs the entire blocking apply() and leaves \b pending empty.
+     */
+    virtual void start(int batch_size, float const source[], float destination[], float workspace[], reshape_pending &pending) const{
+        apply(batch_size, source, destination, workspace);
+        pending = reshape_pending();
+    }
+    //! \brief Starts the reshape, double precision, see the single precision overload.
+    virtual void start(int batch_size, double const source[], double destination[], double workspace[], reshape_pending &pending) const{
+        apply(batch_size, source, destination, workspace);
+        pending = reshape_pending();
+    }
+    //! \brief Starts the reshape, single precision complex, see the single precision overload.
+    virtual void start(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+                       reshape_pending &pending) const{
+        apply(batch_size, source, destination, workspace);
+        pending = reshape_pending();
+    }
+    //! \brief Starts the reshape, double precision complex, see the single precision overload.
+    virtual void start(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+                       reshape_pending &pending) const{
+        apply(batch_size, source, destination, workspace);
+        pending = reshape_pending();
+    }
+
     //! \brief Returns the input size.
     index size_intput() const{ return input_size; }
     //! \brief Returns the output size.
     index size_output() const{ return output_size; }
     //! \brief Returns the workspace size.
     virtual size_t size_workspace() const{ return input_size + output_size; }
+    /*!
+     * \brief Sets the CPU buffers used to stage the messages when GPU-aware communication is disabled.
+     *
+     * The buffers can be shared between reshapes that are never executed at the same time,
+     * e.g., the buffers of a heffte::workspace_pool.
+     */
+    void set_staging_buffers(std::shared_ptr<aligned_buffer> const &send, std::shared_ptr<aligned_buffer> const &recv){
+        send_unaware = send;
+        recv_unaware = recv;
+    }
+    /*!
+     * \brief Sets the engine that makes progress on the messages while the reshape is communicating.
+     *
+     * The engine is usually shared between all reshapes in the process, see plan_options::use_progress_thread.
+     */
+    void set_progress_engine(std::shared_ptr<progress_engine> const &engine){ progress = engine; }
 
 protected:
     //! \brief Stores the size of the input.
@@ -91,20 +249,20 @@ protected:
     // note that the main API accepts a GPU buffer for scratch work and cannot be used here
     //! \brief Allocates and returns a CPU buffer when GPU-Aware communication has been disabled.
     template<typename scalar_type> scalar_type* cpu_send_buffer(size_t num_entries) const{
-        size_t float_entries = num_entries * sizeof(scalar_type) / sizeof(float);
-        send_unaware.resize(float_entries);
-        return reinterpret_cast<scalar_type*>(send_unaware.data());
+        if (not send_unaware) send_unaware = std::make_shared<aligned_buffer>();
+        return send_unaware->template get<scalar_type>(num_entries);
     }
     //! \brief Allocates and returns a CPU buffer when GPU-Aware communication has been disabled.
     template<typename scalar_type> scalar_type* cpu_recv_buffer(size_t num_entries) const{
-        size_t float_entries = num_entries * sizeof(scalar_type) / sizeof(float);
-        recv_unaware.resize(float_entries);
-        return reinterpret_cast<scalar_type*>(recv_unaware.data());
+        if (not recv_unaware) recv_unaware = std::make_shared<aligned_buffer>();
+        return recv_unaware->template get<scalar_type>(num_entries);
     }
+    //! \brief Temp buffers for the gpu-unaware algorithms, can be shared between reshapes, see set_staging_buffers().
+    mutable std::shared_ptr<aligned_buffer> send_unaware;
     //! \brief Temp buffers for the gpu-unaware algorithms.
-    mutable std::vector<float> send_unaware;
-    //! \brief Temp buffers for the gpu-unaware algorithms.
-    mutable std::vector<float> recv_unaware;
+    mutable std::shared_ptr<aligned_buffer> recv_unaware;
+    //! \brief Optional helper thread that polls the MPI library during the communication, see set_progress_engine().
+    std::shared_ptr<progress_engine> progress;
 };
 
 /*!
@@ -154,10 +312,54 @@ public:
     void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[]) const override final{
         apply_base(batch_size, source, destination, workspace);
     }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision overload.
+    void apply(int batch_size, float const source[], float destination[], float workspace[],
+               unpack_hook<float, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision overload.
+    void apply(int batch_size, double const source[], double destination[], double workspace[],
+               unpack_hook<double, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision complex overload.
+    void apply(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+               unpack_hook<std::complex<float>, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision complex overload.
+    void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+               unpack_hook<std::complex<double>, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
 
     //! \brief Templated reshape3d_alltoallv::apply() algorithm for all scalar types.
     template<typename scalar_type>
-    void apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const;
+    void apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                    unpack_hook<scalar_type, index> const &hook = unpack_hook<scalar_type, index>()) const;
+
+    //! \brief Start the reshape operations, single precision overload.
+    void start(int batch_size, float const source[], float destination[], float workspace[], reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+    //! \brief Start the reshape operations, double precision overload.
+    void start(int batch_size, double const source[], double destination[], double workspace[], reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+    //! \brief Start the reshape operations, single precision complex overload.
+    void start(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+               reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+    //! \brief Start the reshape operations, double precision complex overload.
+    void start(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+               reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+
+    //! \brief Templated non-blocking variant of apply_base(), packs the data and posts MPI_Ialltoall().
+    template<typename scalar_type>
+    void start_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[], reshape_pending &pending) const;
 
     //! \brief The size of the workspace must include padding.
     size_t size_workspace() const override { return 2 * num_entries * packplan.size(); }
@@ -171,6 +373,14 @@ private:
                        std::vector<pack_plan_3d<index>>&&, std::vector<pack_plan_3d<index>>&&,
                        std::vector<int>&&, std::vector<int>&&, int);
 
+    //! \brief Packs the data for all messages into the send buffer.
+    template<typename scalar_type>
+    void pack_messages(int batch_size, scalar_type const source[], scalar_type send_buffer[]) const;
+    //! \brief Unpacks the data of all messages from the receive buffer, calls the hook (if set) after each unpacked block.
+    template<typename scalar_type>
+    void unpack_messages(int batch_size, scalar_type const recv_buffer[], scalar_type destination[],
+                         unpack_hook<scalar_type, index> const &hook) const;
+
     MPI_Comm const comm;
     int const me, nprocs;
     bool const use_gpu_aware;
@@ -247,10 +457,54 @@ public:
     void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[]) const override final{
         apply_base(batch_size, source, destination, workspace);
     }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision overload.
+    void apply(int batch_size, float const source[], float destination[], float workspace[],
+               unpack_hook<float, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision overload.
+    void apply(int batch_size, double const source[], double destination[], double workspace[],
+               unpack_hook<double, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision complex overload.
+    void apply(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+               unpack_hook<std::complex<float>, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision complex overload.
+    void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+               unpack_hook<std::complex<double>, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
 
     //! \brief Templated reshape3d_alltoallv::apply() algorithm for all scalar types.
     template<typename scalar_type>
-    void apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const;
+    void apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                    unpack_hook<scalar_type, index> const &hook = unpack_hook<scalar_type, index>()) const;
+
+    //! \brief Start the reshape operations, single precision overload.
+    void start(int batch_size, float const source[], float destination[], float workspace[], reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+    //! \brief Start the reshape operations, double precision overload.
+    void start(int batch_size, double const source[], double destination[], double workspace[], reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+    //! \brief Start the reshape operations, single precision complex overload.
+    void start(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+               reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+    //! \brief Start the reshape operations, double precision complex overload.
+    void start(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+               reshape_pending &pending) const override final{
+        start_base(batch_size, source, destination, workspace, pending);
+    }
+
+    //! \brief Templated non-blocking variant of apply_base(), packs the data and posts MPI_Ialltoallv().
+    template<typename scalar_type>
+    void start_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[], reshape_pending &pending) const;
 
 private:
     /*!
@@ -263,6 +517,14 @@ private:
                         std::vector<int> &&recv_offset, std::vector<int> &&recv_size, std::vector<int> const &recv_proc,
                         std::vector<pack_plan_3d<index>> &&packplan, std::vector<pack_plan_3d<index>> &&unpackplan);
 
+    //! \brief Packs the data for all messages into the send buffer.
+    template<typename scalar_type>
+    void pack_messages(int batch_size, scalar_type const source[], scalar_type send_buffer[]) const;
+    //! \brief Unpacks the data of all messages from the receive buffer, calls the hook (if set) after each unpacked block.
+    template<typename scalar_type>
+    void unpack_messages(int batch_size, scalar_type const recv_buffer[], scalar_type destination[],
+                         unpack_hook<scalar_type, index> const &hook) const;
+
     MPI_Comm const comm;
     int const me, nprocs;
     bool const use_gpu_aware;
@@ -344,7 +606,8 @@ public:
     ~reshape3d_pointtopoint() = default;
     //! \brief Factory method, use to construct instances of the class.
     template<typename b, template<typename d> class p, typename i> friend std::unique_ptr<reshape3d_pointtopoint<b, p, i>>
-    make_reshape3d_pointtopoint(typename backend::device_instance<b>::stream_type, std::vector<box3d<i>> const&, std::vector<box3d<i>> const&, reshape_algorithm, bool, MPI_Comm const);
+    make_reshape3d_pointtopoint(typename backend::device_instance<b>::stream_type, std::vector<box3d<i>> const&, std::vector<box3d<i>> const&,
+                                reshape_algorithm, bool, MPI_Comm const, bool);
 
     //! \brief Apply the reshape operations, single precision overload.
     void apply(int batch_size, float const source[], float destination[], float workspace[]) const override final{
@@ -362,14 +625,52 @@ public:
     void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[]) const override final{
         apply_base(batch_size, source, destination, workspace);
     }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision overload.
+    void apply(int batch_size, float const source[], float destination[], float workspace[],
+               unpack_hook<float, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision overload.
+    void apply(int batch_size, double const source[], double destination[], double workspace[],
+               unpack_hook<double, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision complex overload.
+    void apply(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+               unpack_hook<std::complex<float>, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision complex overload.
+    void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+               unpack_hook<std::complex<double>, index> const &hook) const override final{
+        apply_base(batch_size, source, destination, workspace, hook);
+    }
 
     //! \brief Templated reshape3d_pointtopoint::apply() algorithm for all scalar types.
     template<typename scalar_type>
-    void apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const;
+    void apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                    unpack_hook<scalar_type, index> const &hook = unpack_hook<scalar_type, index>()) const;
 
     //! \brief Templated reshape3d_pointtopoint::apply() algorithm that does not use GPU-Aware MPI.
     template<typename scalar_type>
-    void no_gpuaware_send_recv(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const;
+    void no_gpuaware_send_recv(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                               unpack_hook<scalar_type, index> const &hook) const;
+
+    /*!
+     * \brief Templated reshape3d_pointtopoint::apply() algorithm that exchanges data with one rank at a time.
+     *
+     * The exchange is performed in rounds, in round k the rank sends to (me + k) and receives from (me - k),
+     * thus the send and receive buffers hold only one message and the rounds cannot deadlock.
+     * The destination is written before all messages are packed, hence the source and destination must differ.
+     */
+    template<typename scalar_type>
+    void pairwise_send_recv(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                            unpack_hook<scalar_type, index> const &hook) const;
+
+    //! \brief Returns the workspace size, only the largest send and receive messages in the low-memory mode.
+    size_t size_workspace() const override{
+        return (low_memory) ? static_cast<size_t>(max_send_size) + static_cast<size_t>(max_recv_size) : reshape3d_base<index>::size_workspace();
+    }
 
 private:
     /*!
@@ -380,13 +681,15 @@ private:
                            std::vector<int> &&send_offset, std::vector<int> &&send_size, std::vector<int> &&send_proc,
                            std::vector<int> &&recv_offset, std::vector<int> &&recv_size, std::vector<int> &&recv_proc,
                            std::vector<int> &&recv_loc,
-                           std::vector<pack_plan_3d<index>> &&packplan, std::vector<pack_plan_3d<index>> &&unpackplan);
+                           std::vector<pack_plan_3d<index>> &&packplan, std::vector<pack_plan_3d<index>> &&unpackplan,
+                           bool low_memory);
 
     MPI_Comm const comm;
     int const me, nprocs;
     bool const self_to_self;
     reshape_algorithm const algorithm;
     bool const use_gpu_aware;
+    bool const low_memory;
     mutable std::vector<MPI_Request> requests; // recv_proc.size() requests, but remove one if using self_to_self communication
     mutable std::vector<MPI_Request> isends;
 
@@ -400,7 +703,8 @@ private:
     int const send_total, recv_total;
 
     std::vector<pack_plan_3d<index>> const packplan, unpackplan;
-    int max_send_size;
+    int max_send_size, max_recv_size;
+    std::vector<std::array<int, 2>> rounds; // low-memory mode, index of the send and receive message in each round or -1
 };
 
 /*!
@@ -420,6 +724,7 @@ private:
  * \param algorithm must be either reshape_algorithm::p2p or reshape_algorithm::p2p_plined
  * \param use_gpu_aware use MPI calls directly from the GPU (GPU backends only)
  * \param comm the communicator associated with all the boxes
+ * \param low_memory exchange the data with one rank at a time, see plan_options::use_low_memory
  *
  * \returns unique_ptr containing an instance of the heffte::reshape3d_pointtopoint
  *
@@ -432,7 +737,7 @@ make_reshape3d_pointtopoint(typename backend::device_instance<location_tag>::str
                             std::vector<box3d<index>> const &input_boxes,
                             std::vector<box3d<index>> const &output_boxes,
                             reshape_algorithm algorithm, bool use_gpu_aware,
-                            MPI_Comm const comm);
+                            MPI_Comm const comm, bool low_memory = false);
 
 /*!
  * \ingroup hefftereshape
@@ -443,12 +748,12 @@ make_reshape3d_pointtopoint(typename backend::device_instance<location_tag>::str
 template<typename location_tag, typename index>
 class reshape3d_transpose : public reshape3d_base<index>, public backend::device_instance<location_tag>{
 public:
-    //! \brief Constructor using the provided unpack plan.
+    //! \brief Constructor using the provided unpack plan, the out-of-place transpose does not accept source equal to destination.
     reshape3d_transpose(typename backend::device_instance<location_tag>::stream_type q,
-                        pack_plan_3d<index> const cplan) :
+                        pack_plan_3d<index> const cplan, bool cout_of_place = false) :
         reshape3d_base<index>(cplan.size[0] * cplan.size[1] * cplan.size[2], cplan.size[0] * cplan.size[1] * cplan.size[2]),
         backend::device_instance<location_tag>(q),
-        plan(cplan)
+        plan(cplan), out_of_place(cout_of_place)
         {}
 
     //! \brief Apply the reshape operations, single precision overload.
@@ -467,46 +772,62 @@ public:
     void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[]) const override final{
         transpose(batch_size, source, destination, workspace);
     }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision overload.
+    void apply(int batch_size, float const source[], float destination[], float workspace[],
+               unpack_hook<float, index> const &hook) const override final{
+        transpose(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision overload.
+    void apply(int batch_size, double const source[], double destination[], double workspace[],
+               unpack_hook<double, index> const &hook) const override final{
+        transpose(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, single precision complex overload.
+    void apply(int batch_size, std::complex<float> const source[], std::complex<float> destination[], std::complex<float> workspace[],
+               unpack_hook<std::complex<float>, index> const &hook) const override final{
+        transpose(batch_size, source, destination, workspace, hook);
+    }
+    //! \brief Apply the reshape operations and call the hook after each unpack, double precision complex overload.
+    void apply(int batch_size, std::complex<double> const source[], std::complex<double> destination[], std::complex<double> workspace[],
+               unpack_hook<std::complex<double>, index> const &hook) const override final{
+        transpose(batch_size, source, destination, workspace, hook);
+    }
+
+    //! \brief The out-of-place transpose does not use workspace.
+    size_t size_workspace() const override{ return (out_of_place) ? 0 : reshape3d_base<index>::size_workspace(); }
 
 private:
     template<typename scalar_type>
-    void transpose(int batch_size, scalar_type const *source, scalar_type *destination, scalar_type *workspace) const{
+    void transpose(int batch_size, scalar_type const *source, scalar_type *destination, scalar_type *workspace,
+                   unpack_hook<scalar_type, index> const &hook = unpack_hook<scalar_type, index>()) const{
         if (source == destination){ // in-place transpose will need workspace
+            if (out_of_place)
+                throw std::runtime_error("heffte internal error: in-place call to an out-of-place transpose");
             backend::data_manipulator<location_tag>::copy_n(this->stream(), source, batch_size * this->input_size, workspace);
-            for(int j=0; j<batch_size; j++)
-                transpose_packer<location_tag>().unpack(this->stream(), plan, workspace + j * this->input_size,
-                                                        destination + j * this->input_size);
-        }else{
-            for(int j=0; j<batch_size; j++)
-                transpose_packer<location_tag>().unpack(this->stream(), plan, source + j * this->input_size,
-                                                        destination + j * this->input_size);
+            source = workspace;
+        }
+        for(int j=0; j<batch_size; j++){
+            unpack_with_hook(this->stream(), transpose_packer<location_tag>(), plan, source + j * this->input_size,
+                             destination + j * this->input_size, hook);
         }
     }
 
     pack_plan_3d<index> const plan;
+    bool const out_of_place;
 };
 
 /*!
+ * \internal
  * \ingroup hefftereshape
- * \brief Factory method to create a reshape3d instance.
- *
- * Creates a reshape operation from the geometry defined by the input boxes to the geometry defined but the output boxes.
- * The boxes are spread across the given MPI communicator where the boxes associated with the current MPI rank is located
- * at input_boxes[mpi::comm_rank(comm)] and output_boxes[mpi::comm_rank(comm)].
- *
- * - If the input and output are the same, then an empty unique_ptr is created.
- * - If the geometries differ only in the order, then a reshape3d_transpose instance is created.
- * - In all other cases, a reshape3d_alltoallv instance is created using either direct_packer or transpose_packer.
- *
- * Assumes that the order of the input and output geometries are consistent, i.e.,
- * input_boxes[i].order == input_boxes[j].order for all i, j.
+ * \brief Selects and creates the reshape algorithm, see heffte::make_reshape3d().
+ * \endinternal
  */
 template<typename backend_tag, typename index>
-std::unique_ptr<reshape3d_base<index>> make_reshape3d(typename backend::device_instance<typename backend::buffer_traits<backend_tag>::location>::stream_type stream,
-                                               std::vector<box3d<index>> const &input_boxes,
-                                               std::vector<box3d<index>> const &output_boxes,
-                                               MPI_Comm const comm,
-                                               plan_options const options){
+std::unique_ptr<reshape3d_base<index>> make_reshape3d_algorithm(typename backend::device_instance<typename backend::buffer_traits<backend_tag>::location>::stream_type stream,
+                                                         std::vector<box3d<index>> const &input_boxes,
+                                                         std::vector<box3d<index>> const &output_boxes,
+                                                         MPI_Comm const comm,
+                                                         plan_options const options){
     using location_tag = typename backend::buffer_traits<backend_tag>::location;
 
     if (match(input_boxes, output_boxes)){
@@ -520,14 +841,23 @@ std::unique_ptr<reshape3d_base<index>> make_reshape3d(typename backend::device_i
             compute_overlap_map_transpose_pack(0, 1, output_boxes[me], {input_boxes[me]}, proc, offset, sizes, plans);
 
             if (not plans.empty()){
-                return std::unique_ptr<reshape3d_base<index>>(new reshape3d_transpose<location_tag, index >(stream, plans[0]));
+                return std::unique_ptr<reshape3d_base<index>>(new reshape3d_transpose<location_tag, index >(stream, plans[0],
+                                                                                                          options.use_low_memory));
             }else{
                 // when the number of indexes is very small, the current box can be empty
                 return std::unique_ptr<reshape3d_base<index>>();
             }
         }
     }else{
-        if (options.algorithm == reshape_algorithm::alltoallv){
+        if (options.use_low_memory){
+            if (input_boxes[0].ordered_same_as(output_boxes[0])){
+                return make_reshape3d_pointtopoint<location_tag, direct_packer, index>(stream, input_boxes, output_boxes,
+                                                                                       reshape_algorithm::p2p, options.use_gpu_aware, comm, true);
+            }else{
+                return make_reshape3d_pointtopoint<location_tag, transpose_packer, index>(stream, input_boxes, output_boxes,
+                                                                                          reshape_algorithm::p2p, options.use_gpu_aware, comm, true);
+            }
+        }else if (options.algorithm == reshape_algorithm::alltoallv){
             if (input_boxes[0].ordered_same_as(output_boxes[0])){
                 return make_reshape3d_alltoallv<location_tag, direct_packer, index>(stream, input_boxes, output_boxes,
                                                                                     options.use_gpu_aware, comm);
@@ -555,6 +885,37 @@ std::unique_ptr<reshape3d_base<index>> make_reshape3d(typename backend::device_i
     }
 }
 
+/*!
+ * \ingroup hefftereshape
+ * \brief Factory method to create a reshape3d instance.
+ *
+ * Creates a reshape operation from the geometry defined by the input boxes to the geometry defined but the output boxes.
+ * The boxes are spread across the given MPI communicator where the boxes associated with the current MPI rank is located
+ * at input_boxes[mpi::comm_rank(comm)] and output_boxes[mpi::comm_rank(comm)].
+ *
+ * - If the input and output are the same, then an empty unique_ptr is created.
+ * - If the geometries differ only in the order, then a reshape3d_transpose instance is created.
+ * - If plan_options::use_low_memory is set, a reshape3d_pointtopoint instance is created that exchanges
+ *   the data with one rank at a time and the transpose does not accept in-place calls.
+ * - In all other cases, a reshape3d_alltoallv instance is created using either direct_packer or transpose_packer.
+ * - If plan_options::use_progress_thread is set, the reshape uses the progress engine of the process,
+ *   see heffte::progress_engine.
+ *
+ * Assumes that the order of the input and output geometries are consistent, i.e.,
+ * input_boxes[i].order == input_boxes[j].order for all i, j.
+ */
+template<typename backend_tag, typename index>
+std::unique_ptr<reshape3d_base<index>> make_reshape3d(typename backend::device_instance<typename backend::buffer_traits<backend_tag>::location>::stream_type stream,
+                                               std::vector<box3d<index>> const &input_boxes,
+                                               std::vector<box3d<index>> const &output_boxes,
+                                               MPI_Comm const comm,
+                                               plan_options const options){
+    std::unique_ptr<reshape3d_base<index>> shaper = make_reshape3d_algorithm<backend_tag>(stream, input_boxes, output_boxes, comm, options);
+    if (shaper and options.use_progress_thread)
+        shaper->set_progress_engine(progress_engine::shared());
+    return shaper;
+}
+
 }
 
 #endif
@@ -0,0 +1,154 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+*/
+
+#ifndef HEFFTE_THREADS_H
+#define HEFFTE_THREADS_H
+
+#include "heffte_utils.h"
+
+#ifdef Heffte_ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+/*!
+ * \ingroup fft3d
+ * \addtogroup hefftethreads Multi-threading
+ *
+ * If heFFTe is built with OpenMP (Heffte_ENABLE_OPENMP), all CPU stages of the transform
+ * are split across multiple threads, i.e., the packing and unpacking of the reshapes,
+ * the 1-D transforms of the stock backend, the conversion between real and complex data,
+ * the copies between the internal buffers and the scaling.
+ * The threads are taken from the OpenMP runtime, which keeps a persistent team
+ * that is shared by all plans and reused from one transform to the next,
+ * thus there is no overhead of creating threads in the transform calls.
+ *
+ * The number of threads is set per plan by heffte::plan_options::num_threads,
+ * the default uses the OpenMP defaults, e.g., the OMP_NUM_THREADS environment variable.
+ * Combined with fewer MPI ranks per node, the threads reduce the number of messages
+ * in the all-to-all exchanges while still using all of the cores.
+ * The FFTW and MKL backends use their own threading within the 1-D transforms,
+ * e.g., the FFTW threads are set by fftw_plan_with_nthreads().
+ */
+
+namespace heffte {
+
+/*!
+ * \ingroup hefftethreads
+ * \brief Sets the number of OpenMP threads used by the calling thread for the lifetime of the object.
+ *
+ * Non-positive number of threads leaves the OpenMP setting unchanged,
+ * the previous setting is restored in the destructor.
+ * Without OpenMP, the class does nothing.
+ */
+class thread_scope{
+public:
+    //! \brief Set the number of threads.
+    thread_scope(int num_threads) :
+    #ifdef Heffte_ENABLE_OPENMP
+        previous((num_threads > 0) ? omp_get_max_threads() : 0)
+    #else
+        previous(0)
+    #endif
+    {
+        #ifdef Heffte_ENABLE_OPENMP
+        if (num_threads > 0) omp_set_num_threads(num_threads);
+        #endif
+    }
+    //! \brief Restore the number of threads.
+    ~thread_scope(){
+        #ifdef Heffte_ENABLE_OPENMP
+        if (previous > 0) omp_set_num_threads(previous);
+        #endif
+    }
+    //! \brief Cannot copy.
+    thread_scope(thread_scope const&) = delete;
+    //! \brief Cannot copy.
+    thread_scope& operator = (thread_scope const&) = delete;
+
+private:
+    int const previous;
+};
+
+namespace pack_kernels {
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Number of entries below which the kernels will not spawn threads.
+ *
+ * Forking and joining an OpenMP team costs a few micro-seconds,
+ * which is more than the time needed to copy a small box.
+ */
+constexpr long long parallel_cutoff = 32768;
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Returns true if moving \b num_entries will be done with multiple threads.
+ *
+ * Returns false if OpenMP is disabled or if already inside of a parallel region,
+ * e.g., if the calling reshape operation already distributes the peers across the threads.
+ */
+#ifdef Heffte_ENABLE_OPENMP
+inline bool use_threads(long long num_entries){
+    return (num_entries >= parallel_cutoff and omp_get_max_threads() > 1 and not omp_in_parallel());
+}
+#else
+inline bool use_threads(long long){ return false; }
+#endif
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Returns true if the packing of the \b num_peers messages should be distributed across threads.
+ *
+ * If the number of peers is small compared to the number of threads, then it is better
+ * to leave the peers sequential and parallelize over the planes of each sub-box.
+ */
+#ifdef Heffte_ENABLE_OPENMP
+inline bool use_threads_over_peers(size_t num_peers, long long num_entries){
+    return (use_threads(num_entries) and num_peers >= static_cast<size_t>(omp_get_max_threads()));
+}
+#else
+inline bool use_threads_over_peers(size_t, long long){ return false; }
+#endif
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Returns the number of threads that will be used to move \b num_entries, see use_threads().
+ */
+#ifdef Heffte_ENABLE_OPENMP
+inline int num_threads(long long num_entries){ return (use_threads(num_entries)) ? omp_get_max_threads() : 1; }
+#else
+inline int num_threads(long long){ return 1; }
+#endif
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Returns the index of the calling thread within the current team, always 0 without OpenMP.
+ */
+#ifdef Heffte_ENABLE_OPENMP
+inline int thread_id(){ return omp_get_thread_num(); }
+#else
+inline int thread_id(){ return 0; }
+#endif
+
+/*!
+ * \ingroup hefftepacking
+ * \brief Calls body(i) for i = 0 ... num_iterations - 1, the iterations are split across the threads if use_threads(num_entries).
+ *
+ * The \b num_entries is the total amount of data accessed by the loop, which is usually more than the number of iterations.
+ */
+template<typename callable>
+void parallel_for(long long num_iterations, long long num_entries, callable const &body){
+    #ifdef Heffte_ENABLE_OPENMP
+    #pragma omp parallel for schedule(static) if(use_threads(num_entries) and num_iterations > 1)
+    #endif
+    for(long long i=0; i<num_iterations; i++) body(i);
+}
+
+}
+
+}
+
+#endif
@@ -177,6 +177,29 @@ inline void comm_free(MPI_Comm const comm){
         throw std::runtime_error("Could not free a communicator.");
 }
 
+/*!
+ * \ingroup hefftempi
+ * \brief Returns the node (shared memory domain) of each rank in the \b comm.
+ *
+ * \param comm is an active communicator.
+ *
+ * \returns a vector of size equal to the size of the \b comm, where entry \b i identifies
+ *          the node of rank \b i using the lowest rank on the same node
+ *
+ * Uses MPI_Comm_split_type() with MPI_COMM_TYPE_SHARED, MPI_Allreduce() and MPI_Allgather().
+ */
+inline std::vector<int> node_ids(MPI_Comm const comm){
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+    int const me = comm_rank(comm);
+    int node_id = me;
+    MPI_Allreduce(&me, &node_id, 1, MPI_INT, MPI_MIN, node_comm);
+    comm_free(node_comm);
+    std::vector<int> result(comm_size(comm));
+    MPI_Allgather(&node_id, 1, MPI_INT, result.data(), 1, MPI_INT, comm);
+    return result;
+}
+
 /*!
  * \ingroup hefftempi
  * \brief Returns the MPI equivalent of the \b scalar C++ type.
@@ -373,12 +396,12 @@ typename define_standard_type<scalar_type>::type const* convert_to_standard(scal
 
 /*!
  * \ingroup fft3dmisc
- * \brief Return the index of the last active (non-null) unique_ptr.
+ * \brief Return the index of the last active (non-null) pointer, works with raw pointers and unique_ptr.
  *
  * The method returns -1 if all shapers are null.
  */
-template<typename some_class>
-int get_last_active(std::array<std::unique_ptr<some_class>, 4> const &shaper){
+template<typename pointer_type>
+int get_last_active(std::array<pointer_type, 4> const &shaper){
     int last = -1;
     for(int i=0; i<4; i++) if (shaper[i]) last = i;
     return last;
@@ -386,10 +409,10 @@ int get_last_active(std::array<std::unique_ptr<some_class>, 4> const &shaper){
 
 /*!
  * \ingroup fft3dmisc
- * \brief Return the number of active (non-null) unique_ptr.
+ * \brief Return the number of active (non-null) pointers, works with raw pointers and unique_ptr.
  */
-template<typename some_class>
-int count_active(std::array<std::unique_ptr<some_class>, 4> const &shaper){
+template<typename pointer_type>
+int count_active(std::array<pointer_type, 4> const &shaper){
     int num = 0;
     for(int i=0; i<4; i++) if (shaper[i]) num++;
     return num;
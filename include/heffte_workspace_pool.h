@@ -0,0 +1,251 @@
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+*/
+
+#ifndef HEFFTE_WORKSPACE_POOL_H
+#define HEFFTE_WORKSPACE_POOL_H
+
+#include "heffte_backends.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/*!
+ * \ingroup fft3d
+ * \addtogroup hefftepool Workspace pool
+ *
+ * The overloads of heffte::fft3d and heffte::fft3d_r2c that do not accept a workspace buffer
+ * allocate the workspace on every call and release it right after.
+ * A heffte::workspace_pool can be attached to one or more plans, then the workspace is taken
+ * from a single block of memory owned by the pool, the block is sized to the largest workspace
+ * of all the plans and is allocated only once.
+ * After the first transform, the calls that use the pool do not allocate any memory,
+ * which also includes the CPU staging buffers used when GPU-aware MPI is disabled.
+ *
+ * The pool is not thread-safe and the plans that share a pool cannot run transforms concurrently,
+ * i.e., the pool is intended for codes that hold many plans and call them one at a time.
+ * The asynchronous requests (e.g., heffte::fft3d::forward_async()) do not use the pool
+ * since the workspace has to live until the request completes.
+ */
+
+namespace heffte {
+
+/*!
+ * \ingroup hefftepool
+ * \brief Alignment of the blocks handed out by the heffte::workspace_pool.
+ */
+enum class pool_alignment{
+    //! \brief Align the blocks to the 64 bytes of a cache line.
+    cache_line,
+    //! \brief Align the blocks to 2MB and advise the kernel to back the blocks with huge pages (Linux only).
+    huge_page
+};
+
+/*!
+ * \ingroup hefftepool
+ * \brief Returns the alignment in bytes corresponding to the heffte::pool_alignment.
+ */
+inline size_t alignment_bytes(pool_alignment alignment){
+    return (alignment == pool_alignment::huge_page) ? 2097152 : 64;
+}
+
+/*!
+ * \ingroup hefftepool
+ * \brief Block of CPU memory that grows on demand and never shrinks.
+ *
+ * The data is not initialized and is not preserved when the block grows,
+ * the block is meant for scratch work only.
+ */
+class aligned_buffer{
+public:
+    //! \brief Creates an empty block that will use the given alignment.
+    aligned_buffer(pool_alignment mode = pool_alignment::cache_line) :
+        alignment(alignment_bytes(mode)), huge_pages(mode == pool_alignment::huge_page),
+        num_bytes(0), num_allocations(0), raw(nullptr, &std::free), aligned(nullptr)
+    {}
+
+    //! \brief Returns a pointer to at least \b bytes of aligned memory, allocates only if the current block is too small.
+    void* reserve(size_t bytes){
+        if (bytes <= num_bytes) return aligned;
+        size_t const new_bytes = alignment * ((bytes + alignment - 1) / alignment);
+        raw.reset(); // release the old block first to reduce the peak memory
+        raw.reset(std::malloc(new_bytes + alignment));
+        if (not raw) throw std::bad_alloc();
+        size_t const address = reinterpret_cast<size_t>(raw.get());
+        aligned = reinterpret_cast<void*>(alignment * ((address + alignment - 1) / alignment));
+        #ifdef __linux__
+        #ifdef MADV_HUGEPAGE
+        if (huge_pages) madvise(aligned, new_bytes, MADV_HUGEPAGE); // hint only, ignore errors
+        #endif
+        #endif
+        num_bytes = new_bytes;
+        num_allocations++;
+        return aligned;
+    }
+    //! \brief Returns a pointer to an aligned array with at least \b num_entries of the given type.
+    template<typename scalar_type>
+    scalar_type* get(size_t num_entries){ return reinterpret_cast<scalar_type*>(reserve(num_entries * sizeof(scalar_type))); }
+
+    //! \brief Returns the size of the current block in bytes.
+    size_t capacity() const{ return num_bytes; }
+    //! \brief Returns the number of times the block had to be allocated.
+    int allocations() const{ return num_allocations; }
+
+private:
+    size_t const alignment;
+    bool const huge_pages;
+    size_t num_bytes;
+    int num_allocations;
+    std::unique_ptr<void, decltype(&std::free)> raw;
+    void *aligned;
+};
+
+/*!
+ * \ingroup hefftepool
+ * \brief Holds the memory block of the pool, the location tag indicates CPU or GPU memory.
+ */
+template<typename location_tag> struct pool_block{};
+
+/*!
+ * \ingroup hefftepool
+ * \brief Specialization for the CPU memory, uses heffte::aligned_buffer.
+ */
+template<> struct pool_block<tag::cpu>{
+    //! \brief Constructor, sets the alignment.
+    pool_block(pool_alignment mode) : buffer(mode){}
+    //! \brief Returns a block with at least the given number of bytes.
+    void* reserve(void*, size_t bytes){ return buffer.reserve(bytes); }
+    //! \brief Returns the size of the block in bytes.
+    size_t capacity() const{ return buffer.capacity(); }
+    //! \brief Returns the number of allocations.
+    int allocations() const{ return buffer.allocations(); }
+    //! \brief The block of memory.
+    aligned_buffer buffer;
+};
+
+#ifdef Heffte_ENABLE_GPU
+/*!
+ * \ingroup hefftepool
+ * \brief Specialization for the GPU memory, the device allocations are always aligned to at least 256 bytes.
+ */
+template<> struct pool_block<tag::gpu>{
+    //! \brief Constructor, the alignment is set by the device allocator.
+    pool_block(pool_alignment) : num_allocations(0){}
+    //! \brief Returns a block with at least the given number of bytes.
+    void* reserve(typename gpu::vector<std::complex<double>>::stream_type stream, size_t bytes){
+        if (bytes > capacity()){
+            buffer = gpu::vector<std::complex<double>>(); // release the old block first
+            buffer = make_buffer_container<std::complex<double>>(stream, (bytes + sizeof(std::complex<double>) - 1) / sizeof(std::complex<double>));
+            num_allocations++;
+        }
+        return buffer.data();
+    }
+    //! \brief Returns the size of the block in bytes.
+    size_t capacity() const{ return buffer.size() * sizeof(std::complex<double>); }
+    //! \brief Returns the number of allocations.
+    int allocations() const{ return num_allocations; }
+    //! \brief The block of memory.
+    gpu::vector<std::complex<double>> buffer;
+    //! \brief Counts the allocations.
+    int num_allocations;
+};
+#endif
+
+/*!
+ * \ingroup hefftepool
+ * \brief Shared workspace for multiple heffte::fft3d and heffte::fft3d_r2c plans.
+ *
+ * The pool holds one block of memory in the location of the backend (CPU or GPU)
+ * and two CPU blocks for the staging of the MPI messages when GPU-aware MPI is disabled.
+ * Every plan attached with set_workspace_pool() registers the size of its workspace
+ * and the first block is allocated with the largest size, so that switching between
+ * the plans does not cause a new allocation.
+ * The blocks grow only if a larger batch is requested.
+ *
+ * Example:
+ * \code
+ *  auto pool = std::make_shared<heffte::workspace_pool<heffte::tag::cpu>>();
+ *  for(auto &fft : plans) fft.set_workspace_pool(pool);
+ *  plans[0].forward(input.data(), output.data()); // allocates the block
+ *  plans[1].forward(input.data(), output.data()); // no allocation
+ * \endcode
+ *
+ * \tparam location_tag is either tag::cpu or tag::gpu, must match the location of the backend of the plans
+ */
+template<typename location_tag>
+class workspace_pool{
+public:
+    //! \brief Creates an empty pool, the memory is allocated on the first transform.
+    workspace_pool(pool_alignment alignment = pool_alignment::cache_line) :
+        block(alignment), send_staging(std::make_shared<aligned_buffer>(alignment)),
+        recv_staging(std::make_shared<aligned_buffer>(alignment)), max_entries(0)
+    {}
+
+    //! \brief Registers a client that needs a workspace with the given number of entries (of any type).
+    void register_client(size_t num_entries){ max_entries = std::max(max_entries, num_entries); }
+
+    /*!
+     * \brief Returns a workspace with at least \b num_entries of the given type.
+     *
+     * The block has room for at least as many entries as the largest registered client,
+     * the pointer is valid until the next call to get() with a larger size.
+     */
+    template<typename scalar_type, typename stream_type>
+    scalar_type* get(stream_type stream, size_t num_entries){
+        return reinterpret_cast<scalar_type*>(block.reserve(stream, std::max(num_entries, max_entries) * sizeof(scalar_type)));
+    }
+
+    //! \brief Returns the CPU block for the staging of sent messages.
+    std::shared_ptr<aligned_buffer> const& send_buffer() const{ return send_staging; }
+    //! \brief Returns the CPU block for the staging of received messages.
+    std::shared_ptr<aligned_buffer> const& recv_buffer() const{ return recv_staging; }
+
+    //! \brief Returns the size of the workspace block in bytes.
+    size_t capacity() const{ return block.capacity(); }
+    //! \brief Returns the total number of allocations made by the pool, including the staging buffers.
+    int allocations() const{ return block.allocations() + send_staging->allocations() + recv_staging->allocations(); }
+
+private:
+    pool_block<location_tag> block;
+    std::shared_ptr<aligned_buffer> send_staging, recv_staging;
+    size_t max_entries;
+};
+
+
+/*!
+ * \ingroup hefftepool
+ * \brief Workspace that is either taken from a heffte::workspace_pool or owned by the container.
+ */
+template<typename container_type>
+struct pooled_workspace{
+    //! \brief Holds the memory if there is no pool.
+    container_type owned;
+    //! \brief Points to the workspace.
+    typename container_type::value_type *pntr;
+    //! \brief Returns the pointer to the workspace.
+    typename container_type::value_type* data() const{ return pntr; }
+};
+
+/*!
+ * \ingroup hefftepool
+ * \brief Returns a workspace with the given number of entries, uses the pool if not null or allocates a new container otherwise.
+ */
+template<typename scalar_type, typename location_tag, typename stream_type>
+pooled_workspace<decltype(make_buffer_container<scalar_type>(std::declval<stream_type>(), 0))>
+make_pooled_workspace(std::shared_ptr<workspace_pool<location_tag>> const &pool, stream_type stream, size_t num_entries){
+    pooled_workspace<decltype(make_buffer_container<scalar_type>(std::declval<stream_type>(), 0))> result;
+    if (pool){
+        result.pntr = pool->template get<scalar_type>(stream, num_entries);
+    }else{
+        result.owned = make_buffer_container<scalar_type>(stream, num_entries);
+        result.pntr = result.owned.data();
+    }
+    return result;
+}
+
+}
+
+#endif
@@ -144,6 +144,22 @@ __global__ void simple_scal(index num_entries, scalar_type data[], scalar_type s
     }
 }
 
+/*
+ * Pointwise product of complex numbers stored as pairs of reals, y = alpha * conj_sign(x) * y.
+ * Call with one thread per complex entry.
+ */
+template<typename precision_type, int num_threads, typename index>
+__global__ void simple_multiply(index num_entries, precision_type const x[], precision_type y[], precision_type sign, precision_type alpha){
+    index i = blockIdx.x * num_threads + threadIdx.x;
+    while(i < num_entries){
+        precision_type const xr = alpha * x[2*i], xi = sign * alpha * x[2*i+1];
+        precision_type const yr = y[2*i], yi = y[2*i+1];
+        y[2*i]   = xr * yr - xi * yi;
+        y[2*i+1] = xr * yi + xi * yr;
+        i += num_threads * gridDim.x;
+    }
+}
+
 #define BLK_X 256
 
 // DCT-II (REDFT10)
@@ -479,6 +495,18 @@ template void scale_data<double, int>(cudaStream_t, int num_entries, double *dat
 template void scale_data<float, long long>(cudaStream_t, long long num_entries, float *data, double scale_factor);
 template void scale_data<double, long long>(cudaStream_t, long long num_entries, double *data, double scale_factor);
 
+template<typename precision_type, typename index>
+void multiply_data(cudaStream_t stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                   bool conjugate, double scale_factor){
+    thread_grid_1d grid(num_entries, max_threads);
+    simple_multiply<precision_type, max_threads><<<grid.blocks, grid.threads, 0, stream>>>(
+        num_entries, reinterpret_cast<precision_type const*>(x), reinterpret_cast<precision_type*>(y),
+        static_cast<precision_type>((conjugate) ? -1.0 : 1.0), static_cast<precision_type>(scale_factor));
+}
+
+template void multiply_data<float, long long>(cudaStream_t, long long, std::complex<float> const[], std::complex<float>[], bool, double);
+template void multiply_data<double, long long>(cudaStream_t, long long, std::complex<double> const[], std::complex<double>[], bool, double);
+
 template<typename precision>
 void cos_pre_pos_processor::pre_forward(cudaStream_t stream, int length, precision const input[], precision fft_signal[]){
     dim3 threads( BLK_X, 1 );
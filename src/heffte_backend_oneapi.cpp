@@ -52,6 +52,7 @@ template<typename scalar_type, typename index> struct heffte_transpose_unpack_ke
 template<typename scalar_type, typename index> struct heffte_transpose_unpack_kernel201{};
 template<typename scalar_type, typename index> struct heffte_transpose_unpack_kernel210{};
 template<typename scalar_type, typename index> struct heffte_scale_data_kernel{};
+template<typename precision_type, typename index> struct heffte_multiply_data_kernel{};
 
 template<typename precision_type, typename index>
 void convert(sycl::queue &stream, index num_entries, precision_type const source[], std::complex<precision_type> destination[]){
@@ -234,6 +235,27 @@ template void scale_data<double, int>(sycl::queue&, int num_entries, double *dat
 template void scale_data<float, long long>(sycl::queue&, long long num_entries, float *data, double scale_factor);
 template void scale_data<double, long long>(sycl::queue&, long long num_entries, double *data, double scale_factor);
 
+template<typename precision_type, typename index>
+void multiply_data(sycl::queue &stream, index num_entries, std::complex<precision_type> const x[], std::complex<precision_type> y[],
+                   bool conjugate, double scale_factor){
+    precision_type const *px = reinterpret_cast<precision_type const*>(x);
+    precision_type *py = reinterpret_cast<precision_type*>(y);
+    precision_type const sign  = (conjugate) ? -1.0 : 1.0;
+    precision_type const alpha = static_cast<precision_type>(scale_factor);
+    stream.submit([&](sycl::handler& h){
+        h.parallel_for<heffte_multiply_data_kernel<precision_type, index>>(
+            sycl::range<1>{static_cast<size_t>(num_entries),}, [=](sycl::id<1> i){
+                precision_type const xr = alpha * px[2*i[0]], xi = sign * alpha * px[2*i[0]+1];
+                precision_type const yr = py[2*i[0]], yi = py[2*i[0]+1];
+                py[2*i[0]]   = xr * yr - xi * yi;
+                py[2*i[0]+1] = xr * yi + xi * yr;
+            });
+    }).wait();
+}
+
+template void multiply_data<float, long long>(sycl::queue&, long long, std::complex<float> const[], std::complex<float>[], bool, double);
+template void multiply_data<double, long long>(sycl::queue&, long long, std::complex<double> const[], std::complex<double>[], bool, double);
+
 template<typename precision> struct heffte_cos_pre_forward_kernel{};
 template<typename precision> struct heffte_cos_post_forward_kernel{};
 template<typename precision> struct heffte_cos_pre_backward_kernel{};
@@ -93,6 +93,8 @@ namespace heffte{
     struct size_workspace_tag{};
     struct forward_tag{};
     struct backward_tag{};
+    struct forward_async_tag{};
+    struct backward_async_tag{};
 
     template<typename fftclass>
     int call_returnable_c_template(fftclass const *fft, size_inbox_tag const){
@@ -121,6 +123,26 @@ namespace heffte{
         return 0;
     }
 
+    template<typename fftclass, typename input_type, typename output_type, typename workspace_type>
+    int call_returnable_c_template(fftclass const *fft, forward_async_tag const, input_type const input[], output_type output[],
+                                   workspace_type workspace[], scale scaling, heffte_request *request){
+        if (workspace == nullptr)
+            *request = reinterpret_cast<heffte_request>(new fft_request(fft->forward_async(input, output, scaling)));
+        else
+            *request = reinterpret_cast<heffte_request>(new fft_request(fft->forward_async(input, output, workspace, scaling)));
+        return 0;
+    }
+
+    template<typename fftclass, typename input_type, typename output_type, typename workspace_type>
+    int call_returnable_c_template(fftclass const *fft, backward_async_tag const, input_type const input[], output_type output[],
+                                   workspace_type workspace[], scale scaling, heffte_request *request){
+        if (workspace == nullptr)
+            *request = reinterpret_cast<heffte_request>(new fft_request(fft->backward_async(input, output, scaling)));
+        else
+            *request = reinterpret_cast<heffte_request>(new fft_request(fft->backward_async(input, output, workspace, scaling)));
+        return 0;
+    }
+
     template<typename fname, typename... vars>
     int call_returnable_c(heffte_plan const plan, vars... args){
         if (plan->using_r2c){
@@ -495,4 +517,76 @@ void heffte_backward_z2z_buffered(heffte_plan const plan, void const *in, void *
     heffte::call_returnable_c_nor2c<heffte::backward_tag>(plan, input, output, workspace, scaling);
 }
 
+void heffte_forward_s2c_async(heffte_plan const plan, float const *input, void *o, void *w, int s, heffte_request *request){
+    std::complex<float> *output = reinterpret_cast<std::complex<float>*>(o);
+    std::complex<float> *workspace = reinterpret_cast<std::complex<float>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c<heffte::forward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+void heffte_forward_c2c_async(heffte_plan const plan, void const *in, void *o, void *w, int s, heffte_request *request){
+    std::complex<float> const *input = reinterpret_cast<std::complex<float> const*>(in);
+    std::complex<float> *output = reinterpret_cast<std::complex<float>*>(o);
+    std::complex<float> *workspace = reinterpret_cast<std::complex<float>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c_nor2c<heffte::forward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+void heffte_forward_d2z_async(heffte_plan const plan, double const *input, void *o, void *w, int s, heffte_request *request){
+    std::complex<double> *output = reinterpret_cast<std::complex<double>*>(o);
+    std::complex<double> *workspace = reinterpret_cast<std::complex<double>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c<heffte::forward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+void heffte_forward_z2z_async(heffte_plan const plan, void const *in, void *o, void *w, int s, heffte_request *request){
+    std::complex<double> const *input = reinterpret_cast<std::complex<double> const*>(in);
+    std::complex<double> *output = reinterpret_cast<std::complex<double>*>(o);
+    std::complex<double> *workspace = reinterpret_cast<std::complex<double>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c_nor2c<heffte::forward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+
+void heffte_backward_c2s_async(heffte_plan const plan, void const *in, float *output, void *w, int s, heffte_request *request){
+    std::complex<float> const *input = reinterpret_cast<std::complex<float> const*>(in);
+    std::complex<float> *workspace = reinterpret_cast<std::complex<float>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c<heffte::backward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+void heffte_backward_c2c_async(heffte_plan const plan, void const *in, void *o, void *w, int s, heffte_request *request){
+    std::complex<float> const *input = reinterpret_cast<std::complex<float> const*>(in);
+    std::complex<float> *output = reinterpret_cast<std::complex<float>*>(o);
+    std::complex<float> *workspace = reinterpret_cast<std::complex<float>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c_nor2c<heffte::backward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+void heffte_backward_z2d_async(heffte_plan const plan, void const *in, double *output, void *w, int s, heffte_request *request){
+    std::complex<double> const *input = reinterpret_cast<std::complex<double> const*>(in);
+    std::complex<double> *workspace = reinterpret_cast<std::complex<double>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c<heffte::backward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+void heffte_backward_z2z_async(heffte_plan const plan, void const *in, void *o, void *w, int s, heffte_request *request){
+    std::complex<double> const *input = reinterpret_cast<std::complex<double> const*>(in);
+    std::complex<double> *output = reinterpret_cast<std::complex<double>*>(o);
+    std::complex<double> *workspace = reinterpret_cast<std::complex<double>*>(w);
+    heffte::scale scaling = heffte::get_scaling_c(s);
+    heffte::call_returnable_c_nor2c<heffte::backward_async_tag>(plan, input, output, workspace, scaling, request);
+}
+
+int heffte_request_test(heffte_request *request){
+    if (*request == nullptr) return 1;
+    heffte::fft_request *r = reinterpret_cast<heffte::fft_request*>(*request);
+    if (r->test()){
+        delete r;
+        *request = nullptr;
+        return 1;
+    }
+    return 0;
+}
+void heffte_request_wait(heffte_request *request){
+    if (*request == nullptr) return;
+    heffte::fft_request *r = reinterpret_cast<heffte::fft_request*>(*request);
+    r->wait();
+    delete r;
+    *request = nullptr;
+}
+
 } // extern "C"
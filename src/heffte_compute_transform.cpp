@@ -10,58 +10,263 @@
 
 #include "heffte_compute_transform.h"
 
+#include <thread>
+#include <atomic>
+
 namespace heffte {
 
+struct fft_request::progress_state{
+    //! \brief Constructor, takes ownership of the stages and the workspace.
+    progress_state(transform_schedule &&cstages, std::shared_ptr<void> &&cowner, int cnum_threads) :
+        stages(std::move(cstages)), next_stage(0), workspace_owner(std::move(cowner)), num_threads(cnum_threads), complete(false)
+    {}
+    //! \brief Runs the stages until a reshape is waiting on communication, returns true if all stages are complete.
+    bool advance(){
+        thread_scope threads(num_threads);
+        while(true){
+            if (pending.request != MPI_REQUEST_NULL){
+                int flag = 0;
+                MPI_Test(&pending.request, &flag, MPI_STATUS_IGNORE);
+                if (flag == 0) return false;
+            }
+            if (pending.finish){
+                std::function<void()> finish = std::move(pending.finish);
+                pending = reshape_pending();
+                finish();
+            }
+            if (next_stage == stages.size()){
+                complete = true;
+                return true;
+            }
+            stages[next_stage++](pending);
+        }
+    }
+    //! \brief Blocks on the communication until all stages are complete.
+    void complete_all(){
+        while(not advance()){
+            add_trace name("wait");
+            MPI_Wait(&pending.request, MPI_STATUS_IGNORE);
+        }
+    }
+
+    transform_schedule stages;
+    size_t next_stage;
+    reshape_pending pending;
+    std::shared_ptr<void> workspace_owner;
+    int num_threads;
+    std::atomic<bool> complete;
+    std::thread helper;
+    std::exception_ptr helper_error;
+};
+
+fft_request::fft_request(){}
+
+fft_request::fft_request(transform_schedule &&stages, std::shared_ptr<void> workspace_owner, int num_threads) :
+    state(new progress_state(std::move(stages), std::move(workspace_owner), num_threads))
+{
+    state->advance(); // start the first reshape
+}
+
+fft_request::fft_request(fft_request &&other) : state(std::move(other.state)){}
+
+fft_request& fft_request::operator = (fft_request &&other){
+    if (this != &other){
+        wait();
+        state = std::move(other.state);
+    }
+    return *this;
+}
+
+fft_request::~fft_request(){
+    if (state){
+        if (state->helper.joinable()) state->helper.join();
+        if (not state->complete) state->complete_all();
+    }
+}
+
+bool fft_request::test(){
+    if (not state) return true;
+    if (state->helper.joinable()) return state->complete;
+    return state->advance();
+}
+
+void fft_request::wait(){
+    if (not state) return;
+    if (state->helper.joinable()){
+        state->helper.join();
+        if (state->helper_error){
+            std::exception_ptr error = state->helper_error;
+            state->helper_error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+    state->complete_all();
+}
+
+void fft_request::progress_in_background(){
+    if (not state or state->complete or state->helper.joinable()) return;
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided != MPI_THREAD_MULTIPLE)
+        throw std::runtime_error("fft_request::progress_in_background() requires MPI initialized with MPI_THREAD_MULTIPLE");
+    progress_state *s = state.get();
+    s->helper = std::thread([s]()->void{
+        try{
+            while(not s->advance()) std::this_thread::yield();
+        }catch(...){
+            s->helper_error = std::current_exception();
+            s->complete = true;
+        }
+    });
+}
+
+/*!
+ * \internal
+ * \brief Applies the reshape immediately or adds the reshape as a stage to the schedule.
+ * \endinternal
+ */
+template<typename index, typename scalar_type>
+void reshape_stage(transform_schedule *schedule, reshape3d_base<index> const *shaper, int const batch_size,
+                   scalar_type const input[], scalar_type output[], scalar_type workspace[]){
+    if (schedule == nullptr){
+        add_trace name("reshape");
+        shaper->apply(batch_size, input, output, workspace);
+    }else{
+        schedule->push_back([=](reshape_pending &pending)->void{
+            add_trace name("reshape");
+            shaper->start(batch_size, input, output, workspace, pending);
+        });
+    }
+}
+
+/*!
+ * \internal
+ * \brief Performs the operation immediately or adds the operation as a stage to the schedule.
+ * \endinternal
+ */
+template<typename operation_type>
+void compute_stage(transform_schedule *schedule, operation_type operation){
+    if (schedule == nullptr){
+        operation();
+    }else{
+        schedule->push_back([=](reshape_pending&)->void{ operation(); });
+    }
+}
+
+/*!
+ * \internal
+ * \brief Returns the destination buffers of a sequence of reshapes in the low-memory mode.
+ *
+ * The reshapes are never applied in-place, the data alternates between the temp and swap buffers
+ * and the last reshape writes into the \b last buffer.
+ * The reshape into the last buffer always reads from the temp buffer, since the swap buffer can be the same as the last buffer.
+ * \endinternal
+ */
+template<typename scalar_type>
+std::vector<scalar_type*> alternate_buffers(int num_reshapes, scalar_type temp_buffer[], scalar_type swap_buffer[], scalar_type last[]){
+    std::vector<scalar_type*> buffers(num_reshapes, last);
+    for(int i=num_reshapes-2; i>=0; i--)
+        buffers[i] = ((num_reshapes - i) % 2 == 0) ? temp_buffer : swap_buffer;
+    return buffers;
+}
+
+/*!
+ * \internal
+ * \brief Returns the indexes of the active shapers in the range [first, last).
+ * \endinternal
+ */
+template<typename index>
+std::vector<int> active_shapers(std::array<reshape3d_base<index>*, 4> const &shaper, int first, int last){
+    std::vector<int> active;
+    for(int i=first; i<last; i++) if (shaper[i]) active.push_back(i);
+    return active;
+}
+
 template<typename location_tag, typename index, typename scalar_type>
 void compute_transform(typename backend::data_manipulator<location_tag>::stream_type stream,
                        int const batch_size,
                        scalar_type const input[], scalar_type output[], scalar_type workspace[],
                        size_t executor_buffer_offset, size_t size_comm_buffers,
-                       std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper,
+                       std::array<reshape3d_base<index>*, 4> const &shaper,
                        std::array<executor_base*, 3> const &executor,
-                       direction dir){
+                       direction dir, transform_schedule *schedule, scalar_type swap_buffer[]){
 
     /*
      * The logic is a bit messy, but the objective is:
      * - call all shaper and executor objects in the correct order
-     * - assume that any or all of the shapers can be missing, i.e., null unique_ptr()
+     * - assume that any or all of the shapers can be missing, i.e., null pointers
      * - do not allocate buffers if not needed
      * - never have more than 2 allocated buffers (input and output)
+     * The operations are either performed immediately or added to the schedule,
+     * thus all variables used in the stages are captured by value.
      */
 
     scalar_type *executor_workspace = (executor_buffer_offset == 0) ? nullptr : workspace + batch_size * executor_buffer_offset;
 
-    auto apply_fft = [&](int i, scalar_type data[])
+    auto apply_fft = [=](int i, scalar_type data[])
         ->void{
             add_trace name("fft-1d");
             if (dir == direction::forward){
-                if (executor[i] != nullptr){
-                    for(int j=0; j<batch_size; j++)
-                        executor[i]->forward(data + j * executor[i]->box_size(), executor_workspace);
-                }
+                if (executor[i] != nullptr)
+                    executor[i]->forward(batch_size, data, executor_workspace);
             }else{
-                if (executor[i] != nullptr){
-                    for(int j=0; j<batch_size; j++)
-                        executor[i]->backward(data + j * executor[i]->box_size(), executor_workspace);
-                }
+                if (executor[i] != nullptr)
+                    executor[i]->backward(batch_size, data, executor_workspace);
             }
         };
+    auto fft_stage = [&](int i, scalar_type data[])
+        ->void{
+            compute_stage(schedule, [=]()->void{ apply_fft(i, data); });
+        };
+    auto copy_stage = [&](scalar_type const source[], size_t num_entries, scalar_type destination[])
+        ->void{
+            compute_stage(schedule, [=]()->void{
+                add_trace name("copy");
+                backend::data_manipulator<location_tag>::copy_n(stream, source, num_entries, destination);
+            });
+        };
 
     int num_active = count_active(shaper);
     int last = get_last_active(shaper);
 
+    if (swap_buffer != nullptr and num_active > 0){
+        // low-memory mode, the data alternates between the temp and swap buffers and the swap buffer can be the output
+        scalar_type *temp_buffer = workspace + batch_size * size_comm_buffers;
+        std::vector<int> const active = active_shapers(shaper, 0, 4);
+        std::vector<scalar_type*> const destination = alternate_buffers(num_active, temp_buffer, swap_buffer, output);
+
+        // the transforms before the first reshape need a writable buffer different from the destination of the reshape
+        scalar_type const *source = input;
+        if (active[0] > 0 or input == destination[0]){
+            scalar_type *first = output;
+            if (input != output or output == destination[0]){
+                first = (destination[0] != temp_buffer) ? temp_buffer : swap_buffer;
+                copy_stage(input, batch_size * shaper[active[0]]->size_intput(), first);
+            }
+            for(int i=0; i<active[0]; i++)
+                fft_stage(i, first);
+            source = first;
+        }
+        for(int j=0; j<num_active; j++){
+            reshape_stage(schedule, shaper[active[j]], batch_size, source, destination[j], workspace);
+            for(int i=active[j]; i<((j + 1 < num_active) ? active[j+1] : 3); i++)
+                fft_stage(i, destination[j]);
+            source = destination[j];
+        }
+        return;
+    }
+
     if (last < 1){ // no extra buffer case
-        add_trace name("reshape/copy");
         // move input -> output and apply all ffts
         // use either zeroth shaper or simple copy (or nothing in case of in-place transform)
         if (last == 0){
-            shaper[0]->apply(batch_size, input, output, workspace);
+            reshape_stage(schedule, shaper[0], batch_size, input, output, workspace);
         }else if (input != output){
             int valid_executor = (executor[0] != nullptr) ? 0 : ((executor[1] != nullptr) ? 1 : 2);
-            backend::data_manipulator<location_tag>::copy_n(stream, input, batch_size * executor[valid_executor]->box_size(), output);
+            copy_stage(input, batch_size * executor[valid_executor]->box_size(), output);
         }
         for(int i=0; i<3; i++)
-            apply_fft(i, output);
+            fft_stage(i, output);
 
         return;
     }
@@ -71,18 +276,15 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
     if (num_active == 1){ // one active and not shaper 0
         scalar_type *effective_input = output;
         if (input != output){
-            add_trace name("copy");
             if (executor[0] != nullptr)
-                backend::data_manipulator<location_tag>::copy_n(stream, input, batch_size * executor[0]->box_size(), temp_buffer);
+                copy_stage(input, batch_size * executor[0]->box_size(), temp_buffer);
             effective_input = temp_buffer;
         }
         for(int i=0; i<last; i++)
-            apply_fft(i, effective_input);
-        { add_trace name("reshape");
-        shaper[last]->apply(batch_size, effective_input, output, workspace);
-        }
+            fft_stage(i, effective_input);
+        reshape_stage(schedule, shaper[last], batch_size, effective_input, output, workspace);
         for(int i=last; i<3; i++)
-            apply_fft(i, output);
+            fft_stage(i, output);
 
         return;
     }
@@ -91,39 +293,31 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
     int active_shaper = 0;
     if (shaper[0] or input != output){
         if (shaper[0]){
-            add_trace name("reshape");
-            shaper[0]->apply(batch_size, input, temp_buffer, workspace);
+            reshape_stage(schedule, shaper[0], batch_size, input, temp_buffer, workspace);
         }else{
-            add_trace name("copy");
-            backend::data_manipulator<location_tag>::copy_n(stream, input, batch_size * executor[0]->box_size(), temp_buffer);
+            copy_stage(input, batch_size * executor[0]->box_size(), temp_buffer);
         }
         active_shaper = 1;
     }else{
         // in place transform and shaper[0] is not active
         while(not shaper[active_shaper]){
             // note, at least one shaper must be active, otherwise last will catch it
-            apply_fft(active_shaper++, output);
-        }
-        { add_trace name("reshape");
-        shaper[active_shaper]->apply(batch_size, output, temp_buffer, workspace);
+            fft_stage(active_shaper++, output);
         }
+        reshape_stage(schedule, shaper[active_shaper], batch_size, static_cast<scalar_type const*>(output), temp_buffer, workspace);
         active_shaper += 1;
     }
-    apply_fft(active_shaper - 1, temp_buffer); // one reshape was applied above
+    fft_stage(active_shaper - 1, temp_buffer); // one reshape was applied above
 
     for(int i=active_shaper; i<last; i++){
-        if (shaper[i]){
-            add_trace name("reshape");
-            shaper[i]->apply(batch_size, temp_buffer, temp_buffer, workspace);
-        }
-        apply_fft(i, temp_buffer);
-    }
-    { add_trace name("reshape");
-    shaper[last]->apply(batch_size, temp_buffer, output, workspace);
+        if (shaper[i])
+            reshape_stage(schedule, shaper[i], batch_size, static_cast<scalar_type const*>(temp_buffer), temp_buffer, workspace);
+        fft_stage(i, temp_buffer);
     }
+    reshape_stage(schedule, shaper[last], batch_size, static_cast<scalar_type const*>(temp_buffer), output, workspace);
 
     for(int i=last; i<3; i++)
-        apply_fft(i, output);
+        fft_stage(i, output);
 }
 
 template<typename location_tag, typename index, typename scalar_type>
@@ -132,8 +326,9 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
                        scalar_type const input[], std::complex<scalar_type> output[],
                        std::complex<scalar_type> workspace[],
                        size_t executor_buffer_offset, size_t size_comm_buffers,
-                       std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper,
-                       std::array<executor_base*, 3> const &executor, direction){
+                       std::array<reshape3d_base<index>*, 4> const &shaper,
+                       std::array<executor_base*, 3> const &executor, direction, transform_schedule *schedule,
+                       std::complex<scalar_type> swap_buffer[]){
     /*
      * Follows logic similar to the complex-to-complex case but the first shaper and executor will be applied to real data.
      */
@@ -141,58 +336,90 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
     std::complex<scalar_type> *executor_workspace = (executor_buffer_offset == 0) ?
                                                     nullptr : workspace + batch_size * executor_buffer_offset;
 
+    if (swap_buffer != nullptr){
+        // low-memory mode, see the complex-to-complex case
+        std::complex<scalar_type> *temp_buffer = workspace + batch_size * size_comm_buffers;
+        std::vector<int> const active = active_shapers(shaper, 1, 4);
+        int const num_reshapes = static_cast<int>(active.size());
+        std::vector<std::complex<scalar_type>*> const destination = alternate_buffers(num_reshapes, temp_buffer, swap_buffer, output);
+
+        // the result of the real-to-complex transform and the reshaped real input use different buffers
+        std::complex<scalar_type> *first = (num_reshapes == 0) ? output : ((destination[0] != temp_buffer) ? temp_buffer : swap_buffer);
+        scalar_type *reshaped_input = reinterpret_cast<scalar_type*>((first != temp_buffer) ? temp_buffer : swap_buffer);
+
+        scalar_type const *effective_input = input;
+        if (shaper[0]){
+            reshape_stage(schedule, shaper[0], batch_size, input, reshaped_input, reinterpret_cast<scalar_type*>(workspace));
+            effective_input = reshaped_input;
+        }
+        compute_stage(schedule, [=]()->void{
+            add_trace name("fft-1d");
+            if (executor[0] != nullptr)
+                executor[0]->forward(batch_size, effective_input, first, executor_workspace);
+        });
+        auto fft_stage = [&](int i, std::complex<scalar_type> data[])
+            ->void{
+                compute_stage(schedule, [=]()->void{
+                    add_trace name("fft-1d");
+                    if (executor[i] != nullptr)
+                        executor[i]->forward(batch_size, data, executor_workspace);
+                });
+            };
+
+        for(int i=1; i<((num_reshapes > 0) ? active[0] : 3); i++)
+            fft_stage(i, first);
+        std::complex<scalar_type> const *source = first;
+        for(int j=0; j<num_reshapes; j++){
+            reshape_stage(schedule, shaper[active[j]], batch_size, source, destination[j], workspace);
+            for(int i=active[j]; i<((j + 1 < num_reshapes) ? active[j+1] : 3); i++)
+                fft_stage(i, destination[j]);
+            source = destination[j];
+        }
+        return;
+    }
+
     scalar_type* reshaped_input = reinterpret_cast<scalar_type*>(workspace);
     scalar_type const *effective_input = input; // either input or the result of reshape operation 0
     if (shaper[0]){
-        add_trace name("reshape");
-        shaper[0]->apply(batch_size, input, reshaped_input,
-                         reinterpret_cast<scalar_type*>(workspace + batch_size * get_max_box_size(executor)));
+        reshape_stage(schedule, shaper[0], batch_size, input, reshaped_input,
+                      reinterpret_cast<scalar_type*>(workspace + batch_size * get_max_box_size(executor)));
         effective_input = reshaped_input;
     }
 
     if (last < 1){ // no reshapes after 0
-        add_trace name("fft-1d x3");
-        for(int j=0; j<batch_size; j++){
-            if (executor[0] != nullptr) executor[0]->forward(effective_input + j * executor[0]->box_size(),
-                                                             output + j * executor[0]->complex_size(), executor_workspace);
-            if (executor[1] != nullptr) executor[1]->forward(output + j * executor[0]->box_size(), executor_workspace);
-            if (executor[2] != nullptr) executor[2]->forward(output + j * executor[0]->box_size(), executor_workspace);
-        }
+        compute_stage(schedule, [=]()->void{
+            add_trace name("fft-1d x3");
+            if (executor[0] != nullptr) executor[0]->forward(batch_size, effective_input, output, executor_workspace);
+            if (executor[1] != nullptr) executor[1]->forward(batch_size, output, executor_workspace);
+            if (executor[2] != nullptr) executor[2]->forward(batch_size, output, executor_workspace);
+        });
         return;
     }
 
     // if there is messier combination of transforms, then we need internal buffers
     std::complex<scalar_type> *temp_buffer = workspace + batch_size * size_comm_buffers;
-    { add_trace name("fft-1d");
-        if (executor[0] != nullptr){
-            for(int j=0; j<batch_size; j++)
-                executor[0]->forward(effective_input + j * executor[0]->box_size(),
-                                     temp_buffer + j * executor[0]->complex_size(), executor_workspace);
-        }
-    }
+    auto apply_fft = [=](int i, std::complex<scalar_type> data[])
+        ->void{
+            add_trace name("fft-1d");
+            if (executor[i] != nullptr)
+                executor[i]->forward(batch_size, data, executor_workspace);
+        };
 
-    for(int i=1; i<last; i++){
-        if (shaper[i]){
-            add_trace name("reshape");
-            shaper[i]->apply(batch_size, temp_buffer, temp_buffer, workspace);
-        }
+    compute_stage(schedule, [=]()->void{
         add_trace name("fft-1d");
-        if (executor[i] != nullptr){
-            for(int j=0; j<batch_size; j++)
-                executor[i]->forward(temp_buffer + j * executor[i]->box_size(), executor_workspace);
-        }
-    }
-    { add_trace name("reshape");
-        shaper[last]->apply(batch_size, temp_buffer, output, workspace);
-    }
+        if (executor[0] != nullptr)
+            executor[0]->forward(batch_size, effective_input, temp_buffer, executor_workspace);
+    });
 
-    for(int i=last; i<3; i++){
-        add_trace name("fft-1d");
-        if (executor[i] != nullptr){
-            for(int j=0; j<batch_size; j++)
-                executor[i]->forward(output + j * executor[i]->box_size(), executor_workspace);
-        }
+    for(int i=1; i<last; i++){
+        if (shaper[i])
+            reshape_stage(schedule, shaper[i], batch_size, static_cast<std::complex<scalar_type> const*>(temp_buffer), temp_buffer, workspace);
+        compute_stage(schedule, [=]()->void{ apply_fft(i, temp_buffer); });
     }
+    reshape_stage(schedule, shaper[last], batch_size, static_cast<std::complex<scalar_type> const*>(temp_buffer), output, workspace);
+
+    for(int i=last; i<3; i++)
+        compute_stage(schedule, [=]()->void{ apply_fft(i, output); });
 }
 template<typename location_tag, typename index, typename scalar_type>
 void compute_transform(typename backend::data_manipulator<location_tag>::stream_type stream,
@@ -200,8 +427,9 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
                        std::complex<scalar_type> const input[], scalar_type output[],
                        std::complex<scalar_type> workspace[],
                        size_t executor_buffer_offset, size_t size_comm_buffers,
-                       std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper,
-                       std::array<executor_base*, 3> const &executor, direction){
+                       std::array<reshape3d_base<index>*, 4> const &shaper,
+                       std::array<executor_base*, 3> const &executor, direction, transform_schedule *schedule,
+                       std::complex<scalar_type> swap_buffer[]){
     /*
      * Follows logic similar to the complex-to-complex case but the last shaper and executor will be applied to real data.
      */
@@ -209,27 +437,82 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
     std::complex<scalar_type> *executor_workspace = (executor_buffer_offset == 0) ?
                                                      nullptr : workspace + batch_size * executor_buffer_offset;
 
+    if (swap_buffer != nullptr){
+        // low-memory mode, see the complex-to-complex case, the output cannot hold the complex stages
+        std::vector<int> const active = active_shapers(shaper, 0, 3);
+        int const num_reshapes = static_cast<int>(active.size());
+        // the extra entry stands for the complex-to-real transform, so the last reshape writes into the temp buffer
+        std::vector<std::complex<scalar_type>*> const destination = alternate_buffers(num_reshapes + 1, temp_buffer, swap_buffer, swap_buffer);
+
+        auto fft_stage = [&](int i, std::complex<scalar_type> data[])
+            ->void{
+                compute_stage(schedule, [=]()->void{
+                    add_trace name("fft-1d");
+                    if (executor[i] != nullptr)
+                        executor[i]->backward(batch_size, data, executor_workspace);
+                });
+            };
+
+        std::complex<scalar_type> const *source = input;
+        std::complex<scalar_type> *complex_result = nullptr;
+        if (not shaper[0]){
+            complex_result = (num_reshapes == 0 or destination[0] != temp_buffer) ? temp_buffer : swap_buffer;
+            int valid_executor = (executor[0] != nullptr) ? 0 : ((executor[1] != nullptr) ? 1 : 2);
+            size_t const num_entries = batch_size * executor[valid_executor]->box_size();
+            compute_stage(schedule, [=]()->void{
+                add_trace name("copy");
+                backend::data_manipulator<location_tag>::copy_n(stream, input, num_entries, complex_result);
+            });
+            for(int i=0; i<((num_reshapes > 0) ? active[0] : 2); i++)
+                fft_stage(i, complex_result);
+            source = complex_result;
+        }
+        for(int j=0; j<num_reshapes; j++){
+            reshape_stage(schedule, shaper[active[j]], batch_size, source, destination[j], workspace);
+            for(int i=active[j]; i<((j + 1 < num_reshapes) ? active[j+1] : 2); i++)
+                fft_stage(i, destination[j]);
+            source = destination[j];
+            complex_result = destination[j];
+        }
+
+        if (shaper[3]){
+            scalar_type *real_buffer = reinterpret_cast<scalar_type*>((complex_result != temp_buffer) ? temp_buffer : swap_buffer);
+            compute_stage(schedule, [=]()->void{
+                add_trace name("fft-1d");
+                if (executor[2] != nullptr)
+                    executor[2]->backward(batch_size, complex_result, real_buffer, executor_workspace);
+            });
+            reshape_stage(schedule, shaper[3], batch_size, static_cast<scalar_type const*>(real_buffer), output,
+                          reinterpret_cast<scalar_type*>(workspace));
+        }else{
+            compute_stage(schedule, [=]()->void{
+                add_trace name("fft-1d");
+                if (executor[2] != nullptr)
+                    executor[2]->backward(batch_size, complex_result, output, executor_workspace);
+            });
+        }
+        return;
+    }
+
     if (shaper[0]){
-        add_trace name("reshape");
-        shaper[0]->apply(batch_size, input, temp_buffer, workspace);
+        reshape_stage(schedule, shaper[0], batch_size, input, temp_buffer, workspace);
     }else{
-        add_trace name("copy");
         int valid_executor = (executor[0] != nullptr) ? 0 : ((executor[1] != nullptr) ? 1 : 2);
-        backend::data_manipulator<location_tag>::copy_n(stream, input,
-                                                        batch_size * executor[valid_executor]->box_size(), temp_buffer);
+        size_t const num_entries = batch_size * executor[valid_executor]->box_size();
+        compute_stage(schedule, [=]()->void{
+            add_trace name("copy");
+            backend::data_manipulator<location_tag>::copy_n(stream, input, num_entries, temp_buffer);
+        });
     }
 
     for(int i=0; i<2; i++){ // apply the two complex-to-complex ffts
-        { add_trace name("fft-1d x3");
-            if (executor[i] != nullptr){
-                for(int j=0; j<batch_size; j++)
-                    executor[i]->backward(temp_buffer + j * executor[i]->box_size(), executor_workspace);
-            }
-        }
-        if (shaper[i+1]){
-            add_trace name("reshape");
-            shaper[i+1]->apply(batch_size, temp_buffer, temp_buffer, workspace);
-        }
+        compute_stage(schedule, [=]()->void{
+            add_trace name("fft-1d x3");
+            if (executor[i] != nullptr)
+                executor[i]->backward(batch_size, temp_buffer, executor_workspace);
+        });
+        if (shaper[i+1])
+            reshape_stage(schedule, shaper[i+1], batch_size, static_cast<std::complex<scalar_type> const*>(temp_buffer), temp_buffer, workspace);
     }
 
     // the result of the first two ffts and three reshapes is stored in temp_buffer
@@ -237,23 +520,19 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
     if (shaper[3]){
         // there is one more reshape left, transform into a real temporary buffer
         scalar_type* real_buffer = reinterpret_cast<scalar_type*>(workspace);
-        { add_trace name("fft-1d");
-            if (executor[2] != nullptr){
-                for(int j=0; j<batch_size; j++)
-                    executor[2]->backward(temp_buffer + j * executor[2]->complex_size(),
-                                          real_buffer + j * executor[2]->box_size(), executor_workspace);
-            }
-        }
-        add_trace name("reshape");
-        shaper[3]->apply(batch_size, real_buffer, output, reinterpret_cast<scalar_type*>(workspace +
-                         batch_size * ((executor[2] == nullptr) ? 0 : executor[2]->box_size()) ));
+        compute_stage(schedule, [=]()->void{
+            add_trace name("fft-1d");
+            if (executor[2] != nullptr)
+                executor[2]->backward(batch_size, temp_buffer, real_buffer, executor_workspace);
+        });
+        reshape_stage(schedule, shaper[3], batch_size, static_cast<scalar_type const*>(real_buffer), output,
+                      reinterpret_cast<scalar_type*>(workspace + batch_size * ((executor[2] == nullptr) ? 0 : executor[2]->box_size()) ));
     }else{
-        add_trace name("fft-1d");
-        if (executor[2] != nullptr){
-            for(int j=0; j<batch_size; j++)
-                executor[2]->backward(temp_buffer + j * executor[2]->complex_size(),
-                                      output + j * executor[2]->box_size(), executor_workspace);
-        }
+        compute_stage(schedule, [=]()->void{
+            add_trace name("fft-1d");
+            if (executor[2] != nullptr)
+                executor[2]->backward(batch_size, temp_buffer, output, executor_workspace);
+        });
     }
 }
 
@@ -262,54 +541,54 @@ void compute_transform(typename backend::data_manipulator<location_tag>::stream_
                         typename backend::data_manipulator<location_tag>::stream_type, int const, \
                         std::complex<float> const input[], std::complex<float> output[], std::complex<float> workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
                         std::array<executor_base*, 3> const &executor, \
-                        direction dir); \
+                        direction dir, transform_schedule*, std::complex<float>*); \
     template void compute_transform<location_tag, index, std::complex<double>>( \
                         typename backend::data_manipulator<location_tag>::stream_type, int const, \
                         std::complex<double> const input[], std::complex<double> output[], std::complex<double> workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
                         std::array<executor_base*, 3> const &executor, \
-                        direction dir); \
+                        direction dir, transform_schedule*, std::complex<double>*); \
     template void compute_transform<location_tag, index, float>( \
                         typename backend::data_manipulator<location_tag>::stream_type, int const, \
                         float const input[], float output[], float workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
                         std::array<executor_base*, 3> const &executor, \
-                        direction dir); \
+                        direction dir, transform_schedule*, float*); \
     template void compute_transform<location_tag, index, double>( \
                         typename backend::data_manipulator<location_tag>::stream_type, int const, \
                         double const input[], double output[], double workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
                         std::array<executor_base*, 3> const &executor, \
-                        direction dir); \
+                        direction dir, transform_schedule*, double*); \
     template void compute_transform<location_tag, index, float>( \
                         typename backend::data_manipulator<location_tag>::stream_type stream, int const, \
                         float const input[], std::complex<float> output[], std::complex<float> workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
-                        std::array<executor_base*, 3> const &executor, direction); \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
+                        std::array<executor_base*, 3> const &executor, direction, transform_schedule*, std::complex<float>*); \
     template void compute_transform<location_tag, index, double>( \
                         typename backend::data_manipulator<location_tag>::stream_type stream, int const, \
                         double const input[], std::complex<double> output[], std::complex<double> workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
-                        std::array<executor_base*, 3> const &executor, direction); \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
+                        std::array<executor_base*, 3> const &executor, direction, transform_schedule*, std::complex<double>*); \
     template void compute_transform<location_tag, index, float>( \
                         typename backend::data_manipulator<location_tag>::stream_type stream, int const, \
                         std::complex<float> const input[], float output[], std::complex<float> workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
-                        std::array<executor_base*, 3> const &executor, direction); \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
+                        std::array<executor_base*, 3> const &executor, direction, transform_schedule*, std::complex<float>*); \
     template void compute_transform<location_tag, index, double>( \
                         typename backend::data_manipulator<location_tag>::stream_type stream, int const, \
                         std::complex<double> const input[], double output[], std::complex<double> workspace[], \
                         size_t executor_buffer_offset, size_t size_comm_buffers, \
-                        std::array<std::unique_ptr<reshape3d_base<index>>, 4> const &shaper, \
-                        std::array<executor_base*, 3> const &executor, direction); \
+                        std::array<reshape3d_base<index>*, 4> const &shaper, \
+                        std::array<executor_base*, 3> const &executor, direction, transform_schedule*, std::complex<double>*); \
 
 heffte_instantiate_transform(tag::cpu, int)
 heffte_instantiate_transform(tag::cpu, long long)
@@ -153,6 +153,19 @@ inline std::vector<box3d<index>> next_pencils_shape0(box3d<index> const world,
     }
 }
 
+/*!
+ * \ingroup fft3dplan
+ * \brief Returns the grid set in the options or the grid with minimum surface area, if no grid has been set.
+ */
+inline std::array<int, 2> make_procgrid(int const num_procs, plan_options const &opts){
+    std::array<int, 2> const grid = opts.get_proc_grid();
+    if (grid[0] <= 0 or grid[1] <= 0)
+        return make_procgrid(num_procs);
+    if (grid[0] * grid[1] != num_procs)
+        throw std::invalid_argument("The processor grid set in the plan_options does not match the number of MPI ranks.");
+    return grid;
+}
+
 /*!
  * \ingroup fft3dplan
  * \brief Creates a plan of reshape operations using pencil decomposition.
@@ -166,8 +179,8 @@ logic_plan3d<index> plan_pencil_reshapes(box3d<index> world_in, box3d<index> wor
                                          plan_options const opts, rank_remap const &remap){
     // the 2-d grid of pencils
     std::array<int, 2> proc_grid = (remap.empty()) ?
-                                    make_procgrid(static_cast<int>(boxes.in.size())) :
-                                    make_procgrid(remap.size_subcomm);
+                                    make_procgrid(static_cast<int>(boxes.in.size()), opts) :
+                                    make_procgrid(remap.size_subcomm, opts);
 
     std::array<int, 3> fft_direction = {-1, -1, -1};
 
@@ -284,7 +297,7 @@ logic_plan3d<index> plan_slab_reshapes(box3d<index> world_in, box3d<index> world
 
     // the 2-d grid for the pencils dimension
     int const num_procs = (remap.empty()) ? static_cast<int>(boxes.in.size()) : remap.size_subcomm;
-    std::array<int, 2> proc_grid = make_procgrid(num_procs);
+    std::array<int, 2> proc_grid = make_procgrid(num_procs, opts);
 
     std::array<int, 3> fft_direction = {-1, -1, -1};
 
@@ -421,6 +434,76 @@ logic_plan3d<index> plan_slab_reshapes(box3d<index> world_in, box3d<index> world
         };
 }
 
+/*!
+ * \ingroup fft3dplan
+ * \brief Returns the direction of size one if the world is a 2D problem that can be split into slabs, returns -1 otherwise.
+ *
+ * The two non-trivial directions must be split across all ranks, i.e., each must have at least as many indexes
+ * as there are ranks, taking into account that the r2c direction is split in the output world.
+ */
+template<typename index>
+int find_2d_slab_direction(box3d<index> const world_in, box3d<index> const world_out, int r2c_direction, int num_procs){
+    int degenerate = -1;
+    for(int i=0; i<3; i++){
+        if (world_in.size[i] == 1){
+            if (degenerate != -1) return -1; // 1D problem
+            degenerate = i;
+        }
+    }
+    if (degenerate == -1 or degenerate == r2c_direction) return -1;
+    for(int i=0; i<3; i++)
+        if (i != degenerate and (world_in.size[i] < num_procs or world_out.size[i] < num_procs)) return -1;
+    return degenerate;
+}
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Creates a plan of reshape operations for a 2D problem, using slabs in the two non-trivial directions.
+ *
+ * The direction of size one is assigned to the middle stage of the plan, which has neither a reshape nor work,
+ * thus the plan is slabs -> transpose -> slabs, with extra reshapes only if the input and output are not slabs.
+ * The first direction is the r2c direction, or a direction where the input forms slabs,
+ * or the direction where the output does not form slabs, so that the transpose can land directly in the output.
+ */
+template<typename index>
+logic_plan3d<index> plan_2d_reshapes(box3d<index> world_in, box3d<index> world_out,
+                                     ioboxes<index> const &boxes, int r2c_direction, int degenerate,
+                                     plan_options const opts, rank_remap const &remap){
+    int const num_procs = (remap.empty()) ? static_cast<int>(boxes.in.size()) : remap.size_subcomm;
+    std::array<int, 2> const proc_grid = {num_procs, 1}; // make_pencils() moves the ranks away from the direction of size one
+
+    std::array<int, 3> fft_direction = {-1, degenerate, -1};
+    if (r2c_direction != -1){
+        fft_direction[0] = r2c_direction;
+    }else{
+        for(int i=0; i<3 and fft_direction[0] == -1; i++)
+            if (i != degenerate and is_pencils(world_in, boxes.in, i)) fft_direction[0] = i;
+        for(int i=0; i<3 and fft_direction[0] == -1; i++)
+            if (i != degenerate and is_pencils(world_out, boxes.out, i)) fft_direction[0] = get_any_valid(std::array<int, 3>{i, degenerate, -1});
+        if (fft_direction[0] == -1)
+            fft_direction[0] = get_any_valid(std::array<int, 3>{degenerate, -1, -1});
+    }
+    fft_direction[2] = get_any_valid(fft_direction);
+
+    std::vector<box3d<index>> shape0 = (is_pencils(world_in, boxes.in, fft_direction[0])) ?
+                                        reorder_slabs(boxes.in, fft_direction[0], opts.use_reorder) :
+                                        next_pencils_shape0(world_in, proc_grid, fft_direction[0],
+                                                            r2c_direction, boxes.in, opts.use_reorder,
+                                                            world_out, {0, 1, 2}, boxes.out, remap);
+
+    std::vector<box3d<index>> shape_fft0 = apply_r2c(shape0, r2c_direction);
+
+    std::vector<box3d<index>> shape2 = next_pencils_shape(world_out, proc_grid, fft_direction[2], shape_fft0, opts.use_reorder,
+                                                          world_out, {fft_direction[2]}, boxes.out, remap);
+
+    return {
+        {boxes.in, shape_fft0, shape_fft0, shape2},
+        {shape0,   shape_fft0, shape2,     boxes.out},
+        world_in.size, fft_direction, world_in.count(), opts,
+        remap.mpi_rank
+        };
+}
+
 template<typename index>
 logic_plan3d<index> plan_operations(ioboxes<index> const &boxes, int r2c_direction, plan_options const opts, int const mpi_rank){
 
@@ -445,6 +528,13 @@ logic_plan3d<index> plan_operations(ioboxes<index> const &boxes, int r2c_directi
     assert( order_is_identical(boxes.in) );
     assert( order_is_identical(boxes.out) );
 
+    if (opts.use_2d_planner){
+        int const degenerate = find_2d_slab_direction(world_in, world_out, r2c_direction,
+                                                      (remap.empty()) ? static_cast<int>(boxes.in.size()) : remap.size_subcomm);
+        if (degenerate != -1)
+            return plan_2d_reshapes(world_in, world_out, boxes, r2c_direction, degenerate, opts, remap);
+    }
+
     if (opts.use_pencils){
         return plan_pencil_reshapes(world_in, world_out, boxes, r2c_direction, opts, remap);
     }else{
@@ -457,6 +547,105 @@ template logic_plan3d<int> plan_operations<int>(ioboxes<int> const&, int, plan_o
 //! \brief Instantiate for long long.
 template logic_plan3d<long long> plan_operations<long long>(ioboxes<long long> const&, int, plan_options const, int const);
 
+/*!
+ * \ingroup fft3dplan
+ * \brief Returns the order of the 1-D transforms for the mixed plan, the real-to-real directions come first.
+ *
+ * Within the real-to-real and the complex groups, the direction where the input boxes form pencils
+ * is moved to the front and the direction where the output boxes form pencils is moved to the back.
+ */
+template<typename index>
+std::array<int, 3> mixed_fft_directions(box3d<index> const world_in, box3d<index> const world_out, ioboxes<index> const &boxes,
+                                        std::array<transform_kind, 3> const &kinds){
+    auto group = [&](int i)->int{
+        return (is_real_kind(kinds[i])) ? 0 : ((kinds[i] == transform_kind::fft_r2c) ? 1 : 2);
+    };
+    std::array<int, 3> fft_direction = {0, 1, 2};
+    std::stable_sort(fft_direction.begin(), fft_direction.end(), [&](int a, int b)->bool{
+        if (group(a) != group(b)) return (group(a) < group(b));
+        bool const a_first = is_pencils(world_in, boxes.in, a), b_first = is_pencils(world_in, boxes.in, b);
+        if (a_first != b_first) return a_first;
+        return (not is_pencils(world_out, boxes.out, a) and is_pencils(world_out, boxes.out, b));
+    });
+    return fft_direction;
+}
+
+template<typename index>
+logic_plan3d<index> plan_mixed_operations(ioboxes<index> const &boxes, std::array<transform_kind, 3> const &kinds,
+                                          plan_options const opts, int const mpi_rank){
+    int r2c_direction = -1;
+    int num_r2c = 0, num_fft = 0;
+    for(int i=0; i<3; i++){
+        if (kinds[i] == transform_kind::fft_r2c){
+            r2c_direction = i;
+            num_r2c++;
+        }else if (kinds[i] == transform_kind::fft){
+            num_fft++;
+        }
+    }
+    if (num_r2c > 1 or (num_fft > 0 and num_r2c == 0))
+        throw std::invalid_argument("The mixed transform requires exactly one transform_kind::fft_r2c direction when using transform_kind::fft.");
+
+    rank_remap remap(mpi_rank);
+    if (opts.get_subranks() > 0 and static_cast<size_t>(opts.get_subranks()) < boxes.in.size()){ // using sub-ranks
+        assert(opts.get_subranks() < static_cast<int>(boxes.in.size()));
+        remap.set_subranks(boxes.in.size(), opts.get_subranks());
+    }
+
+    box3d<index> const world_in  = find_world(boxes.in);
+    box3d<index> const world_out = find_world(boxes.out);
+
+    assert( world_complete(boxes.in,  world_in) );
+    assert( world_complete(boxes.out, world_out) );
+    if (r2c_direction == -1){
+        assert( world_in == world_out );
+    }else{
+        assert( world_in.r2c(r2c_direction) == world_out );
+    }
+    assert( order_is_identical(boxes.in) );
+    assert( order_is_identical(boxes.out) );
+
+    std::array<int, 2> const proc_grid = (remap.empty()) ?
+                                          make_procgrid(static_cast<int>(boxes.in.size()), opts) :
+                                          make_procgrid(remap.size_subcomm, opts);
+
+    std::array<int, 3> const fft_direction = mixed_fft_directions(world_in, world_out, boxes, kinds);
+
+    // before[i] is the shape used by the i-th 1-D transform and after[i] is the result, different only for the r2c stage
+    std::vector<std::vector<box3d<index>>> before, after;
+    bool r2c_done = (r2c_direction == -1);
+    for(int i=0; i<3; i++){
+        std::vector<int> const test_directions(fft_direction.begin() + i, fft_direction.end());
+        std::vector<box3d<index>> const &source = (i == 0) ? boxes.in : after.back();
+        before.push_back((r2c_done) ?
+            next_pencils_shape(world_out, proc_grid, fft_direction[i], source, opts.use_reorder,
+                               world_out, test_directions, boxes.out, remap) :
+            next_pencils_shape0(world_in, proc_grid, fft_direction[i], r2c_direction, source, opts.use_reorder,
+                                world_out, test_directions, boxes.out, remap));
+        if (fft_direction[i] == r2c_direction){
+            after.push_back(apply_r2c(before.back(), r2c_direction));
+            r2c_done = true;
+        }else{
+            after.push_back(before.back());
+        }
+    }
+
+    return {
+        {boxes.in,  after[0],  after[1],  after[2]},
+        {before[0], before[1], before[2], boxes.out},
+        world_in.size,
+        fft_direction,
+        world_in.count(),
+        opts,
+        remap.mpi_rank
+           };
+}
+
+//! \brief Instantiate for int.
+template logic_plan3d<int> plan_mixed_operations<int>(ioboxes<int> const&, std::array<transform_kind, 3> const&, plan_options const, int const);
+//! \brief Instantiate for long long.
+template logic_plan3d<long long> plan_mixed_operations<long long>(ioboxes<long long> const&, std::array<transform_kind, 3> const&, plan_options const, int const);
+
 template<typename index>
 std::vector<std::array<int, 3>> compute_grids(logic_plan3d<index> const &plan){
     std::vector<std::array<int, 3>> result;
@@ -488,4 +677,443 @@ std::vector<std::array<int, 3>> compute_grids(logic_plan3d<index> const &plan){
 
 template std::vector<std::array<int, 3>> compute_grids<int>(logic_plan3d<int> const&);
 template std::vector<std::array<int, 3>> compute_grids<long long>(logic_plan3d<long long> const&);
+
+template<typename index>
+std::array<double, 4> estimate_comm_time(logic_plan3d<index> const &plan, std::vector<int> const &node_ids,
+                                         comm_cost_model const &model){
+    int const me = plan.mpi_rank;
+    int const num_ranks = static_cast<int>(node_ids.size());
+    int const my_node = node_ids[me];
+
+    std::array<double, 4> result = {0.0, 0.0, 0.0, 0.0};
+    for(int i=0; i<4; i++){
+        std::vector<box3d<index>> const &source      = plan.in_shape[i];
+        std::vector<box3d<index>> const &destination = plan.out_shape[i];
+        if (match(source, destination)) continue; // no communication, at most a local transpose
+
+        // messages and volume sent/received by this rank, the inter-node volume is counted for the entire node
+        double intra_send = 0.0, intra_recv = 0.0;
+        int inter_messages_send = 0, inter_messages_recv = 0;
+        long long node_send = 0, node_recv = 0;
+        for(int r=0; r<num_ranks; r++){
+            if (node_ids[r] == my_node){
+                if (r != me){
+                    long long const send = source[me].collide(destination[r]).count();
+                    long long const recv = source[r].collide(destination[me]).count();
+                    if (send > 0) intra_send += model.intra_node_latency + model.element_size * send / model.intra_node_bandwidth;
+                    if (recv > 0) intra_recv += model.intra_node_latency + model.element_size * recv / model.intra_node_bandwidth;
+                }
+                for(int p=0; p<num_ranks; p++){ // node volume, send from r to the other nodes
+                    if (node_ids[p] == my_node) continue;
+                    node_send += source[r].collide(destination[p]).count();
+                    node_recv += source[p].collide(destination[r]).count();
+                }
+            }else{
+                if (not source[me].collide(destination[r]).empty()) inter_messages_send++;
+                if (not source[r].collide(destination[me]).empty()) inter_messages_recv++;
+            }
+        }
+
+        double const inter_send = model.inter_node_latency * inter_messages_send
+                                  + model.element_size * node_send / model.inter_node_bandwidth;
+        double const inter_recv = model.inter_node_latency * inter_messages_recv
+                                  + model.element_size * node_recv / model.inter_node_bandwidth;
+
+        result[i] = std::max(intra_send + inter_send, intra_recv + inter_recv);
+    }
+    return result;
+}
+
+template std::array<double, 4> estimate_comm_time<int>(logic_plan3d<int> const&, std::vector<int> const&, comm_cost_model const&);
+template std::array<double, 4> estimate_comm_time<long long>(logic_plan3d<long long> const&, std::vector<int> const&, comm_cost_model const&);
+
+template<typename index>
+std::vector<plan_options> rank_proc_grids(ioboxes<index> const &boxes, int r2c_direction, plan_options const options,
+                                          MPI_Comm const comm, comm_cost_model const &model){
+    int const me = mpi::comm_rank(comm);
+    int const num_procs = (options.get_subranks() > 0 and static_cast<size_t>(options.get_subranks()) < boxes.in.size()) ?
+                            options.get_subranks() : static_cast<int>(boxes.in.size());
+    std::vector<int> const node_ids = mpi::node_ids(comm);
+
+    // the default heuristic goes first so that ties are resolved in its favor
+    std::array<int, 2> const default_grid = make_procgrid(num_procs);
+    std::vector<std::array<int, 2>> grids = {default_grid};
+    for(auto const &g : get_factors(num_procs)) // make_pencils() considers both orientations of the grid
+        if (g[0] <= g[1] and g != default_grid and std::array<int, 2>{g[1], g[0]} != default_grid)
+            grids.push_back(g);
+
+    std::vector<plan_options> candidates;
+    for(bool pencils : std::array<bool, 2>{options.use_pencils, not options.use_pencils}){
+        for(auto const &g : grids){
+            plan_options candidate = options;
+            candidate.use_pencils = pencils;
+            candidate.grid_search = grid_selection::heuristic;
+            candidate.use_proc_grid(g);
+            candidates.push_back(candidate);
+        }
+    }
+
+    // compute the per-stage time on this rank, then take the max across all ranks
+    std::vector<double> local_times(4 * candidates.size(), std::numeric_limits<double>::max());
+    for(size_t c=0; c<candidates.size(); c++){
+        try{
+            std::array<double, 4> times = estimate_comm_time(plan_operations(boxes, r2c_direction, candidates[c], me), node_ids, model);
+            std::copy(times.begin(), times.end(), local_times.begin() + 4 * c);
+        }catch(std::runtime_error &){} // the grid cannot split the world, leave the time at max()
+    }
+    std::vector<double> times(local_times.size());
+    MPI_Allreduce(local_times.data(), times.data(), static_cast<int>(times.size()), MPI_DOUBLE, MPI_MAX, comm);
+
+    std::vector<double> cost(candidates.size());
+    for(size_t c=0; c<candidates.size(); c++)
+        cost[c] = std::min(std::numeric_limits<double>::max(), times[4*c] + times[4*c+1] + times[4*c+2] + times[4*c+3]);
+
+    std::vector<size_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)->bool{ return cost[a] < cost[b]; });
+
+    std::vector<plan_options> result;
+    for(auto c : order)
+        if (cost[c] < std::numeric_limits<double>::max())
+            result.push_back(candidates[c]);
+    if (result.empty()) // should not happen, the default heuristic always works for a valid problem
+        result.push_back(candidates.front());
+    return result;
+}
+
+template std::vector<plan_options> rank_proc_grids<int>(ioboxes<int> const&, int, plan_options const, MPI_Comm const, comm_cost_model const&);
+template std::vector<plan_options> rank_proc_grids<long long>(ioboxes<long long> const&, int, plan_options const, MPI_Comm const, comm_cost_model const&);
+
+template<typename index>
+plan_cost estimate_plan_cost(logic_plan3d<index> const &plan, size_t element_size, int r2c_direction){
+    int const num_ranks = static_cast<int>(plan.in_shape[0].size());
+    long long const element_bytes = static_cast<long long>(element_size);
+
+    plan_cost cost;
+    std::vector<long long> comm_buffer(num_ranks, 0); // largest send plus receive buffers on each rank
+    for(int i=0; i<4; i++){
+        std::vector<box3d<index>> const &source      = plan.in_shape[i];
+        std::vector<box3d<index>> const &destination = plan.out_shape[i];
+        reshape_stats &stats = cost.reshapes[i];
+
+        stats.active = not match(source, destination);
+        stats.send_bytes    = std::vector<long long>(num_ranks, 0);
+        stats.recv_bytes    = std::vector<long long>(num_ranks, 0);
+        stats.send_messages = std::vector<int>(num_ranks, 0);
+        stats.recv_messages = std::vector<int>(num_ranks, 0);
+        stats.num_peers     = std::vector<int>(num_ranks, 0);
+        stats.max_send_bytes   = 0;
+        stats.max_recv_bytes   = 0;
+        stats.max_messages     = 0;
+        stats.max_peers        = 0;
+        stats.imbalance        = 1.0;
+        stats.max_buffer_bytes = 0;
+        if (not stats.active) continue;
+
+        long long const bytes = (i == 0 and r2c_direction != -1) ? element_bytes / 2 : element_bytes; // r2c input is real
+        std::vector<long long> buffer_bytes(num_ranks, 0);
+        for(int me=0; me<num_ranks; me++){
+            for(int r=0; r<num_ranks; r++){
+                long long const send = source[me].collide(destination[r]).count();
+                long long const recv = source[r].collide(destination[me]).count();
+                buffer_bytes[me] += (send + recv) * bytes;
+                if (r == me) continue;
+                if (send > 0){
+                    stats.send_bytes[me] += send * bytes;
+                    stats.send_messages[me]++;
+                }
+                if (recv > 0){
+                    stats.recv_bytes[me] += recv * bytes;
+                    stats.recv_messages[me]++;
+                }
+                if (send > 0 or recv > 0)
+                    stats.num_peers[me]++;
+            }
+        }
+
+        stats.max_send_bytes   = *std::max_element(stats.send_bytes.begin(), stats.send_bytes.end());
+        stats.max_recv_bytes   = *std::max_element(stats.recv_bytes.begin(), stats.recv_bytes.end());
+        stats.max_messages     = std::max(*std::max_element(stats.send_messages.begin(), stats.send_messages.end()),
+                                          *std::max_element(stats.recv_messages.begin(), stats.recv_messages.end()));
+        stats.max_peers        = *std::max_element(stats.num_peers.begin(), stats.num_peers.end());
+        stats.max_buffer_bytes = *std::max_element(buffer_bytes.begin(), buffer_bytes.end());
+        for(int me=0; me<num_ranks; me++)
+            comm_buffer[me] = std::max(comm_buffer[me], buffer_bytes[me]);
+
+        long long const total_send = std::accumulate(stats.send_bytes.begin(), stats.send_bytes.end(), 0ll);
+        if (total_send > 0)
+            stats.imbalance = static_cast<double>(stats.max_send_bytes) * num_ranks / static_cast<double>(total_send);
+    }
+
+    // the 1-D transforms are applied to out_shape[0], out_shape[1] and out_shape[2]
+    for(int i=0; i<3; i++){
+        double const n = static_cast<double>(plan.fft_sizes[plan.fft_direction[i]]);
+        double const flops_per_entry = (n > 1.0) ? 5.0 * std::log2(n) : 0.0;
+        double const r2c_factor = (i == 0 and r2c_direction != -1) ? 0.5 : 1.0;
+        cost.fft_flops[i] = std::vector<double>(num_ranks, 0.0);
+        for(int me=0; me<num_ranks; me++)
+            cost.fft_flops[i][me] = r2c_factor * flops_per_entry * static_cast<double>(plan.out_shape[i][me].count());
+        cost.max_fft_flops[i] = *std::max_element(cost.fft_flops[i].begin(), cost.fft_flops[i].end());
+    }
+
+    // the workspace holds the communication buffers and a copy of the largest intermediate box
+    cost.workspace_bytes = std::vector<long long>(num_ranks, 0);
+    for(int me=0; me<num_ranks; me++){
+        long long max_box = 0;
+        for(int i=0; i<3; i++)
+            max_box = std::max(max_box, plan.out_shape[i][me].count());
+        cost.workspace_bytes[me] = comm_buffer[me] + max_box * element_bytes;
+    }
+    cost.max_workspace_bytes = *std::max_element(cost.workspace_bytes.begin(), cost.workspace_bytes.end());
+
+    return cost;
+}
+
+template plan_cost estimate_plan_cost<int>(logic_plan3d<int> const&, size_t, int);
+template plan_cost estimate_plan_cost<long long>(logic_plan3d<long long> const&, size_t, int);
+
+/*!
+ * \ingroup fft3dplan
+ * \brief FNV-1a hash of a block of bytes, continues from the given hash value.
+ */
+inline uint64_t hash_bytes(void const *data, size_t num_bytes, uint64_t hash = 14695981039346656037ULL){
+    unsigned char const *bytes = reinterpret_cast<unsigned char const*>(data);
+    for(size_t i=0; i<num_bytes; i++){
+        hash ^= static_cast<uint64_t>(bytes[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Hash of the input and output boxes of one rank, the sum over all ranks identifies the geometry of the transform.
+ */
+template<typename index>
+uint64_t hash_rank_boxes(int rank, box3d<index> const &inbox, box3d<index> const &outbox){
+    std::array<int64_t, 19> values;
+    values[0] = rank;
+    for(int i=0; i<3; i++){
+        values[1 + i]  = inbox.low[i];
+        values[4 + i]  = inbox.high[i];
+        values[7 + i]  = inbox.order[i];
+        values[10 + i] = outbox.low[i];
+        values[13 + i] = outbox.high[i];
+        values[16 + i] = outbox.order[i];
+    }
+    return hash_bytes(values.data(), values.size() * sizeof(int64_t));
+}
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Binary stream used to write the plan files, all values are stored with fixed width.
+ */
+struct plan_file_writer{
+    //! \brief Appends the raw bytes of the value.
+    template<typename T> void write(T const &value){
+        char const *bytes = reinterpret_cast<char const*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+    //! \brief Appends a list of boxes.
+    template<typename index> void write(std::vector<box3d<index>> const &boxes){
+        for(auto const &b : boxes){
+            for(int i=0; i<3; i++) write(static_cast<int64_t>(b.low[i]));
+            for(int i=0; i<3; i++) write(static_cast<int64_t>(b.high[i]));
+            for(int i=0; i<3; i++) write(static_cast<int32_t>(b.order[i]));
+        }
+    }
+    //! \brief Holds the content of the file.
+    std::vector<char> data;
+};
+
+/*!
+ * \ingroup fft3dplan
+ * \brief Reads the content of the plan file, throws if reading past the end of the data.
+ */
+struct plan_file_reader{
+    //! \brief Reads one value.
+    template<typename T> T read(){
+        if (offset + sizeof(T) > num_bytes) throw std::runtime_error("heffte::load_plan(), the plan file is truncated");
+        T value;
+        std::copy_n(data + offset, sizeof(T), reinterpret_cast<char*>(&value));
+        offset += sizeof(T);
+        return value;
+    }
+    //! \brief Reads a list of boxes.
+    template<typename index> std::vector<box3d<index>> read_boxes(int num_boxes){
+        std::vector<box3d<index>> boxes;
+        boxes.reserve(num_boxes);
+        for(int b=0; b<num_boxes; b++){
+            std::array<index, 3> low, high;
+            std::array<int, 3> order;
+            for(int i=0; i<3; i++) low[i]   = static_cast<index>(read<int64_t>());
+            for(int i=0; i<3; i++) high[i]  = static_cast<index>(read<int64_t>());
+            for(int i=0; i<3; i++) order[i] = read<int32_t>();
+            boxes.push_back(box3d<index>(low, high, order));
+        }
+        return boxes;
+    }
+    //! \brief The content of the file.
+    char const *data;
+    //! \brief The total number of bytes.
+    size_t num_bytes;
+    //! \brief The current read position.
+    size_t offset;
+};
+
+//! \brief Identifies the plan files.
+constexpr uint64_t plan_file_magic = 0x4e414c5045544648ULL; // "HFTEPLAN"
+//! \brief Version of the plan file format, must change if the content of the file changes.
+constexpr int32_t plan_file_version = 1;
+
+template<typename index>
+void save_plan(std::string const &filename, logic_plan3d<index> const &plan, int r2c_direction, MPI_Comm const comm){
+    int const num_ranks = static_cast<int>(plan.in_shape[0].size());
+    int ok = 1;
+    if (mpi::comm_rank(comm) == 0){
+        plan_file_writer file;
+        file.write(plan_file_magic);
+        file.write(plan_file_version);
+        file.write(static_cast<int32_t>(num_ranks));
+        file.write(static_cast<int32_t>(r2c_direction));
+
+        plan_options const &options = plan.options;
+        file.write(static_cast<int32_t>(options.use_reorder));
+        file.write(static_cast<int32_t>(options.algorithm));
+        file.write(static_cast<int32_t>(options.use_pencils));
+        file.write(static_cast<int32_t>(options.use_gpu_aware));
+        file.write(static_cast<int32_t>(options.use_low_memory));
+        file.write(static_cast<int32_t>(options.get_subranks()));
+        file.write(static_cast<int32_t>(options.get_proc_grid()[0]));
+        file.write(static_cast<int32_t>(options.get_proc_grid()[1]));
+
+        for(int i=0; i<3; i++) file.write(static_cast<int64_t>(plan.fft_sizes[i]));
+        for(int i=0; i<3; i++) file.write(static_cast<int32_t>(plan.fft_direction[i]));
+        file.write(static_cast<int64_t>(plan.index_count));
+
+        // the stages usually repeat the same shapes, store a reference to the first identical list
+        auto identical = [](std::vector<box3d<index>> const &a, std::vector<box3d<index>> const &b)->bool{
+            for(size_t r=0; r<a.size(); r++)
+                if (a[r] != b[r] or a[r].order != b[r].order) return false;
+            return true;
+        };
+        std::vector<std::vector<box3d<index>> const*> shapes;
+        for(int i=0; i<4; i++){
+            shapes.push_back(&plan.in_shape[i]);
+            shapes.push_back(&plan.out_shape[i]);
+        }
+        for(size_t i=0; i<shapes.size(); i++){
+            int32_t same_as = -1;
+            for(size_t j=0; j<i and same_as == -1; j++)
+                if (identical(*shapes[j], *shapes[i])) same_as = static_cast<int32_t>(j);
+            file.write(same_as);
+            if (same_as == -1) file.write(*shapes[i]);
+        }
+
+        uint64_t boxes_hash = 0;
+        for(int r=0; r<num_ranks; r++)
+            boxes_hash += hash_rank_boxes(r, plan.in_shape[0][r], plan.out_shape[3][r]);
+        file.write(boxes_hash);
+        file.write(hash_bytes(file.data.data(), file.data.size()));
+
+        std::ofstream ofs(filename, std::ios::binary);
+        ofs.write(file.data.data(), file.data.size());
+        ok = (ofs.good()) ? 1 : 0;
+    }
+    MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+    if (ok == 0)
+        throw std::runtime_error("heffte::save_plan() could not write to file: " + filename);
+}
+
+template<typename index>
+logic_plan3d<index> load_plan(std::string const &filename, box3d<index> const inbox, box3d<index> const outbox,
+                              int r2c_direction, MPI_Comm const comm){
+    int const me = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+
+    std::vector<char> content;
+    {
+        std::ifstream ifs(filename, std::ios::binary);
+        if (ifs.good())
+            content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    // parse the file locally and record the error, the error is reported after all ranks have checked the file
+    std::string error;
+    uint64_t file_boxes_hash = 0;
+    plan_options options(false, reshape_algorithm::alltoallv, true);
+    std::vector<box3d<index>> shapes[8];
+    std::array<index, 3> fft_sizes = {0, 0, 0};
+    std::array<int, 3> fft_direction = {0, 0, 0};
+    long long index_count = 0;
+    try{
+        if (content.size() < 2 * sizeof(uint64_t))
+            throw std::runtime_error("cannot read the plan file");
+        plan_file_reader file = {content.data(), content.size() - sizeof(uint64_t), 0};
+        uint64_t checksum;
+        std::copy_n(content.data() + file.num_bytes, sizeof(uint64_t), reinterpret_cast<char*>(&checksum));
+        if (checksum != hash_bytes(file.data, file.num_bytes))
+            throw std::runtime_error("the checksum of the plan file does not match the content");
+        if (file.read<uint64_t>() != plan_file_magic or file.read<int32_t>() != plan_file_version)
+            throw std::runtime_error("the file is not a plan file or was written by an incompatible version of heFFTe");
+        if (file.read<int32_t>() != num_ranks)
+            throw std::runtime_error("the plan was created for a different number of ranks");
+        if (file.read<int32_t>() != r2c_direction)
+            throw std::runtime_error("the plan was created for a different type of transform (r2c direction)");
+
+        options.use_reorder    = (file.read<int32_t>() != 0);
+        options.algorithm      = static_cast<reshape_algorithm>(file.read<int32_t>());
+        options.use_pencils    = (file.read<int32_t>() != 0);
+        options.use_gpu_aware  = (file.read<int32_t>() != 0);
+        options.use_low_memory = (file.read<int32_t>() != 0);
+        options.use_num_subranks(file.read<int32_t>());
+        std::array<int, 2> grid;
+        grid[0] = file.read<int32_t>();
+        grid[1] = file.read<int32_t>();
+        options.use_proc_grid(grid);
+
+        for(int i=0; i<3; i++) fft_sizes[i] = static_cast<index>(file.read<int64_t>());
+        for(int i=0; i<3; i++) fft_direction[i] = file.read<int32_t>();
+        index_count = file.read<int64_t>();
+
+        for(int i=0; i<8; i++){
+            int32_t same_as = file.read<int32_t>();
+            if (same_as < -1 or same_as >= i)
+                throw std::runtime_error("the plan file is corrupted");
+            shapes[i] = (same_as == -1) ? file.template read_boxes<index>(num_ranks) : shapes[same_as];
+        }
+        file_boxes_hash = file.read<uint64_t>();
+        if (file.offset != file.num_bytes)
+            throw std::runtime_error("the plan file is corrupted");
+    }catch(std::runtime_error &e){
+        error = e.what();
+    }
+
+    // compare the boxes used to create the plan against the current boxes
+    uint64_t boxes_hash = hash_rank_boxes(me, inbox, outbox);
+    MPI_Allreduce(MPI_IN_PLACE, &boxes_hash, 1, MPI_UINT64_T, MPI_SUM, comm);
+    if (error.empty() and (boxes_hash != file_boxes_hash or not (shapes[0][me] == inbox) or not (shapes[7][me] == outbox)))
+        error = "the plan was created for a different set of boxes";
+
+    int ok = (error.empty()) ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN, comm);
+    if (ok == 0)
+        throw std::runtime_error("heffte::load_plan() failed to load " + filename + ", "
+                                 + ((error.empty()) ? std::string("the plan is invalid on another rank") : error));
+
+    return {{shapes[0], shapes[2], shapes[4], shapes[6]},
+            {shapes[1], shapes[3], shapes[5], shapes[7]},
+            fft_sizes,
+            fft_direction,
+            index_count,
+            options,
+            me
+           };
+}
+
+template void save_plan<int>(std::string const&, logic_plan3d<int> const&, int, MPI_Comm const);
+template void save_plan<long long>(std::string const&, logic_plan3d<long long> const&, int, MPI_Comm const);
+template logic_plan3d<int> load_plan<int>(std::string const&, box3d<int> const, box3d<int> const, int, MPI_Comm const);
+template logic_plan3d<long long> load_plan<long long>(std::string const&, box3d<long long> const, box3d<long long> const, int, MPI_Comm const);
+
 }
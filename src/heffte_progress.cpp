@@ -0,0 +1,108 @@
+/**
+ * @class
+ * heFFTe communication progress thread
+ */
+/*
+    -- heFFTe --
+       Univ. of Tennessee, Knoxville
+       @date
+*/
+
+#include "heffte_progress.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace heffte {
+
+namespace {
+/*!
+ * \internal
+ * \brief Pins the calling thread to the last core in its affinity mask, does nothing outside of Linux.
+ *
+ * The MPI launchers usually bind the ranks to consecutive cores, thus the last core is the one
+ * least likely to be used by the OpenMP threads of the rank.
+ * \endinternal
+ */
+void pin_to_last_core(){
+    #ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) return;
+    int last = -1;
+    for(int c=0; c<CPU_SETSIZE; c++) if (CPU_ISSET(c, &mask)) last = c;
+    if (last < 0) return;
+    cpu_set_t single;
+    CPU_ZERO(&single);
+    CPU_SET(last, &single);
+    pthread_setaffinity_np(pthread_self(), sizeof(single), &single);
+    #endif
+}
+}
+
+std::shared_ptr<progress_engine> progress_engine::shared(){
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided != MPI_THREAD_MULTIPLE)
+        throw std::runtime_error("plan_options::use_progress_thread requires MPI initialized with MPI_THREAD_MULTIPLE");
+
+    static std::mutex instance_lock;
+    static std::weak_ptr<progress_engine> instance;
+
+    std::lock_guard<std::mutex> guard(instance_lock);
+    std::shared_ptr<progress_engine> engine = instance.lock();
+    if (not engine){
+        engine = std::shared_ptr<progress_engine>(new progress_engine());
+        instance = engine;
+    }
+    return engine;
+}
+
+progress_engine::progress_engine() : shutdown(false){
+    helper = std::thread([this]()->void{ run(); });
+}
+
+progress_engine::~progress_engine(){
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        shutdown = true;
+    }
+    wakeup.notify_all();
+    helper.join();
+}
+
+void progress_engine::activate(MPI_Comm comm){
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        active.push_back(comm);
+    }
+    wakeup.notify_all();
+}
+
+void progress_engine::deactivate(MPI_Comm comm){
+    // the helper polls while holding the lock, hence the comm is not in use after the lock is acquired
+    std::lock_guard<std::mutex> guard(lock);
+    auto icomm = std::find(active.begin(), active.end(), comm);
+    if (icomm != active.end()) active.erase(icomm);
+}
+
+void progress_engine::run(){
+    pin_to_last_core();
+    std::unique_lock<std::mutex> guard(lock);
+    while(true){
+        wakeup.wait(guard, [this]()->bool{ return (shutdown or not active.empty()); });
+        if (shutdown) return;
+        for(auto comm : active){
+            int flag = 0;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &flag, MPI_STATUS_IGNORE);
+        }
+        // release the lock so the main threads can activate or deactivate the communicators
+        guard.unlock();
+        std::this_thread::yield();
+        guard.lock();
+    }
+}
+
+}
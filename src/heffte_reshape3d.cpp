@@ -205,6 +205,13 @@ void compute_overlap_map_transpose_pack(int me, int nprocs, box3d<index> const d
     }
 }
 
+template
+void compute_overlap_map_direct_pack<int>(int me, int nprocs, box3d<int> const source, std::vector<box3d<int>> const &boxes,
+                                          std::vector<int> &proc, std::vector<int> &offset, std::vector<int> &sizes, std::vector<pack_plan_3d<int>> &plans);
+template
+void compute_overlap_map_direct_pack<long long>(int me, int nprocs, box3d<long long> const source,
+                                                std::vector<box3d<long long>> const &boxes,
+                                                std::vector<int> &proc, std::vector<int> &offset, std::vector<int> &sizes, std::vector<pack_plan_3d<long long>> &plans);
 template
 void compute_overlap_map_transpose_pack<int>(int me, int nprocs, box3d<int> const destination, std::vector<box3d<int>> const &boxes,
                                          std::vector<int> &proc, std::vector<int> &offset, std::vector<int> &sizes, std::vector<pack_plan_3d<int>> &plans);
@@ -236,28 +243,65 @@ reshape3d_alltoall<location_tag, packer, index>::reshape3d_alltoall(
 
 template<typename location_tag, template<typename device> class packer, typename index>
 template<typename scalar_type>
-void reshape3d_alltoall<location_tag, packer, index>::apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const{
+void reshape3d_alltoall<location_tag, packer, index>::pack_messages(int batch_size, scalar_type const source[], scalar_type send_buffer[]) const{
 
-    scalar_type *send_buffer = workspace;
-    scalar_type *recv_buffer = workspace + batch_size * num_entries * packplan.size();
+    packer<location_tag> packit;
+
+    // the messages have the same padded size, the offsets are computed independently so the peers can be processed in parallel
+    int const num_peers = static_cast<int>(packplan.size());
+    bool const threaded_peers = std::is_same<location_tag, tag::cpu>::value
+                                and pack_kernels::use_threads_over_peers(packplan.size(), static_cast<long long>(batch_size) * this->input_size);
+
+    add_trace name("packing");
+    #ifdef Heffte_ENABLE_OPENMP
+    #pragma omp parallel for schedule(dynamic) if(threaded_peers)
+    #endif
+    for(int i=0; i<num_peers; i++){
+        if (packplan[i].size[0] > 0){
+            for(int j=0; j<batch_size; j++){
+                packit.pack(this->stream(), packplan[i], source + send_offset[i] + j * this->input_size,
+                            send_buffer + (i * batch_size + j) * num_entries);
+            }
+        }
+    }
+    this->synchronize_device();
+}
+
+template<typename location_tag, template<typename device> class packer, typename index>
+template<typename scalar_type>
+void reshape3d_alltoall<location_tag, packer, index>::unpack_messages(int batch_size, scalar_type const recv_buffer[], scalar_type destination[],
+                                                                      unpack_hook<scalar_type, index> const &hook) const{
 
     packer<location_tag> packit;
 
-    int offset = 0;
+    int const num_peers = static_cast<int>(unpackplan.size());
+    bool const threaded_peers = std::is_same<location_tag, tag::cpu>::value
+                                and pack_kernels::use_threads_over_peers(unpackplan.size(), static_cast<long long>(batch_size) * this->output_size);
 
-    { add_trace name("packing");
-        for(size_t i=0; i<packplan.size(); i++){
-            if (packplan[i].size[0] > 0){
-                for(int j=0; j<batch_size; j++){
-                    packit.pack(this->stream(), packplan[i], source + send_offset[i] + j * this->input_size, send_buffer + offset);
-                    offset += num_entries;
-                }
-            }else{
-                offset += batch_size * num_entries;
+    add_trace name("unpacking");
+    #ifdef Heffte_ENABLE_OPENMP
+    #pragma omp parallel for schedule(dynamic) if(threaded_peers)
+    #endif
+    for(int i=0; i<num_peers; i++){
+        if (unpackplan[i].size[0] > 0){
+            for(int j=0; j<batch_size; j++){
+                unpack_with_hook(this->stream(), packit, unpackplan[i],
+                                 recv_buffer + (i * batch_size + j) * num_entries,
+                                 destination + recv_offset[i] + j * this->output_size, hook);
             }
         }
-        this->synchronize_device();
     }
+}
+
+template<typename location_tag, template<typename device> class packer, typename index>
+template<typename scalar_type>
+void reshape3d_alltoall<location_tag, packer, index>::apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                                                                 unpack_hook<scalar_type, index> const &hook) const{
+
+    scalar_type *send_buffer = workspace;
+    scalar_type *recv_buffer = workspace + batch_size * num_entries * packplan.size();
+
+    pack_messages(batch_size, source, send_buffer);
 
     #ifdef Heffte_ENABLE_GPU
     if (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware){
@@ -282,21 +326,47 @@ void reshape3d_alltoall<location_tag, packer, index>::apply_base(int batch_size,
     }
     #endif
 
-    offset = 0;
-    { add_trace name("unpacking");
-        for(size_t i=0; i<unpackplan.size(); i++){
-            if (unpackplan[i].size[0] > 0){
-                for(int j=0; j<batch_size; j++){
-                    packit.unpack(this->stream(), unpackplan[i],
-                                  recv_buffer + offset,
-                                  destination + recv_offset[i] + j * this->output_size);
-                    offset += num_entries;
-                }
-            }else{
-                offset += batch_size * num_entries;
-            }
-        }
+    unpack_messages(batch_size, recv_buffer, destination, hook);
+}
+
+template<typename location_tag, template<typename device> class packer, typename index>
+template<typename scalar_type>
+void reshape3d_alltoall<location_tag, packer, index>::start_base(int batch_size, scalar_type const source[], scalar_type destination[],
+                                                                 scalar_type workspace[], reshape_pending &pending) const{
+
+    scalar_type *send_buffer = workspace;
+    scalar_type *recv_buffer = workspace + batch_size * num_entries * packplan.size();
+
+    pack_messages(batch_size, source, send_buffer);
+
+    #ifdef Heffte_ENABLE_GPU
+    if (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware){
+        scalar_type *temp = this->template cpu_send_buffer<scalar_type>(batch_size * num_entries * packplan.size());
+        gpu::transfer::unload(this->stream(), send_buffer, batch_size * num_entries * packplan.size(), temp);
+        send_buffer = temp;
+        recv_buffer = this->template cpu_recv_buffer<scalar_type>(batch_size * num_entries * packplan.size());
     }
+    #endif
+
+    pending = reshape_pending();
+    { add_trace name("iall2all");
+        MPI_Ialltoall(send_buffer, batch_size * num_entries, mpi::type_from<scalar_type>(),
+                      recv_buffer, batch_size * num_entries, mpi::type_from<scalar_type>(),
+                      comm, &pending.request);
+    }
+    if (this->progress)
+        pending.progress = std::make_shared<progress_scope>(this->progress, comm);
+
+    pending.finish = [=]()->void{
+        scalar_type *unpack_buffer = recv_buffer;
+        #ifdef Heffte_ENABLE_GPU
+        if (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware){
+            unpack_buffer = workspace + batch_size * num_entries * packplan.size();
+            gpu::transfer::load(this->stream(), recv_buffer, batch_size * num_entries * packplan.size(), unpack_buffer);
+        }
+        #endif
+        unpack_messages(batch_size, unpack_buffer, destination, unpack_hook<scalar_type, index>());
+    };
 }
 
 template<typename location_tag, template<typename device> class packer, typename index> std::unique_ptr<reshape3d_alltoall<location_tag, packer, index>>
@@ -364,29 +434,70 @@ reshape3d_alltoallv<location_tag, packer, index>::reshape3d_alltoallv(
 
 template<typename location_tag, template<typename device> class packer, typename index>
 template<typename scalar_type>
-void reshape3d_alltoallv<location_tag, packer, index>::apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const{
-
-    scalar_type *send_buffer = workspace;
-    scalar_type *recv_buffer = workspace + batch_size * this->input_size;
+void reshape3d_alltoallv<location_tag, packer, index>::pack_messages(int batch_size, scalar_type const source[], scalar_type send_buffer[]) const{
 
     packer<location_tag> packit;
 
-    int offset = 0;
+    // the offset of each message is batch_size times the displacement for a single transform,
+    // thus the peers are independent and can be processed in parallel
+    int const num_peers = static_cast<int>(send.map.size());
+    bool const threaded_peers = std::is_same<location_tag, tag::cpu>::value
+                                and pack_kernels::use_threads_over_peers(send.map.size(), static_cast<long long>(batch_size) * this->input_size);
 
-    { add_trace name("packing");
-    for(auto isend : send.map){
+    add_trace name("packing");
+    #ifdef Heffte_ENABLE_OPENMP
+    #pragma omp parallel for schedule(dynamic) if(threaded_peers)
+    #endif
+    for(int p=0; p<num_peers; p++){
+        int const isend = send.map[p];
         if (isend >= 0){ // something to send
             for(int j=0; j<batch_size; j++){
                 packit.pack(this->stream(), packplan[isend],
                             source + send_offset[isend] + j * this->input_size,
-                            send_buffer + offset);
-                offset += send_size[isend];
+                            send_buffer + batch_size * send.displacements[p] + j * send_size[isend]);
             }
         }
     }
     // the synchronize_device() is needed to flush the kernels of the asynchronous packing
     this->synchronize_device();
+}
+
+template<typename location_tag, template<typename device> class packer, typename index>
+template<typename scalar_type>
+void reshape3d_alltoallv<location_tag, packer, index>::unpack_messages(int batch_size, scalar_type const recv_buffer[], scalar_type destination[],
+                                                                       unpack_hook<scalar_type, index> const &hook) const{
+
+    packer<location_tag> packit;
+
+    int const num_peers = static_cast<int>(recv.map.size());
+    bool const threaded_peers = std::is_same<location_tag, tag::cpu>::value
+                                and pack_kernels::use_threads_over_peers(recv.map.size(), static_cast<long long>(batch_size) * this->output_size);
+
+    add_trace name("unpacking");
+    #ifdef Heffte_ENABLE_OPENMP
+    #pragma omp parallel for schedule(dynamic) if(threaded_peers)
+    #endif
+    for(int p=0; p<num_peers; p++){
+        int const irecv = recv.map[p];
+        if (irecv >= 0){ // something received
+            for(int j=0; j<batch_size; j++){
+                unpack_with_hook(this->stream(), packit, unpackplan[irecv],
+                                 recv_buffer + batch_size * recv.displacements[p] + j * recv_size[irecv],
+                                 destination + recv_offset[irecv] + j * this->output_size, hook);
+            }
+        }
     }
+}
+
+template<typename location_tag, template<typename device> class packer, typename index>
+template<typename scalar_type>
+void reshape3d_alltoallv<location_tag, packer, index>::apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                                                                  unpack_hook<scalar_type, index> const &hook) const{
+
+    scalar_type *send_buffer = workspace;
+    scalar_type *recv_buffer = workspace + batch_size * this->input_size;
+
+    pack_messages(batch_size, source, send_buffer);
 
     #ifdef Heffte_ENABLE_GPU
     if (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware){
@@ -427,19 +538,61 @@ void reshape3d_alltoallv<location_tag, packer, index>::apply_base(int batch_size
     }
     #endif
 
-    offset = 0;
-    { add_trace name("unpacking");
-    for(auto irecv : recv.map){
-        if (irecv >= 0){ // something received
-            for(int j=0; j<batch_size; j++){
-                packit.unpack(this->stream(), unpackplan[irecv],
-                              recv_buffer + offset,
-                              destination + recv_offset[irecv] + j * this->output_size);
-                offset += recv_size[irecv];
-            }
-        }
+    unpack_messages(batch_size, recv_buffer, destination, hook);
+}
+
+template<typename location_tag, template<typename device> class packer, typename index>
+template<typename scalar_type>
+void reshape3d_alltoallv<location_tag, packer, index>::start_base(int batch_size, scalar_type const source[], scalar_type destination[],
+                                                                  scalar_type workspace[], reshape_pending &pending) const{
+
+    scalar_type *send_buffer = workspace;
+    scalar_type *recv_buffer = workspace + batch_size * this->input_size;
+
+    pack_messages(batch_size, source, send_buffer);
+
+    #ifdef Heffte_ENABLE_GPU
+    if (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware){
+        scalar_type *temp = this->template cpu_send_buffer<scalar_type>(batch_size * this->input_size);
+        gpu::transfer::unload(this->stream(), send_buffer, batch_size * this->input_size, temp);
+        send_buffer = temp;
+        recv_buffer = this->template cpu_recv_buffer<scalar_type>(batch_size * this->output_size);
     }
+    #endif
+
+    // the counts and displacements must persist until the communication completes, keep them in the pending struct
+    size_t const num_peers = send.counts.size();
+    pending = reshape_pending();
+    pending.counts.resize(4 * num_peers);
+    int *send_counts        = pending.counts.data();
+    int *send_displacements = send_counts + num_peers;
+    int *recv_counts        = send_displacements + num_peers;
+    int *recv_displacements = recv_counts + num_peers;
+    for(size_t i=0; i<num_peers; i++){
+        send_counts[i]        = batch_size * send.counts[i];
+        send_displacements[i] = batch_size * send.displacements[i];
+        recv_counts[i]        = batch_size * recv.counts[i];
+        recv_displacements[i] = batch_size * recv.displacements[i];
     }
+
+    { add_trace name("iall2allv");
+        MPI_Ialltoallv(send_buffer, send_counts, send_displacements, mpi::type_from<scalar_type>(),
+                       recv_buffer, recv_counts, recv_displacements, mpi::type_from<scalar_type>(),
+                       comm, &pending.request);
+    }
+    if (this->progress)
+        pending.progress = std::make_shared<progress_scope>(this->progress, comm);
+
+    pending.finish = [=]()->void{
+        scalar_type *unpack_buffer = recv_buffer;
+        #ifdef Heffte_ENABLE_GPU
+        if (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware){
+            unpack_buffer = workspace + batch_size * this->input_size;
+            gpu::transfer::load(this->stream(), recv_buffer, batch_size * this->output_size, unpack_buffer);
+        }
+        #endif
+        unpack_messages(batch_size, unpack_buffer, destination, unpack_hook<scalar_type, index>());
+    };
 }
 
 template<typename location_tag, template<typename device> class packer, typename index>
@@ -505,7 +658,8 @@ reshape3d_pointtopoint<location_tag, packer, index>::reshape3d_pointtopoint(
                         std::vector<int> &&csend_offset, std::vector<int> &&csend_size, std::vector<int> &&csend_proc,
                         std::vector<int> &&crecv_offset, std::vector<int> &&crecv_size, std::vector<int> &&crecv_proc,
                         std::vector<int> &&crecv_loc,
-                        std::vector<pack_plan_3d<index>> &&cpackplan, std::vector<pack_plan_3d<index>> &&cunpackplan
+                        std::vector<pack_plan_3d<index>> &&cpackplan, std::vector<pack_plan_3d<index>> &&cunpackplan,
+                        bool clow_memory
                                                                 ) :
     reshape3d_base<index>(cinput_size, coutput_size),
     backend::device_instance<location_tag>(q),
@@ -513,6 +667,7 @@ reshape3d_pointtopoint<location_tag, packer, index>::reshape3d_pointtopoint(
     self_to_self(not crecv_proc.empty() and (crecv_proc.back() == me)), // check whether we should include "me" in the communication scheme
     algorithm(alg),
     use_gpu_aware( (disable_gpu_aware::value) ? false : gpu_aware ),
+    low_memory(clow_memory),
     requests(crecv_proc.size() + ((self_to_self) ? -1 : 0)), // remove 1 if using self-to-self
     isends(csend_proc.size() + ((self_to_self) ? -1 : 0)), // remove 1 if using self-to-self
     send_proc(std::move(csend_proc)), send_offset(std::move(csend_offset)), send_size(std::move(csend_size)),
@@ -522,18 +677,32 @@ reshape3d_pointtopoint<location_tag, packer, index>::reshape3d_pointtopoint(
     recv_total(std::accumulate(recv_size.begin(), recv_size.end(), 0)),
     packplan(std::move(cpackplan)), unpackplan(std::move(cunpackplan))
 {
-    if (algorithm == reshape_algorithm::p2p_plined){
+    if (algorithm == reshape_algorithm::p2p_plined and not low_memory){
         max_send_size = this->input_size;
     }else{
         max_send_size = 0;
         for(auto s : send_size) if (max_send_size < s) max_send_size = s;
     }
+    max_recv_size = 0;
+    for(auto s : recv_size) if (max_recv_size < s) max_recv_size = s;
+
+    if (low_memory){
+        std::vector<int> send_index(nprocs, -1), recv_index(nprocs, -1);
+        for(size_t i=0; i<send_proc.size(); i++) send_index[send_proc[i]] = static_cast<int>(i);
+        for(size_t i=0; i<recv_proc.size(); i++) recv_index[recv_proc[i]] = static_cast<int>(i);
+        for(int k=0; k<nprocs; k++){
+            std::array<int, 2> const round = {send_index[(me + k) % nprocs], recv_index[(me + nprocs - k) % nprocs]};
+            if (round[0] != -1 or round[1] != -1)
+                rounds.push_back(round);
+        }
+    }
 }
 
 #ifdef Heffte_ENABLE_GPU
 template<typename location_tag, template<typename device> class packer, typename index>
 template<typename scalar_type>
-void reshape3d_pointtopoint<location_tag, packer, index>::no_gpuaware_send_recv(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const{
+void reshape3d_pointtopoint<location_tag, packer, index>::no_gpuaware_send_recv(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                                                                                unpack_hook<scalar_type, index> const &hook) const{
     scalar_type *send_buffer = workspace;
     scalar_type *recv_buffer = workspace + batch_size * this->input_size;
 
@@ -551,6 +720,8 @@ void reshape3d_pointtopoint<location_tag, packer, index>::no_gpuaware_send_recv(
         MPI_Irecv(cpu_recv + batch_size * recv_loc[i], batch_size * recv_size[i], mpi::type_from<scalar_type>(),
                   recv_proc[i], 0, comm, &requests[i]);
     }
+    // the helper thread (if any) moves the messages while this thread packs and unpacks
+    progress_scope busy(this->progress, comm);
 
     // perform the send commands, using blocking send
     if (algorithm == reshape_algorithm::p2p_plined){
@@ -598,8 +769,8 @@ void reshape3d_pointtopoint<location_tag, packer, index>::no_gpuaware_send_recv(
 
         { heffte::add_trace name("self unpacking");
             for(int j=0; j<batch_size; j++){
-                packit.unpack(this->stream(), unpackplan.back(), recv_buffer + batch_size * recv_loc.back() + j * send_size.back(),
-                              destination + j * this->output_size + recv_offset.back());
+                unpack_with_hook(this->stream(), packit, unpackplan.back(), recv_buffer + batch_size * recv_loc.back() + j * send_size.back(),
+                                 destination + j * this->output_size + recv_offset.back(), hook);
             }
         }
     }
@@ -613,8 +784,8 @@ void reshape3d_pointtopoint<location_tag, packer, index>::no_gpuaware_send_recv(
                             recv_buffer + batch_size * recv_loc[irecv]);
         { heffte::add_trace name("unpacking from " + std::to_string(recv_proc[irecv]));
             for(int j=0; j<batch_size; j++){
-                packit.unpack(this->stream(), unpackplan[irecv], recv_buffer + batch_size * recv_loc[irecv] + j * recv_size[irecv],
-                              destination + j * this->output_size + recv_offset[irecv]);
+                unpack_with_hook(this->stream(), packit, unpackplan[irecv], recv_buffer + batch_size * recv_loc[irecv] + j * recv_size[irecv],
+                                 destination + j * this->output_size + recv_offset[irecv], hook);
             }
         }
     }
@@ -626,11 +797,17 @@ void reshape3d_pointtopoint<location_tag, packer, index>::no_gpuaware_send_recv(
 
 template<typename location_tag, template<typename device> class packer, typename index>
 template<typename scalar_type>
-void reshape3d_pointtopoint<location_tag, packer, index>::apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[]) const{
+void reshape3d_pointtopoint<location_tag, packer, index>::apply_base(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                                                                     unpack_hook<scalar_type, index> const &hook) const{
+
+    if (low_memory){
+        pairwise_send_recv(batch_size, source, destination, workspace, hook);
+        return;
+    }
 
     #ifdef Heffte_ENABLE_GPU
     if (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware){
-        no_gpuaware_send_recv(batch_size, source, destination, workspace);
+        no_gpuaware_send_recv(batch_size, source, destination, workspace, hook);
         return;
     }
     #endif
@@ -649,6 +826,8 @@ void reshape3d_pointtopoint<location_tag, packer, index>::apply_base(int batch_s
         MPI_Irecv(recv_buffer + batch_size * recv_loc[i], batch_size * recv_size[i], mpi::type_from<scalar_type>(),
                   recv_proc[i], 0, comm, &requests[i]);
     }
+    // the helper thread (if any) moves the messages while this thread packs and unpacks
+    progress_scope busy(this->progress, comm);
 
     // perform the send commands, using blocking send
     size_t offset = 0;
@@ -684,8 +863,8 @@ void reshape3d_pointtopoint<location_tag, packer, index>::apply_base(int batch_s
 
         { heffte::add_trace name("self unpacking");
             for(int j=0; j<batch_size; j++){
-                packit.unpack(this->stream(), unpackplan.back(), recv_buffer + batch_size * recv_loc.back() + j * send_size.back(),
-                              destination + j * this->output_size + recv_offset.back());
+                unpack_with_hook(this->stream(), packit, unpackplan.back(), recv_buffer + batch_size * recv_loc.back() + j * send_size.back(),
+                                 destination + j * this->output_size + recv_offset.back(), hook);
             }
         }
     }
@@ -703,8 +882,8 @@ void reshape3d_pointtopoint<location_tag, packer, index>::apply_base(int batch_s
 
         { heffte::add_trace name("unpacking from " + std::to_string(irecv));
             for(int j=0; j<batch_size; j++){
-                packit.unpack(this->stream(), unpackplan[irecv], recv_buffer + batch_size * recv_loc[irecv] + j * recv_size[irecv],
-                              destination + j * this->output_size + recv_offset[irecv]);
+                unpack_with_hook(this->stream(), packit, unpackplan[irecv], recv_buffer + batch_size * recv_loc[irecv] + j * recv_size[irecv],
+                                 destination + j * this->output_size + recv_offset[irecv], hook);
             }
         }
     }
@@ -713,13 +892,98 @@ void reshape3d_pointtopoint<location_tag, packer, index>::apply_base(int batch_s
         MPI_Waitall(isends.size(), isends.data(), MPI_STATUS_IGNORE);
 }
 
+template<typename location_tag, template<typename device> class packer, typename index>
+template<typename scalar_type>
+void reshape3d_pointtopoint<location_tag, packer, index>::pairwise_send_recv(int batch_size, scalar_type const source[], scalar_type destination[], scalar_type workspace[],
+                                                                             unpack_hook<scalar_type, index> const &hook) const{
+    if (source == destination)
+        throw std::runtime_error("heffte internal error: in-place call to a low-memory reshape");
+
+    scalar_type *send_buffer = workspace;
+    scalar_type *recv_buffer = workspace + batch_size * max_send_size;
+
+    #ifdef Heffte_ENABLE_GPU
+    bool const stage_on_cpu = (std::is_same<location_tag, tag::gpu>::value and not use_gpu_aware);
+    scalar_type *cpu_send = (stage_on_cpu) ? this->template cpu_send_buffer<scalar_type>(batch_size * max_send_size) : send_buffer;
+    scalar_type *cpu_recv = (stage_on_cpu) ? this->template cpu_recv_buffer<scalar_type>(batch_size * max_recv_size) : recv_buffer;
+    #else
+    scalar_type *cpu_send = send_buffer;
+    scalar_type *cpu_recv = recv_buffer;
+    #endif
+
+    packer<location_tag> packit;
+
+    // synchronize before starting the receives, because otherwise kernels could be still using
+    // the workspace
+    this->synchronize_device();
+    for(auto const &round : rounds){
+        int const isend = round[0];
+        int const irecv = round[1];
+
+        if (isend != -1 and send_proc[isend] == me){ // self-to-self, the message does not leave the send buffer
+            { heffte::add_trace name("self packing");
+                for(int j=0; j<batch_size; j++)
+                    packit.pack(this->stream(), packplan[isend], source + j * this->input_size + send_offset[isend],
+                                send_buffer + j * send_size[isend]);
+            }
+            { heffte::add_trace name("self unpacking");
+                for(int j=0; j<batch_size; j++)
+                    unpack_with_hook(this->stream(), packit, unpackplan[irecv], send_buffer + j * send_size[isend],
+                                     destination + j * this->output_size + recv_offset[irecv], hook);
+            }
+            continue;
+        }
+
+        MPI_Request request = MPI_REQUEST_NULL;
+        if (irecv != -1){
+            heffte::add_trace name("irecv " + std::to_string(batch_size * recv_size[irecv]) + " from " + std::to_string(recv_proc[irecv]));
+            MPI_Irecv(cpu_recv, batch_size * recv_size[irecv], mpi::type_from<scalar_type>(), recv_proc[irecv], 0, comm, &request);
+        }
+
+        if (isend != -1){
+            { heffte::add_trace name("packing");
+                for(int j=0; j<batch_size; j++)
+                    packit.pack(this->stream(), packplan[isend], source + j * this->input_size + send_offset[isend],
+                                send_buffer + j * send_size[isend]);
+
+                this->synchronize_device();
+            }
+            #ifdef Heffte_ENABLE_GPU
+            if (stage_on_cpu)
+                gpu::transfer::unload(this->stream(), send_buffer, batch_size * send_size[isend], cpu_send);
+            #endif
+            heffte::add_trace name("send " + std::to_string(batch_size * send_size[isend]) + " for " + std::to_string(send_proc[isend]));
+            MPI_Send(cpu_send, batch_size * send_size[isend], mpi::type_from<scalar_type>(), send_proc[isend], 0, comm);
+        }
+
+        if (irecv != -1){
+            { heffte::add_trace name("wait");
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            }
+            #ifdef Heffte_ENABLE_GPU
+            if (stage_on_cpu)
+                gpu::transfer::load(this->stream(), cpu_recv, batch_size * recv_size[irecv], recv_buffer);
+            #endif
+            #ifdef Heffte_ENABLE_ROCM // this synch is not needed under CUDA
+            if (std::is_same<location_tag, tag::gpu>::value)
+                gpu::synchronize_default_stream();
+            #endif
+
+            heffte::add_trace name("unpacking from " + std::to_string(recv_proc[irecv]));
+            for(int j=0; j<batch_size; j++)
+                unpack_with_hook(this->stream(), packit, unpackplan[irecv], recv_buffer + j * recv_size[irecv],
+                                 destination + j * this->output_size + recv_offset[irecv], hook);
+        }
+    }
+}
+
 template<typename location_tag, template<typename device> class packer, typename index>
 std::unique_ptr<reshape3d_pointtopoint<location_tag, packer, index>>
 make_reshape3d_pointtopoint(typename backend::device_instance<location_tag>::stream_type stream,
                          std::vector<box3d<index>> const &input_boxes,
                          std::vector<box3d<index>> const &output_boxes,
                          reshape_algorithm algorithm, bool uses_gpu_aware,
-                         MPI_Comm const comm){
+                         MPI_Comm const comm, bool low_memory){
 
     int const me = mpi::comm_rank(comm);
     int const nprocs = mpi::comm_size(comm);
@@ -764,19 +1028,28 @@ make_reshape3d_pointtopoint(typename backend::device_instance<location_tag>::str
         std::move(send_offset), std::move(send_size), std::move(send_proc),
         std::move(recv_offset), std::move(recv_size), std::move(recv_proc),
         std::move(recv_loc),
-        std::move(packplan), std::move(unpackplan)
+        std::move(packplan), std::move(unpackplan),
+        low_memory
                                                        ));
 }
 
 #define heffte_instantiate_reshape3d_algorithm(alg, make_alg, some_backend, index) \
-template void alg<some_backend, direct_packer, index>::apply_base<float>(int, float const[], float[], float[]) const; \
-template void alg<some_backend, direct_packer, index>::apply_base<double>(int, double const[], double[], double[]) const; \
-template void alg<some_backend, direct_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[]) const; \
-template void alg<some_backend, direct_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> []) const; \
-template void alg<some_backend, transpose_packer, index>::apply_base<float>(int, float const[], float[], float[]) const; \
-template void alg<some_backend, transpose_packer, index>::apply_base<double>(int, double const[], double[], double[]) const; \
-template void alg<some_backend, transpose_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[]) const; \
-template void alg<some_backend, transpose_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> []) const; \
+template void alg<some_backend, direct_packer, index>::apply_base<float>(int, float const[], float[], float[], unpack_hook<float, index> const&) const; \
+template void alg<some_backend, direct_packer, index>::apply_base<double>(int, double const[], double[], double[], unpack_hook<double, index> const&) const; \
+template void alg<some_backend, direct_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[], unpack_hook<std::complex<float>, index> const&) const; \
+template void alg<some_backend, direct_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> [], unpack_hook<std::complex<double>, index> const&) const; \
+template void alg<some_backend, transpose_packer, index>::apply_base<float>(int, float const[], float[], float[], unpack_hook<float, index> const&) const; \
+template void alg<some_backend, transpose_packer, index>::apply_base<double>(int, double const[], double[], double[], unpack_hook<double, index> const&) const; \
+template void alg<some_backend, transpose_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[], unpack_hook<std::complex<float>, index> const&) const; \
+template void alg<some_backend, transpose_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> [], unpack_hook<std::complex<double>, index> const&) const; \
+template void alg<some_backend, direct_packer, index>::start_base<float>(int, float const[], float[], float[], reshape_pending&) const; \
+template void alg<some_backend, direct_packer, index>::start_base<double>(int, double const[], double[], double[], reshape_pending&) const; \
+template void alg<some_backend, direct_packer, index>::start_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[], reshape_pending&) const; \
+template void alg<some_backend, direct_packer, index>::start_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> [], reshape_pending&) const; \
+template void alg<some_backend, transpose_packer, index>::start_base<float>(int, float const[], float[], float[], reshape_pending&) const; \
+template void alg<some_backend, transpose_packer, index>::start_base<double>(int, double const[], double[], double[], reshape_pending&) const; \
+template void alg<some_backend, transpose_packer, index>::start_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[], reshape_pending&) const; \
+template void alg<some_backend, transpose_packer, index>::start_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> [], reshape_pending&) const; \
  \
 template std::unique_ptr<alg<some_backend, direct_packer, index>> \
 make_alg<some_backend, direct_packer, index>(typename backend::device_instance<some_backend>::stream_type, std::vector<box3d<index>> const&, \
@@ -790,23 +1063,23 @@ make_alg<some_backend, transpose_packer, index>(typename backend::device_instanc
 heffte_instantiate_reshape3d_algorithm(reshape3d_alltoall, make_reshape3d_alltoall, some_backend, index) \
 heffte_instantiate_reshape3d_algorithm(reshape3d_alltoallv, make_reshape3d_alltoallv, some_backend, index) \
  \
-template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<float>(int, float const[], float[], float[]) const; \
-template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<double>(int, double const[], double[], double[]) const; \
-template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[]) const; \
-template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> []) const; \
-template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<float>(int, float const[], float[], float[]) const; \
-template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<double>(int, double const[], double[], double[]) const; \
-template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[]) const; \
-template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> []) const; \
+template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<float>(int, float const[], float[], float[], unpack_hook<float, index> const&) const; \
+template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<double>(int, double const[], double[], double[], unpack_hook<double, index> const&) const; \
+template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[], unpack_hook<std::complex<float>, index> const&) const; \
+template void reshape3d_pointtopoint<some_backend, direct_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> [], unpack_hook<std::complex<double>, index> const&) const; \
+template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<float>(int, float const[], float[], float[], unpack_hook<float, index> const&) const; \
+template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<double>(int, double const[], double[], double[], unpack_hook<double, index> const&) const; \
+template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<std::complex<float>>(int, std::complex<float> const[], std::complex<float>[], std::complex<float>[], unpack_hook<std::complex<float>, index> const&) const; \
+template void reshape3d_pointtopoint<some_backend, transpose_packer, index>::apply_base<std::complex<double>>(int, std::complex<double> const[], std::complex<double> [], std::complex<double> [], unpack_hook<std::complex<double>, index> const&) const; \
  \
 template std::unique_ptr<reshape3d_pointtopoint<some_backend, direct_packer, index>> \
 make_reshape3d_pointtopoint<some_backend, direct_packer, index>(typename backend::device_instance<some_backend>::stream_type, \
                                                               std::vector<box3d<index>> const&, \
-                                                              std::vector<box3d<index>> const&, reshape_algorithm, bool, MPI_Comm const); \
+                                                              std::vector<box3d<index>> const&, reshape_algorithm, bool, MPI_Comm const, bool); \
 template std::unique_ptr<reshape3d_pointtopoint<some_backend, transpose_packer, index>> \
 make_reshape3d_pointtopoint<some_backend, transpose_packer, index>(typename backend::device_instance<some_backend>::stream_type, \
                                                                  std::vector<box3d<index>> const&, \
-                                                                 std::vector<box3d<index>> const&, reshape_algorithm, bool, MPI_Comm const); \
+                                                                 std::vector<box3d<index>> const&, reshape_algorithm, bool, MPI_Comm const, bool); \
 
 heffte_instantiate_reshape3d(tag::cpu, int)
 heffte_instantiate_reshape3d(tag::cpu, long long)
@@ -214,6 +214,19 @@ void perform_tests(int backend, MPI_Comm const comm){
     hassert(approx_dinput(dresult, dinput) == Heffte_SUCCESS);
     free(dresult);
 
+    // asynchronous variants, poll one request and wait for the other
+    heffte_request request;
+    heffte_forward_d2z_async(plan, dinput, zoutput, NULL, Heffte_SCALE_NONE, &request);
+    while(heffte_request_test(&request) == 0);
+    hassert(request == NULL);
+    hassert(approx_zoutput(zoutput, zrefoutput) == Heffte_SUCCESS);
+
+    dresult = calloc(64, sizeof(double));
+    heffte_backward_z2d_async(plan, zoutput, dresult, workspace, Heffte_SCALE_FULL, &request);
+    heffte_request_wait(&request);
+    hassert(approx_dinput(dresult, dinput) == Heffte_SUCCESS);
+    free(dresult);
+
     hassert(heffte_plan_destroy(plan) == Heffte_SUCCESS);
 
     hassert(heffte_plan_create_r2c(backend, full_low, full_high, NULL, r2c_low, r2c_high, NULL, 2, comm, NULL, &plan) == Heffte_SUCCESS);
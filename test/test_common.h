@@ -307,10 +307,27 @@ heffte::plan_options args_to_options(std::deque<std::string> const &args){
             options.use_pencils = false;
         }else if (s == "-no-gpu-aware"){
             options.use_gpu_aware = false;
+        }else if (s == "-autotune"){
+            options.use_autotune = true;
+        }else if (s == "-grid-model"){
+            options.grid_search = grid_selection::model;
+        }else if (s == "-grid-measure"){
+            options.grid_search = grid_selection::measured;
+        }else if (s == "-low-memory"){
+            options.use_low_memory = true;
+        }else if (s == "-progress-thread"){
+            options.use_progress_thread = true;
         }
     }
     int subcomm = get_subcomm(args);
     if (subcomm != -1) options.use_num_subranks(subcomm);
+    for(auto iopt = args.begin(); iopt != args.end(); iopt++){
+        if (*iopt == "-threads"){
+            if (std::next(iopt) == args.end())
+                throw std::runtime_error("-threads must be followed by an integer");
+            options.num_threads = std::stoi(*std::next(iopt));
+        }
+    }
     return options;
 }
 
@@ -125,6 +125,122 @@ void test_cross_reference(MPI_Comm comm){
 }
 
 
+/*
+ * Naive 1-D transform of the given kind applied in direction dir of the world array,
+ * the sine and cosine transforms act on the real and imaginary parts independently.
+ */
+void naive_transform(std::array<int, 3> const size, int dir, heffte::transform_kind kind, std::vector<std::complex<double>> &data){
+    double const pi = 3.14159265358979323846;
+    int const n = size[dir];
+    std::array<int, 3> const stride = {1, size[0], size[0] * size[1]};
+    std::vector<std::complex<double>> line(n);
+    for(int k=0; k<size[2]; k++){
+        for(int j=0; j<size[1]; j++){
+            for(int i=0; i<size[0]; i++){
+                std::array<int, 3> const idx = {i, j, k};
+                if (idx[dir] != 0) continue;
+                int const offset = i + size[0] * (j + size[1] * k);
+                for(int p=0; p<n; p++){
+                    line[p] = 0.0;
+                    for(int q=0; q<n; q++){
+                        std::complex<double> const x = data[offset + q * stride[dir]];
+                        switch(kind){
+                            case heffte::transform_kind::dct1:
+                                line[p] += x * ((q == 0 or q == n-1) ? 1.0 : 2.0) * std::cos(pi * p * q / (n - 1));
+                                break;
+                            case heffte::transform_kind::dct2:
+                                line[p] += 2.0 * x * std::cos(pi * p * (2 * q + 1) / (2.0 * n));
+                                break;
+                            case heffte::transform_kind::dst2:
+                                line[p] += 2.0 * x * std::sin(pi * (p + 1) * (2 * q + 1) / (2.0 * n));
+                                break;
+                            default:
+                                line[p] += x * std::exp(std::complex<double>(0.0, -2.0 * pi * p * q / n));
+                        }
+                    }
+                }
+                for(int p=0; p<n; p++) data[offset + p * stride[dir]] = line[p];
+            }
+        }
+    }
+}
+
+template<typename backend_tag>
+void test_mixed_kinds(MPI_Comm comm, std::array<heffte::transform_kind, 3> const kinds){
+    using heffte::transform_kind;
+    int const me = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  mixed kinds", comm);
+
+    box3d<> const world = {{0, 0, 0}, {5, 4, 3}};
+    int r2c_direction = -1;
+    for(int i=0; i<3; i++) if (kinds[i] == transform_kind::fft_r2c) r2c_direction = i;
+    box3d<> const out_world = (r2c_direction == -1) ? world : world.r2c(r2c_direction);
+
+    std::vector<double> world_input = make_data<double>(world);
+    std::vector<std::complex<double>> world_result(world_input.begin(), world_input.end());
+    for(int i=0; i<3; i++)
+        naive_transform(world.size, i, kinds[i], world_result);
+    if (r2c_direction != -1) // drop the conjugate coefficients
+        world_result = get_subbox(world, out_world, world_result);
+
+    std::array<int, 3> in_grid = {1, 1, 1}, out_grid = {1, 1, 1};
+    if (num_ranks == 2){
+        in_grid = {1, 2, 1};
+        out_grid = {2, 1, 1};
+    }else if (num_ranks == 4){
+        in_grid = {2, 2, 1};
+        out_grid = {1, 2, 2};
+    }
+    box3d<> const inbox  = heffte::split_world(world, in_grid)[me];
+    box3d<> const outbox = heffte::split_world(out_world, out_grid)[me];
+
+    std::vector<double> const input = get_subbox(world, inbox, world_input);
+    std::vector<std::complex<double>> const reference = get_subbox(out_world, outbox, world_result);
+
+    for(auto const &options : make_all_options<backend_tag>()){
+        if (not options.use_pencils) continue;
+        heffte::fft3d_mixed<backend_tag> fft(inbox, outbox, kinds, comm, options);
+        tassert(fft.complex_output() == (r2c_direction != -1));
+
+        std::vector<double> inverse(fft.size_inbox());
+        if (fft.complex_output()){
+            std::vector<std::complex<double>> result(fft.size_outbox());
+            fft.forward(input.data(), result.data());
+            tassert(approx(result, reference));
+            fft.backward(result.data(), inverse.data(), heffte::scale::full);
+        }else{
+            std::vector<double> result(fft.size_outbox());
+            std::vector<double> workspace(fft.size_workspace());
+            fft.forward(input.data(), result.data(), workspace.data());
+            std::vector<std::complex<double>> cresult(result.begin(), result.end());
+            tassert(approx(cresult, reference));
+            fft.backward(result.data(), inverse.data(), workspace.data(), heffte::scale::full);
+        }
+        tassert(approx(inverse, input));
+    }
+}
+
+template<typename backend_tag>
+void test_mixed_transform(MPI_Comm comm){
+    using heffte::transform_kind;
+    test_mixed_kinds<backend_tag>(comm, {transform_kind::fft_r2c, transform_kind::fft, transform_kind::dct2});
+    test_mixed_kinds<backend_tag>(comm, {transform_kind::dct2, transform_kind::fft, transform_kind::fft_r2c});
+    test_mixed_kinds<backend_tag>(comm, {transform_kind::dst2, transform_kind::fft_r2c, transform_kind::dct1});
+    test_mixed_kinds<backend_tag>(comm, {transform_kind::dct1, transform_kind::dst2, transform_kind::dct2});
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(mpi::comm_size(comm)) + "  mixed invalid", comm);
+    box3d<> const world = {{0, 0, 0}, {5, 4, 3}};
+    box3d<> const box = heffte::split_world(world, {1, 1, mpi::comm_size(comm)})[mpi::comm_rank(comm)];
+    bool has_thrown = false;
+    try{
+        heffte::fft3d_mixed<backend_tag> fft(box, box, {transform_kind::fft, transform_kind::fft, transform_kind::dct2}, comm);
+    }catch(std::invalid_argument &){
+        has_thrown = true;
+    }
+    tassert(has_thrown);
+}
+
 void perform_tests(MPI_Comm const comm){
     all_tests<> name("cosine transforms");
 
@@ -136,6 +252,7 @@ void perform_tests(MPI_Comm const comm){
     test_cosine_transform<backend::stock_sin, double>(comm);
     test_cosine_transform<backend::stock_cos1, float>(comm);
     test_cosine_transform<backend::stock_cos1, double>(comm);
+    test_mixed_transform<backend::stock>(comm);
     #ifdef Heffte_ENABLE_FFTW
     test_cosine_transform<backend::fftw_cos, float>(comm);
     test_cosine_transform<backend::fftw_cos, double>(comm);
@@ -145,6 +262,7 @@ void perform_tests(MPI_Comm const comm){
     test_cosine_transform<backend::fftw_cos1, double>(comm);
     test_cosine_transform<backend::fftw_sin1, float>(comm);
     test_cosine_transform<backend::fftw_sin1, double>(comm);
+    test_mixed_transform<backend::fftw>(comm);
     #endif
     #ifdef Heffte_ENABLE_MKL
     test_cosine_transform<backend::mkl_cos, float>(comm);
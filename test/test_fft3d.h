@@ -368,17 +368,24 @@ void test_fft3d_vectors_2d(MPI_Comm comm){
     std::array<heffte::scale, 3> fscale = {heffte::scale::none, heffte::scale::symmetric, heffte::scale::full};
     std::array<heffte::scale, 3> bscale = {heffte::scale::full, heffte::scale::symmetric, heffte::scale::none};
 
-    for(auto const &options : make_all_options<backend_tag>()){
+    for(auto options : make_all_options<backend_tag>()){
+    // the 2D planner ignores the pencils/slabs option, use the slabs variant to test the 3D plan logic
+    options.use_2d_planner = options.use_pencils;
     for(int i=0; i<3; i++){
         std::array<int, 3> split = (i == 0) ? std::array<int, 3>{3, 2, 1} : std::array<int, 3>{2, 3, 1};
-        if (num_ranks == 4) split = {2, 2, 1};
+        std::array<int, 3> out_split = split;
+        if (num_ranks == 4){ // bricks, slabs and slabs to transposed slabs
+            split     = (i == 0) ? std::array<int, 3>{2, 2, 1} : std::array<int, 3>{1, 4, 1};
+            out_split = (i == 2) ? std::array<int, 3>{4, 1, 1} : split;
+        }
         std::vector<box3d<>> boxes = heffte::split_world(world, split);
+        std::vector<box3d<>> out_boxes = heffte::split_world(world, out_split);
         assert(boxes.size() == static_cast<size_t>(num_ranks));
 
         box2d<> const inbox  = box2d<>(std::array<int, 2>{boxes[me].low[0], boxes[me].low[1]},
                                        std::array<int, 2>{boxes[me].high[0], boxes[me].high[1]});
-        box2d<> const outbox = box2d<>(std::array<int, 2>{boxes[me].low[0], boxes[me].low[1]},
-                                       std::array<int, 2>{boxes[me].high[0], boxes[me].high[1]});
+        box2d<> const outbox = box2d<>(std::array<int, 2>{out_boxes[me].low[0], out_boxes[me].low[1]},
+                                       std::array<int, 2>{out_boxes[me].high[0], out_boxes[me].high[1]});
 
         auto local_input   = input_maker<backend_tag, scalar_type>::select(world, inbox, world_input);
         auto reference_fft = rescale(world, get_subbox(world, outbox, world_fft), fscale[i]);
@@ -571,4 +578,883 @@ void test_batch_cases(MPI_Comm const comm){
     }
 }
 
+template<typename backend_tag>
+void test_async_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using input_type  = double;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+    int const batch_size = 3;
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test async transform", comm);
+
+    box3d<> const  world = {{0, 0, 0}, {7, 8, 9}};
+
+    // use different input and output grids to force reshapes at the start and end of the transform
+    std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+
+    box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+    box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+
+    auto world_input = make_data<input_type>(batch_size, world);
+    auto world_fft = forward_fft<backend_tag>(world, world_input, batch_size);
+
+    auto local_input = input_maker<backend_tag, input_type>::select(batch_size, world, inbox, world_input);
+    auto local_ref   = get_subboxes(batch_size, world, outbox, world_fft);
+
+    box3d<int> const r2c_world_out = world.r2c(0);
+    auto r2c_world_input = make_data<input_type>(world);
+    auto r2c_world_fft = get_subbox(world, r2c_world_out, forward_fft<backend_tag>(world, r2c_world_input));
+    box3d<int> r2c_outbox = heffte::split_world(r2c_world_out, proc_o)[me];
+    auto r2c_local_input = input_maker<backend_tag, input_type>::select(world, inbox, r2c_world_input);
+    auto r2c_local_ref   = get_subbox(r2c_world_out, r2c_outbox, r2c_world_fft);
+
+    backend::device_instance<location_tag> device;
+
+    for(auto const &alg : std::vector<reshape_algorithm>{
+        reshape_algorithm::alltoall, reshape_algorithm::alltoallv,
+        reshape_algorithm::p2p, reshape_algorithm::p2p_plined}){
+
+        heffte::plan_options options = default_options<backend_tag>();
+        options.algorithm = alg;
+
+        auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, options);
+
+        auto lresult = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_outbox());
+        auto lback   = make_buffer_container<input_type>(device.stream(), batch_size * fft.size_inbox());
+        auto workspace  = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_workspace());
+
+        // progress using test()
+        fft_request request = fft.forward_async(batch_size, local_input.data(), lresult.data(), workspace.data());
+        while(not request.test());
+        tassert(approx(lresult, local_ref));
+
+        request = fft.backward_async(batch_size, lresult.data(), lback.data(), heffte::scale::full);
+        request.wait();
+        tassert(approx(local_input, lback));
+
+        auto fft_r2c = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 0, comm, options);
+
+        auto r2c_result = make_buffer_container<output_type>(device.stream(), fft_r2c.size_outbox());
+        auto r2c_back   = make_buffer_container<input_type>(device.stream(), fft_r2c.size_inbox());
+
+        request = fft_r2c.forward_async(r2c_local_input.data(), r2c_result.data());
+        request.wait();
+        tassert(approx(r2c_result, r2c_local_ref));
+
+        { // the destructor completes the transform
+            fft_request scoped_request = fft_r2c.backward_async(r2c_result.data(), r2c_back.data(), heffte::scale::full);
+        }
+        tassert(approx(r2c_local_input, r2c_back));
+    }
+}
+
+template<typename backend_tag>
+void test_low_memory_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using input_type  = double;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+    int const batch_size = 3;
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test low-memory", comm);
+
+    box3d<> const  world = {{0, 0, 0}, {7, 8, 9}};
+
+    // use different input and output grids to force reshapes at the start and end of the transform
+    std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+
+    box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+    box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+
+    auto world_input = make_data<input_type>(batch_size, world);
+    auto world_fft = forward_fft<backend_tag>(world, world_input, batch_size);
+    auto cworld_input = make_data<output_type>(batch_size, world);
+    auto cworld_fft   = forward_fft<backend_tag>(world, cworld_input, batch_size);
+
+    auto local_input  = input_maker<backend_tag, input_type>::select(batch_size, world, inbox, world_input);
+    auto clocal_input = input_maker<backend_tag, output_type>::select(batch_size, world, inbox, cworld_input);
+    auto local_ref    = get_subboxes(batch_size, world, outbox, world_fft);
+    auto clocal_ref   = get_subboxes(batch_size, world, outbox, cworld_fft);
+
+    box3d<int> const r2c_world_out = world.r2c(0);
+    auto r2c_world_input = make_data<input_type>(world);
+    auto r2c_world_fft = get_subbox(world, r2c_world_out, forward_fft<backend_tag>(world, r2c_world_input));
+    box3d<int> r2c_outbox = heffte::split_world(r2c_world_out, proc_o)[me];
+    auto r2c_local_input = input_maker<backend_tag, input_type>::select(world, inbox, r2c_world_input);
+    auto r2c_local_ref   = get_subbox(r2c_world_out, r2c_outbox, r2c_world_fft);
+
+    backend::device_instance<location_tag> device;
+
+    for(int variant=0; variant<2; variant++){
+        heffte::plan_options options = default_options<backend_tag>();
+        options.use_pencils = (variant == 0);
+        options.use_reorder = (variant == 0);
+
+        heffte::plan_options low_options = options;
+        low_options.use_low_memory = true;
+
+        auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, low_options);
+        if (num_ranks > 1) // the message buffers are bounded by the largest pairwise exchange
+            tassert(fft.size_comm_buffers() < make_fft3d<backend_tag>(inbox, outbox, comm, options).size_comm_buffers());
+
+        auto lresult = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_outbox());
+        auto lback   = make_buffer_container<input_type>(device.stream(), batch_size * fft.size_inbox());
+        auto clback  = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_inbox());
+        auto workspace = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_workspace());
+
+        fft.forward(batch_size, local_input.data(), lresult.data(), workspace.data());
+        tassert(approx(lresult, local_ref));
+
+        fft.backward(batch_size, lresult.data(), lback.data(), workspace.data(), heffte::scale::full);
+        tassert(approx(local_input, lback));
+
+        fft.forward(batch_size, clocal_input.data(), lresult.data(), workspace.data());
+        tassert(approx(lresult, clocal_ref));
+
+        fft_request request = fft.backward_async(batch_size, lresult.data(), clback.data(), workspace.data(), heffte::scale::full);
+        request.wait();
+        tassert(approx(clocal_input, clback));
+
+        // in-place transform, the output array holds the input
+        auto inplace = make_buffer_container<output_type>(device.stream(), batch_size * std::max(fft.size_inbox(), fft.size_outbox()));
+        backend::data_manipulator<location_tag>::copy_n(device.stream(), clocal_input.data(), clocal_input.size(), inplace.data());
+        fft.forward(batch_size, inplace.data(), inplace.data(), workspace.data());
+        fft.backward(batch_size, inplace.data(), inplace.data(), workspace.data(), heffte::scale::full);
+        backend::data_manipulator<location_tag>::copy_n(device.stream(), inplace.data(), clback.size(), clback.data());
+        tassert(approx(clocal_input, clback));
+
+        auto fft_r2c = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 0, comm, low_options);
+
+        auto r2c_result = make_buffer_container<output_type>(device.stream(), fft_r2c.size_outbox());
+        auto r2c_back   = make_buffer_container<input_type>(device.stream(), fft_r2c.size_inbox());
+        auto r2c_workspace = make_buffer_container<output_type>(device.stream(), fft_r2c.size_workspace());
+
+        fft_r2c.forward(r2c_local_input.data(), r2c_result.data(), r2c_workspace.data());
+        tassert(approx(r2c_result, r2c_local_ref));
+
+        fft_r2c.backward(r2c_result.data(), r2c_back.data(), r2c_workspace.data(), heffte::scale::full);
+        tassert(approx(r2c_local_input, r2c_back));
+    }
+}
+
+template<typename backend_tag>
+void test_threads_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using input_type  = double;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+    int const batch_size = 2;
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test threads", comm);
+
+    // large enough so that all stages pass the cutoff for using threads
+    box3d<> const  world = {{0, 0, 0}, {39, 35, 31}};
+
+    std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+
+    box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+    box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+
+    auto world_input = make_data<output_type>(batch_size, world);
+    auto world_fft   = forward_fft<backend_tag>(world, world_input, batch_size);
+    auto local_input = input_maker<backend_tag, output_type>::select(batch_size, world, inbox, world_input);
+    auto local_ref   = get_subboxes(batch_size, world, outbox, world_fft);
+
+    box3d<int> const r2c_world_out = world.r2c(1);
+    auto r2c_world_input = make_data<input_type>(world);
+    auto r2c_world_fft = get_subbox(world, r2c_world_out, forward_fft<backend_tag>(world, r2c_world_input));
+    box3d<int> r2c_outbox = heffte::split_world(r2c_world_out, proc_o)[me];
+    auto r2c_local_input = input_maker<backend_tag, input_type>::select(world, inbox, r2c_world_input);
+    auto r2c_local_ref   = get_subbox(r2c_world_out, r2c_outbox, r2c_world_fft);
+
+    backend::device_instance<location_tag> device;
+
+    #ifdef Heffte_ENABLE_OPENMP
+    int const default_threads = omp_get_max_threads();
+    #endif
+
+    for(int variant=0; variant<2; variant++){
+        heffte::plan_options options = default_options<backend_tag>();
+        options.use_reorder = (variant == 0);
+        options.num_threads = 3;
+
+        auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, options);
+        tassert(fft.get_options().num_threads == 3);
+
+        auto result = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_outbox());
+        auto back   = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_inbox());
+
+        fft.forward(batch_size, local_input.data(), result.data());
+        tassert(approx(result, local_ref));
+
+        fft.backward(batch_size, result.data(), back.data(), heffte::scale::full);
+        tassert(approx(local_input, back));
+
+        fft_request request = fft.forward_async(batch_size, local_input.data(), result.data());
+        request.wait();
+        tassert(approx(result, local_ref));
+
+        auto fft_r2c = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 1, comm, options);
+
+        auto r2c_result = make_buffer_container<output_type>(device.stream(), fft_r2c.size_outbox());
+        auto r2c_back   = make_buffer_container<input_type>(device.stream(), fft_r2c.size_inbox());
+
+        fft_r2c.forward(r2c_local_input.data(), r2c_result.data());
+        tassert(approx(r2c_result, r2c_local_ref));
+
+        fft_r2c.backward(r2c_result.data(), r2c_back.data(), heffte::scale::full);
+        tassert(approx(r2c_local_input, r2c_back));
+
+        #ifdef Heffte_ENABLE_OPENMP
+        tassert(omp_get_max_threads() == default_threads); // the plans restore the OpenMP setting
+        #endif
+    }
+}
+
+template<typename backend_tag>
+void test_progress_thread_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using input_type  = double;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+    int const batch_size = 2;
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test progress thread", comm);
+
+    box3d<> const  world = {{0, 0, 0}, {11, 12, 9}};
+
+    std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+
+    box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+    box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided != MPI_THREAD_MULTIPLE){ // the option is rejected at plan time
+        heffte::plan_options options = default_options<backend_tag>();
+        options.use_progress_thread = true;
+        bool rejected = false;
+        try{
+            auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, options);
+        }catch(std::runtime_error &){
+            rejected = true;
+        }
+        tassert(rejected or num_ranks == 1);
+        return;
+    }
+
+    auto world_input = make_data<output_type>(batch_size, world);
+    auto world_fft   = forward_fft<backend_tag>(world, world_input, batch_size);
+    auto local_input = input_maker<backend_tag, output_type>::select(batch_size, world, inbox, world_input);
+    auto local_ref   = get_subboxes(batch_size, world, outbox, world_fft);
+
+    box3d<int> const r2c_world_out = world.r2c(2);
+    auto r2c_world_input = make_data<input_type>(world);
+    auto r2c_world_fft = get_subbox(world, r2c_world_out, forward_fft<backend_tag>(world, r2c_world_input));
+    box3d<int> r2c_outbox = heffte::split_world(r2c_world_out, proc_o)[me];
+    auto r2c_local_input = input_maker<backend_tag, input_type>::select(world, inbox, r2c_world_input);
+    auto r2c_local_ref   = get_subbox(r2c_world_out, r2c_outbox, r2c_world_fft);
+
+    backend::device_instance<location_tag> device;
+
+    for(auto const &alg : std::vector<reshape_algorithm>{
+        reshape_algorithm::alltoall, reshape_algorithm::alltoallv,
+        reshape_algorithm::p2p, reshape_algorithm::p2p_plined}){
+
+        heffte::plan_options options = default_options<backend_tag>();
+        options.algorithm = alg;
+        options.use_progress_thread = true;
+
+        // both plans share the helper thread of the process
+        auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, options);
+        auto fft_r2c = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 2, comm, options);
+
+        auto result = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_outbox());
+        auto back   = make_buffer_container<output_type>(device.stream(), batch_size * fft.size_inbox());
+
+        fft.forward(batch_size, local_input.data(), result.data());
+        tassert(approx(result, local_ref));
+
+        fft.backward(batch_size, result.data(), back.data(), heffte::scale::full);
+        tassert(approx(local_input, back));
+
+        fft_request request = fft.forward_async(batch_size, local_input.data(), result.data());
+        while(not request.test());
+        tassert(approx(result, local_ref));
+
+        auto r2c_result = make_buffer_container<output_type>(device.stream(), fft_r2c.size_outbox());
+        auto r2c_back   = make_buffer_container<input_type>(device.stream(), fft_r2c.size_inbox());
+
+        request = fft_r2c.forward_async(r2c_local_input.data(), r2c_result.data());
+        request.wait();
+        tassert(approx(r2c_result, r2c_local_ref));
+
+        fft_r2c.backward(r2c_result.data(), r2c_back.data(), heffte::scale::full);
+        tassert(approx(r2c_local_input, r2c_back));
+    }
+}
+
+template<typename backend_tag>
+void test_workspace_pool_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using input_type  = double;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test workspace pool", comm);
+
+    // two plans with different sizes share the pool
+    std::vector<box3d<>> worlds = {box3d<>({0, 0, 0}, {7, 8, 9}), box3d<>({0, 0, 0}, {4, 10, 5})};
+
+    auto pool = std::make_shared<heffte::workspace_pool<location_tag>>();
+    backend::device_instance<location_tag> device;
+
+    std::vector<fft3d<backend_tag>> ffts;
+    std::vector<fft3d_r2c<backend_tag>> ffts_r2c;
+    size_t max_workspace = 0;
+    for(auto const &world : worlds){
+        std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+        std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+        box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+        box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+        box3d<int> r2c_outbox = heffte::split_world(world.r2c(0), proc_o)[me];
+
+        ffts.push_back(make_fft3d<backend_tag>(inbox, outbox, comm));
+        ffts.back().set_workspace_pool(pool);
+        ffts_r2c.push_back(make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 0, comm));
+        ffts_r2c.back().set_workspace_pool(pool);
+        max_workspace = std::max(max_workspace, std::max(ffts.back().size_convolution_workspace(),
+                                                         ffts_r2c.back().size_convolution_workspace()));
+    }
+
+    int allocations = 0;
+    for(int repeat=0; repeat<2; repeat++){
+        for(size_t i=0; i<worlds.size(); i++){
+            box3d<> const world = worlds[i];
+            auto world_input = make_data<input_type>(world);
+            auto world_fft   = forward_fft<backend_tag>(world, world_input);
+
+            auto local_input = input_maker<backend_tag, input_type>::select(world, ffts[i].inbox(), world_input);
+            auto local_ref   = get_subbox(world, ffts[i].outbox(), world_fft);
+            auto result      = make_buffer_container<output_type>(device.stream(), ffts[i].size_outbox());
+            auto back        = make_buffer_container<input_type>(device.stream(), ffts[i].size_inbox());
+
+            ffts[i].forward(local_input.data(), result.data());
+            tassert(approx(result, local_ref));
+            ffts[i].backward(result.data(), back.data(), heffte::scale::full);
+            tassert(approx(local_input, back));
+
+            auto r2c_ref    = get_subbox(world.r2c(0), ffts_r2c[i].outbox(), get_subbox(world, world.r2c(0), world_fft));
+            auto r2c_result = make_buffer_container<output_type>(device.stream(), ffts_r2c[i].size_outbox());
+            ffts_r2c[i].forward(local_input.data(), r2c_result.data());
+            tassert(approx(r2c_result, r2c_ref));
+            ffts_r2c[i].backward(r2c_result.data(), back.data(), heffte::scale::full);
+            tassert(approx(local_input, back));
+        }
+        // the first pass allocates the block with the size of the largest plan, the second pass does not allocate
+        if (repeat == 0){
+            tassert(pool->capacity() >= max_workspace * sizeof(output_type));
+            allocations = pool->allocations();
+        }else{
+            tassert(pool->allocations() == allocations);
+        }
+    }
+}
+
+template<typename backend_tag>
+void test_plan_file_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using input_type  = double;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test save/load plan", comm);
+
+    box3d<> const world = {{0, 0, 0}, {7, 8, 9}};
+    std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+    box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+    box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+    box3d<int> r2c_outbox = heffte::split_world(world.r2c(1), proc_o)[me];
+
+    auto world_input = make_data<input_type>(world);
+    auto world_fft   = forward_fft<backend_tag>(world, world_input);
+    auto local_input = input_maker<backend_tag, input_type>::select(world, inbox, world_input);
+    auto local_ref   = get_subbox(world, outbox, world_fft);
+    auto r2c_ref     = get_subbox(world.r2c(1), r2c_outbox, get_subbox(world, world.r2c(1), world_fft));
+
+    std::string const filename = "heffte_test_plan_np" + std::to_string(num_ranks) + "_" + backend::name<backend_tag>() + ".bin";
+    backend::device_instance<location_tag> device;
+
+    heffte::plan_options options = default_options<backend_tag>();
+    options.use_pencils = false;
+    options.algorithm = reshape_algorithm::p2p;
+
+    { // complex-to-complex
+        auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, options);
+        save_plan(filename, fft, comm);
+
+        auto loaded = fft3d<backend_tag>::load(filename, inbox, outbox, comm);
+        tassert(loaded.inbox() == fft.inbox() and loaded.outbox() == fft.outbox());
+        tassert(loaded.size_workspace() == fft.size_workspace());
+        tassert(loaded.get_options().use_pencils == options.use_pencils and loaded.get_options().algorithm == options.algorithm);
+
+        auto result = make_buffer_container<output_type>(device.stream(), loaded.size_outbox());
+        auto back   = make_buffer_container<input_type>(device.stream(), loaded.size_inbox());
+        loaded.forward(local_input.data(), result.data());
+        tassert(approx(result, local_ref));
+        loaded.backward(result.data(), back.data(), heffte::scale::full);
+        tassert(approx(local_input, back));
+
+        // the boxes do not match the saved plan
+        bool caught = false;
+        try{
+            fft3d<backend_tag>::load(filename, outbox, inbox, comm);
+        }catch(std::runtime_error &){
+            caught = true;
+        }
+        tassert(caught or inbox == outbox);
+
+        // a c2c plan cannot be used for r2c
+        caught = false;
+        try{
+            fft3d_r2c<backend_tag>::load(filename, inbox, r2c_outbox, 1, comm);
+        }catch(std::runtime_error &){
+            caught = true;
+        }
+        tassert(caught);
+    }
+
+    { // real-to-complex
+        auto fft = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 1, comm, options);
+        save_plan(filename, fft, 1, comm);
+
+        auto loaded = fft3d_r2c<backend_tag>::load(filename, inbox, r2c_outbox, 1, comm);
+        auto result = make_buffer_container<output_type>(device.stream(), loaded.size_outbox());
+        auto back   = make_buffer_container<input_type>(device.stream(), loaded.size_inbox());
+        loaded.forward(local_input.data(), result.data());
+        tassert(approx(result, r2c_ref));
+        loaded.backward(result.data(), back.data(), heffte::scale::full);
+        tassert(approx(local_input, back));
+    }
+
+    // corrupt one byte of the file, the checksum must catch the change
+    if (me == 0){
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(40);
+        file.put('x');
+    }
+    MPI_Barrier(comm);
+    bool caught = false;
+    try{
+        fft3d_r2c<backend_tag>::load(filename, inbox, r2c_outbox, 1, comm);
+    }catch(std::runtime_error &){
+        caught = true;
+    }
+    tassert(caught);
+
+    MPI_Barrier(comm);
+    if (me == 0) std::remove(filename.c_str());
+}
+
+inline double conjugate(double x){ return x; }
+inline std::complex<double> conjugate(std::complex<double> x){ return std::conj(x); }
+
+/*
+ * Direct computation of the circular convolution (or correlation) over the world box,
+ * used as a reference for the convolve() and correlate() methods.
+ */
+template<typename scalar_type>
+std::vector<scalar_type> circular_product(box3d<> const world, std::vector<scalar_type> const &x,
+                                          std::vector<scalar_type> const &y, bool correlate){
+    std::vector<scalar_type> result(world.count(), scalar_type(0.0));
+    auto wrap = [&](int i, int d)->int{ return ((i % world.size[d]) + world.size[d]) % world.size[d]; };
+    auto flat = [&](int i, int j, int k)->int{ return (k * world.size[1] + j) * world.size[0] + i; };
+    for(int k=0; k<world.size[2]; k++) for(int j=0; j<world.size[1]; j++) for(int i=0; i<world.size[0]; i++){
+        scalar_type sum = 0.0;
+        for(int nk=0; nk<world.size[2]; nk++) for(int nj=0; nj<world.size[1]; nj++) for(int ni=0; ni<world.size[0]; ni++){
+            if (correlate){
+                sum += conjugate(x[flat(ni, nj, nk)]) * y[flat(wrap(ni + i, 0), wrap(nj + j, 1), wrap(nk + k, 2))];
+            }else{
+                sum += x[flat(ni, nj, nk)] * y[flat(wrap(i - ni, 0), wrap(j - nj, 1), wrap(k - nk, 2))];
+            }
+        }
+        result[flat(i, j, k)] = sum;
+    }
+    return result;
+}
+
+template<typename backend_tag>
+void test_convolution_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test convolution", comm);
+
+    box3d<> const world = {{0, 0, 0}, {5, 6, 7}};
+
+    // the input and output grids differ, the convolution must skip the reshapes to and from the outbox
+    std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+
+    box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+    box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+
+    std::vector<output_type> world_x = make_data<output_type>(world);
+    std::vector<output_type> world_y = world_x;
+    std::reverse(world_y.begin(), world_y.end());
+    for(auto &v : world_y) v *= output_type(0.5, -0.25);
+
+    auto local_x = input_maker<backend_tag, output_type>::select(world, inbox, world_x);
+    auto local_y = input_maker<backend_tag, output_type>::select(world, inbox, world_y);
+
+    backend::device_instance<location_tag> device;
+
+    auto fft = make_fft3d<backend_tag>(inbox, outbox, comm);
+    tassert(fft.size_convolution_workspace() == fft.size_workspace() + 2 * static_cast<size_t>(fft.size_spectrum()));
+
+    auto lresult = make_buffer_container<output_type>(device.stream(), fft.size_inbox());
+    fft.convolve(local_x.data(), local_y.data(), lresult.data());
+    tassert(approx(lresult, get_subbox(world, inbox, circular_product(world, world_x, world_y, false))));
+
+    auto workspace = make_buffer_container<output_type>(device.stream(), fft.size_convolution_workspace());
+    fft.correlate(local_x.data(), local_y.data(), lresult.data(), workspace.data());
+    tassert(approx(lresult, get_subbox(world, inbox, circular_product(world, world_x, world_y, true))));
+
+    // the spectrum methods invert each other
+    auto spectrum = make_buffer_container<output_type>(device.stream(), fft.size_spectrum());
+    fft.forward_spectrum(local_x.data(), spectrum.data());
+    fft.backward_spectrum(spectrum.data(), lresult.data(), heffte::scale::full);
+    tassert(approx(lresult, local_x));
+
+    // real-to-complex variant, the result is real
+    std::vector<double> world_rx(world.count()), world_ry(world.count());
+    for(size_t i=0; i<world_x.size(); i++){
+        world_rx[i] = std::real(world_x[i]);
+        world_ry[i] = std::imag(world_y[i]);
+    }
+    auto local_rx = input_maker<backend_tag, double>::select(world, inbox, world_rx);
+    auto local_ry = input_maker<backend_tag, double>::select(world, inbox, world_ry);
+
+    for(int r2c_direction=0; r2c_direction<3; r2c_direction++){
+        box3d<int> r2c_outbox = heffte::split_world(world.r2c(r2c_direction), proc_o)[me];
+        auto fft_r2c = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, r2c_direction, comm);
+
+        auto rresult = make_buffer_container<double>(device.stream(), fft_r2c.size_inbox());
+        fft_r2c.convolve(local_rx.data(), local_ry.data(), rresult.data());
+        tassert(approx(rresult, get_subbox(world, inbox, circular_product(world, world_rx, world_ry, false))));
+
+        fft_r2c.correlate(local_rx.data(), local_ry.data(), rresult.data());
+        tassert(approx(rresult, get_subbox(world, inbox, circular_product(world, world_rx, world_ry, true))));
+    }
+}
+
+/*
+ * Applies f(i, j, k, value) to the local data of the box, used as a reference for the pointwise callbacks.
+ */
+template<typename scalar_type, typename functor_type>
+void apply_pointwise(box3d<> const box, std::vector<scalar_type> &data, functor_type f){
+    for(int k=box.low[2]; k<=box.high[2]; k++) for(int j=box.low[1]; j<=box.high[1]; j++) for(int i=box.low[0]; i<=box.high[0]; i++)
+        f(i, j, k, data[((k - box.low[2]) * box.size[1] + (j - box.low[1])) * box.size[0] + (i - box.low[0])]);
+}
+
+template<typename backend_tag>
+typename std::enable_if<not backend::uses_gpu<backend_tag>::value>::type test_callback_cases(MPI_Comm const comm){
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test pointwise callbacks", comm);
+
+    box3d<> const world = {{0, 0, 0}, {5, 6, 7}};
+
+    auto window = [](int i, int j, int k, double &x)->void{ x *= 1.0 + 0.1 * i + 0.01 * j + 0.001 * k; };
+    auto filter = [](int i, int j, int k, output_type &x)->void{ x *= output_type(i - j, 0.5 * k); };
+    auto cwindow = [&](int i, int j, int k, output_type &x)->void{
+        double w = 1.0;
+        window(i, j, k, w);
+        x *= w;
+    };
+
+    std::vector<output_type> world_input = make_data<output_type>(world);
+    std::vector<double> world_real(world.count());
+    for(size_t i=0; i<world_real.size(); i++) world_real[i] = std::real(world_input[i]);
+
+    // the first grid needs reshapes to and from the pencils, the second grid starts with pencils
+    // and the load callback is fused with the copy into the internal buffers
+    std::array<int,3> const proc_i  = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,2> const proc_2d = heffte::make_procgrid(num_ranks);
+    std::vector<std::array<std::array<int,3>, 2>> const grids = {
+        {{ proc_i, {proc_i[2], proc_i[0], proc_i[1]} }},
+        {{ {1, proc_2d[0], proc_2d[1]}, {1, proc_2d[0], proc_2d[1]} }}
+    };
+
+    for(auto const &grid : grids){
+        box3d<int> const inbox  = heffte::split_world(world, grid[0])[me];
+        box3d<int> const outbox = heffte::split_world(world, grid[1])[me];
+
+        auto fft = make_fft3d<backend_tag>(inbox, outbox, comm);
+
+        heffte::transform_callbacks<output_type> callbacks;
+        callbacks.load  = cwindow;
+        callbacks.store = filter;
+
+        // reference, window, transform and then filter
+        std::vector<output_type> const input = get_subbox(world, inbox, world_input);
+        std::vector<output_type> reference = input;
+        apply_pointwise(inbox, reference, cwindow);
+        reference = fft.forward(reference);
+        apply_pointwise(outbox, reference, filter);
+
+        std::vector<output_type> result(fft.size_outbox());
+        fft.forward(input.data(), result.data(), callbacks);
+        tassert(approx(result, reference));
+
+        // in-place variant with user provided workspace
+        std::vector<output_type> inplace(std::max(fft.size_inbox(), fft.size_outbox()));
+        std::copy(input.begin(), input.end(), inplace.begin());
+        std::vector<output_type> workspace(fft.size_workspace());
+        fft.forward(inplace.data(), inplace.data(), workspace.data(), callbacks);
+        inplace.resize(fft.size_outbox());
+        tassert(approx(inplace, reference));
+
+        // backward, the filter is applied to the input (the outbox) and the window to the output (the inbox)
+        heffte::transform_callbacks<output_type> bcallbacks;
+        bcallbacks.load  = filter;
+        bcallbacks.store = cwindow;
+
+        std::vector<output_type> spectrum = get_subbox(world, inbox, world_input);
+        spectrum.resize(fft.size_outbox(), output_type(0.5, 0.25)); // any data in the outbox will do
+        reference = spectrum;
+        apply_pointwise(outbox, reference, filter);
+        reference = fft.backward(reference, scale::full);
+        apply_pointwise(inbox, reference, cwindow);
+
+        result.resize(fft.size_inbox());
+        fft.backward(spectrum.data(), result.data(), bcallbacks, scale::full);
+        tassert(approx(result, reference));
+
+        // real-to-complex, the load callback is real and the store callback is complex
+        box3d<int> const r2c_outbox = heffte::split_world(world.r2c(0), grid[1])[me];
+        auto fft_r2c = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 0, comm);
+
+        heffte::transform_callbacks<double, output_type> rcallbacks;
+        rcallbacks.load  = window;
+        rcallbacks.store = filter;
+
+        std::vector<double> const rinput = get_subbox(world, inbox, world_real);
+        std::vector<double> rreference = rinput;
+        apply_pointwise(inbox, rreference, window);
+        std::vector<output_type> creference = fft_r2c.forward(rreference);
+        apply_pointwise(r2c_outbox, creference, filter);
+
+        std::vector<output_type> cresult(fft_r2c.size_outbox());
+        fft_r2c.forward(rinput.data(), cresult.data(), rcallbacks);
+        tassert(approx(cresult, creference));
+
+        heffte::transform_callbacks<output_type, double> brcallbacks;
+        brcallbacks.store = window;
+
+        rreference = fft_r2c.backward(cresult, scale::full);
+        apply_pointwise(inbox, rreference, window);
+
+        std::vector<double> rresult(fft_r2c.size_inbox());
+        fft_r2c.backward(cresult.data(), rresult.data(), brcallbacks, scale::full);
+        tassert(approx(rresult, rreference));
+    }
+}
+template<typename backend_tag>
+typename std::enable_if<backend::uses_gpu<backend_tag>::value>::type test_callback_cases(MPI_Comm const){} // the callbacks work only on the CPU
+
+template<typename scalar_type>
+std::vector<scalar_type> naive_dft1d(std::vector<scalar_type> const &x){
+    long long const num_entries = static_cast<long long>(x.size());
+    std::vector<scalar_type> result(x.size());
+    for(long long k=0; k<num_entries; k++){
+        std::complex<double> sum = 0.0;
+        for(long long n=0; n<num_entries; n++)
+            sum += std::complex<double>(x[n]) * std::polar(1.0, -2.0 * 3.14159265358979323846 * static_cast<double>((k * n) % num_entries)
+                                                                / static_cast<double>(num_entries));
+        result[k] = scalar_type(sum);
+    }
+    return result;
+}
+
+template<typename backend_tag, typename scalar_type>
+void test_fft1d_type(MPI_Comm const comm){
+    int const num_ranks = mpi::comm_size(comm);
+    current_test<scalar_type, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test fft1d", comm);
+
+    for(long long num_entries : std::vector<long long>{120, 210}){
+        std::vector<scalar_type> world_input(num_entries);
+        for(long long n=0; n<num_entries; n++)
+            world_input[n] = scalar_type(std::cos(0.3 * n * n), std::sin(0.7 * n));
+        std::vector<scalar_type> const world_result = naive_dft1d(world_input);
+
+        for(auto order : std::array<output_order, 2>{output_order::natural, output_order::transposed}){
+            heffte::fft1d<backend_tag> fft(num_entries, comm, default_options<backend_tag>(), order);
+            tassert(fft.size() == num_entries);
+
+            std::vector<scalar_type> input(fft.size_inbox());
+            for(size_t i=0; i<input.size(); i++) input[i] = world_input[fft.input_index(i)];
+            std::vector<scalar_type> reference(fft.size_outbox());
+            for(size_t i=0; i<reference.size(); i++) reference[i] = world_result[fft.output_index(i)];
+
+            std::vector<scalar_type> result(fft.size_outbox());
+            fft.forward(input.data(), result.data());
+            tassert(approx(result, reference));
+
+            std::vector<scalar_type> inverse(fft.size_inbox());
+            fft.backward(result.data(), inverse.data(), scale::full);
+            tassert(approx(inverse, input));
+
+            // in-place with external workspace and symmetric scaling
+            std::vector<scalar_type> inplace(std::max(fft.size_inbox(), fft.size_outbox()));
+            std::copy(input.begin(), input.end(), inplace.begin());
+            std::vector<scalar_type> workspace(fft.size_workspace());
+            fft.forward(inplace.data(), inplace.data(), workspace.data(), scale::symmetric);
+            fft.backward(inplace.data(), inplace.data(), workspace.data(), scale::symmetric);
+            inplace.resize(fft.size_inbox());
+            tassert(approx(inplace, input));
+
+            // batch of two, the second signal is scaled by two
+            std::vector<scalar_type> batch_input(2 * input.size()), batch_result(2 * result.size());
+            std::copy(input.begin(), input.end(), batch_input.begin());
+            for(size_t i=0; i<input.size(); i++) batch_input[input.size() + i] = input[i] * scalar_type(2.0);
+            std::vector<scalar_type> batch_workspace(2 * fft.size_workspace());
+            fft.forward(2, batch_input.data(), batch_result.data(), batch_workspace.data(), scale::full);
+            std::vector<scalar_type> batch_reference(2 * reference.size());
+            for(size_t i=0; i<reference.size(); i++){
+                batch_reference[i] = reference[i] / scalar_type(static_cast<double>(num_entries));
+                batch_reference[reference.size() + i] = reference[i] * scalar_type(2.0 / static_cast<double>(num_entries));
+            }
+            tassert(approx(batch_result, batch_reference));
+        }
+    }
+
+    // the factors must be at least the number of ranks
+    bool caught = false;
+    try{
+        heffte::fft1d<backend_tag> fft(std::array<int, 2>{1, 1024}, comm);
+    }catch(std::invalid_argument &){
+        caught = true;
+    }
+    tassert(caught == (num_ranks > 1));
+}
+
+template<typename backend_tag>
+typename std::enable_if<not backend::uses_gpu<backend_tag>::value>::type test_fft1d_cases(MPI_Comm const comm){
+    test_fft1d_type<backend_tag, std::complex<float>>(comm);
+    test_fft1d_type<backend_tag, std::complex<double>>(comm);
+}
+template<typename backend_tag>
+typename std::enable_if<backend::uses_gpu<backend_tag>::value>::type test_fft1d_cases(MPI_Comm const){} // the fft1d class works only on the CPU
+
+template<typename backend_tag>
+void test_autotune_cases(MPI_Comm const comm){
+    using location_tag = typename backend::buffer_traits<backend_tag>::location;
+    using input_type  = double;
+    using output_type = std::complex<double>;
+
+    int const me        = mpi::comm_rank(comm);
+    int const num_ranks = mpi::comm_size(comm);
+
+    current_test<double, using_mpi, backend_tag> name(std::string("-np ") + std::to_string(num_ranks) + "  test autotune options", comm);
+
+    box3d<> const  world = {{0, 0, 0}, {7, 8, 9}};
+
+    std::array<int,3> proc_i = heffte::proc_setup_min_surface(world, num_ranks);
+    std::array<int,3> proc_o = {proc_i[2], proc_i[0], proc_i[1]};
+
+    box3d<int> inbox  = heffte::split_world(world, proc_i)[me];
+    box3d<int> outbox = heffte::split_world(world, proc_o)[me];
+
+    auto world_input = make_data<input_type>(world);
+    auto world_fft   = forward_fft<backend_tag>(world, world_input);
+
+    auto local_input = input_maker<backend_tag, input_type>::select(world, inbox, world_input);
+    auto local_ref   = get_subbox(world, outbox, world_fft);
+
+    // all ranks must select the same options and the selected options must be usable without tuning
+    auto check_agreement = [&](heffte::plan_options const &selected)->void{
+        tassert(not selected.use_autotune);
+        std::array<int, 5> local = {static_cast<int>(selected.algorithm), (selected.use_reorder) ? 1 : 0,
+                                    (selected.use_pencils) ? 1 : 0, selected.get_proc_grid()[0], selected.get_proc_grid()[1]};
+        std::array<int, 5> lowest = {0, 0, 0, 0, 0}, highest = {0, 0, 0, 0, 0};
+        MPI_Allreduce(local.data(), lowest.data(), 5, MPI_INT, MPI_MIN, comm);
+        MPI_Allreduce(local.data(), highest.data(), 5, MPI_INT, MPI_MAX, comm);
+        tassert(lowest == highest);
+    };
+
+    backend::device_instance<location_tag> device;
+
+    box3d<int> const r2c_world_out = world.r2c(1);
+    box3d<int> r2c_outbox = heffte::split_world(r2c_world_out, proc_o)[me];
+    auto r2c_local_ref = get_subbox(r2c_world_out, r2c_outbox, get_subbox(world, r2c_world_out, world_fft));
+
+    // tune the algorithm/reorder, then the grid using the model and the measured variant
+    for(int variant=0; variant<3; variant++){
+        heffte::plan_options options = default_options<backend_tag>();
+        options.use_autotune = (variant == 0);
+        options.grid_search  = (variant == 0) ? grid_selection::heuristic :
+                                ((variant == 1) ? grid_selection::model : grid_selection::measured);
+
+        auto fft = make_fft3d<backend_tag>(inbox, outbox, comm, options);
+        check_agreement(fft.get_options());
+        tassert(fft.get_options().grid_search == grid_selection::heuristic);
+        if (variant > 0){
+            std::array<int, 2> grid = fft.get_options().get_proc_grid();
+            tassert(grid[0] * grid[1] == num_ranks);
+        }
+
+        auto lresult = make_buffer_container<output_type>(device.stream(), fft.size_outbox());
+        auto lback   = make_buffer_container<input_type>(device.stream(), fft.size_inbox());
+
+        fft.forward(local_input.data(), lresult.data());
+        tassert(approx(lresult, local_ref));
+
+        fft.backward(lresult.data(), lback.data(), heffte::scale::full);
+        tassert(approx(local_input, lback));
+
+        auto fft_r2c = make_fft3d_r2c<backend_tag>(inbox, r2c_outbox, 1, comm, options);
+        check_agreement(fft_r2c.get_options());
+
+        auto r2c_result = make_buffer_container<output_type>(device.stream(), fft_r2c.size_outbox());
+        auto r2c_back   = make_buffer_container<input_type>(device.stream(), fft_r2c.size_inbox());
+
+        fft_r2c.forward(local_input.data(), r2c_result.data());
+        tassert(approx(r2c_result, r2c_local_ref));
+
+        fft_r2c.backward(r2c_result.data(), r2c_back.data(), heffte::scale::full);
+        tassert(approx(local_input, r2c_back));
+
+        // the cost of the tuned plans uses the exact workspace
+        heffte::plan_cost cost = estimate_plan_cost(fft, comm);
+        tassert(cost.workspace_bytes[me] == static_cast<long long>(fft.size_workspace() * sizeof(output_type)));
+        heffte::plan_cost r2c_cost = estimate_plan_cost(fft_r2c, 1, comm);
+        tassert(r2c_cost.workspace_bytes[me] == static_cast<long long>(fft_r2c.size_workspace() * sizeof(output_type)));
+    }
+}
+
 #endif
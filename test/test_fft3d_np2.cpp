@@ -20,6 +20,16 @@ void test_fft3d_cases(MPI_Comm const comm){
     test_fft3d_arrays<backend_tag, std::complex<float>, 9, 9, 9>(comm);
     test_fft3d_arrays<backend_tag, std::complex<double>, 9, 9, 9>(comm);
     test_batch_cases<backend_tag>(comm);
+    test_async_cases<backend_tag>(comm);
+    test_low_memory_cases<backend_tag>(comm);
+    test_threads_cases<backend_tag>(comm);
+    test_progress_thread_cases<backend_tag>(comm);
+    test_workspace_pool_cases<backend_tag>(comm);
+    test_plan_file_cases<backend_tag>(comm);
+    test_autotune_cases<backend_tag>(comm);
+    test_convolution_cases<backend_tag>(comm);
+    test_callback_cases<backend_tag>(comm);
+    test_fft1d_cases<backend_tag>(comm);
 }
 
 void perform_tests(MPI_Comm const comm){
@@ -45,7 +55,9 @@ void perform_tests(MPI_Comm const comm){
 
 int main(int argc, char *argv[]){
 
-    MPI_Init(&argc, &argv);
+    // the progress thread test needs concurrent MPI calls
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
 
     perform_tests(MPI_COMM_WORLD);
 
@@ -17,6 +17,14 @@ void test_fft3d_cases(MPI_Comm const comm){
     test_fft3d_vectors_2d<backend_tag, std::complex<float>, 31, 31>(comm);
     test_fft3d_vectors_2d<backend_tag, std::complex<double>, 10, 10>(comm);
     test_batch_cases<backend_tag>(comm);
+    test_async_cases<backend_tag>(comm);
+    test_low_memory_cases<backend_tag>(comm);
+    test_workspace_pool_cases<backend_tag>(comm);
+    test_plan_file_cases<backend_tag>(comm);
+    test_autotune_cases<backend_tag>(comm);
+    test_convolution_cases<backend_tag>(comm);
+    test_callback_cases<backend_tag>(comm);
+    test_fft1d_cases<backend_tag>(comm);
 }
 
 void perform_tests(MPI_Comm const comm){
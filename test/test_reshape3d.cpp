@@ -36,6 +36,32 @@ void test_boxes(MPI_Comm const comm){
 
     tassert(match(boxes.in,  reference_inboxes));
     tassert(match(boxes.out, reference_outboxes));
+
+    // regular grids are detected and the boxes are computed without the all-gather
+    box3d<> const world = {{0, 0, 0}, {9, 10, 11}, {2, 0, 1}};
+    std::array<int, 3> proc_i = heffte::proc_setup_min_surface(world, mpi::comm_size(comm));
+    std::vector<box3d<>> regular_in  = split_world(world, proc_i);
+    std::vector<box3d<>> regular_out = split_world(world, {1, 1, mpi::comm_size(comm)});
+
+    std::vector<split_grid<int>> grids = mpi::find_split_grids(regular_in[me], regular_out[me], comm);
+    tassert(grids.size() == 2);
+    tassert(grids[0].proc_grid == proc_i);
+
+    boxes = mpi::gather_boxes(regular_in[me], regular_out[me], comm);
+    tassert(match(boxes.in,  regular_in));
+    tassert(match(boxes.out, regular_out));
+    for(size_t i=0; i<regular_in.size(); i++)
+        tassert(boxes.in[i].order == world.order);
+
+    // swapping two boxes breaks the grid, the general gather must be used
+    if (regular_in.size() > 1){
+        std::vector<box3d<>> swapped_in;
+        for(size_t i=0; i<regular_in.size(); i++)
+            swapped_in.push_back(regular_in[(i < 2) ? 1 - i : i]);
+        tassert(mpi::find_split_grids(swapped_in[me], regular_out[me], comm).empty());
+        boxes = mpi::gather_boxes(swapped_in[me], regular_out[me], comm);
+        tassert(match(boxes.in,  swapped_in));
+    }
 }
 
 /*
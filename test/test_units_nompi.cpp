@@ -68,6 +68,186 @@ void test_split_pencils(){
     sassert(reconstructed_world == world);
 }
 
+/*
+ * Returns a copy of the boxes with the entries i and j swapped, the boxes are not assignable.
+ */
+std::vector<heffte::box3d<>> swap_boxes(std::vector<heffte::box3d<>> const &boxes, size_t i, size_t j){
+    std::vector<heffte::box3d<>> result;
+    for(size_t k=0; k<boxes.size(); k++)
+        result.push_back(boxes[(k == i) ? j : ((k == j) ? i : k)]);
+    return result;
+}
+
+void test_split_grid(){
+    using namespace heffte;
+    current_test<int, using_nompi> name("split grid");
+
+    box3d<> const world = {{1, 0, 2}, {10, 6, 13}, {1, 0, 2}};
+    for(auto const &proc_grid : std::vector<std::array<int, 3>>{{1, 1, 1}, {3, 2, 5}, {4, 7, 1}, {10, 1, 12}}){
+        split_grid<int> const grid = {world, proc_grid};
+        std::vector<box3d<>> boxes = split_world(world, proc_grid);
+        for(int r=0; r<grid.count(); r++)
+            sassert(grid.box(r) == boxes[r] and grid.box(r).order == boxes[r].order);
+
+        std::vector<split_grid<int>> detected = find_split_grid(boxes);
+        sassert(detected.size() == 1);
+        sassert(detected[0].world == world and detected[0].world.order == world.order and detected[0].proc_grid == proc_grid);
+
+        // the analytic overlaps and assignment must match the general algorithms
+        for(auto const &source_grid : std::vector<std::array<int, 3>>{{1, 1, proc_grid[0] * proc_grid[1] * proc_grid[2]},
+                                                                      {proc_grid[2], proc_grid[0], proc_grid[1]}}){
+            std::vector<box3d<>> source = split_world(world, source_grid);
+            if (source.size() > 2) source = swap_boxes(source, 0, 2); // the source does not have to be a regular grid
+            sassert(count_connections(grid, source) == count_connections(boxes, source));
+            sassert(match(maximize_overlap(grid, source, {2, 0, 1}, rank_remap()),
+                          maximize_overlap(boxes, source, {2, 0, 1}, rank_remap())));
+            for(auto const &b : source)
+                sassert(grid.count_overlaps(b) == static_cast<long long>(std::count_if(boxes.begin(), boxes.end(),
+                                                    [&](box3d<> const &n)->bool{ return not n.collide(b).empty(); })));
+        }
+
+        if (boxes.size() > 2)
+            sassert(find_split_grid(swap_boxes(boxes, 0, 1)).empty());
+    }
+}
+
+void test_plan_2d(){
+    using namespace heffte;
+    current_test<int, using_nompi> name("2D planner");
+
+    auto count_reshapes = [](logic_plan3d<int> const &plan)->int{
+        int result = 0;
+        for(int i=0; i<4; i++) if (not match(plan.in_shape[i], plan.out_shape[i])) result++;
+        return result;
+    };
+
+    box3d<> const world = {{0, 0, 0}, {15, 11, 0}};
+    std::vector<box3d<>> const xslabs = split_world(world, {1, 4, 1});
+    std::vector<box3d<>> const yslabs = split_world(world, {4, 1, 1});
+    std::vector<box3d<>> const bricks = split_world(world, {2, 2, 1});
+
+    for(bool use_pencils : std::array<bool, 2>{true, false}){
+        plan_options options = default_options<backend::stock>();
+        options.use_pencils = use_pencils;
+
+        // slabs to transposed slabs need a single reshape and the middle stage is the direction of size one
+        logic_plan3d<int> const transpose = plan_operations<int>({xslabs, yslabs}, -1, options, 0);
+        sassert(count_reshapes(transpose) == 1);
+        sassert((transpose.fft_direction == std::array<int, 3>{0, 2, 1}));
+        sassert(is_trivial_stage(transpose, 1) and not is_trivial_stage(transpose, 0) and not is_trivial_stage(transpose, 2));
+        sassert(match(transpose.in_shape[2], transpose.in_shape[1]) and match(transpose.out_shape[1], transpose.in_shape[1]));
+
+        // the output slabs select the first direction
+        logic_plan3d<int> const to_slabs = plan_operations<int>({bricks, yslabs}, -1, options, 0);
+        sassert(count_reshapes(to_slabs) == 2);
+        sassert(to_slabs.fft_direction[0] == 0 and to_slabs.fft_direction[2] == 1);
+
+        sassert(count_reshapes(plan_operations<int>({xslabs, xslabs}, -1, options, 0)) == 2);
+
+        logic_plan3d<int> const from_bricks = plan_operations<int>({bricks, bricks}, -1, options, 0);
+        sassert(count_reshapes(from_bricks) == 3);
+        sassert(is_pencils(world, from_bricks.out_shape[0], from_bricks.fft_direction[0]));
+        sassert(is_pencils(world, from_bricks.out_shape[2], from_bricks.fft_direction[2]));
+
+        // the r2c direction comes first and the transposed slabs split the shortened direction
+        box3d<> const cworld = world.r2c(0);
+        logic_plan3d<int> const r2c = plan_operations<int>({bricks, split_world(cworld, {2, 2, 1})}, 0, options, 0);
+        sassert(count_reshapes(r2c) == 3);
+        sassert((r2c.fft_direction == std::array<int, 3>{0, 2, 1}));
+        sassert(is_pencils(cworld, r2c.out_shape[2], 1));
+    }
+
+    // the 3D logic treats the bricks as pencils in the direction of size one
+    plan_options options = default_options<backend::stock>();
+    options.use_2d_planner = false;
+    logic_plan3d<int> plan = plan_operations<int>({bricks, bricks}, -1, options, 0);
+    sassert(plan.fft_direction[0] == 2 and is_trivial_stage(plan, 0));
+}
+
+void test_comm_cost_model(){
+    using namespace heffte;
+    current_test<int, using_nompi> name("communication cost model");
+
+    box3d<> const world = {{0, 0, 0}, {7, 7, 7}};
+    std::vector<box3d<>> boxes = split_world(world, {1, 2, 2});
+
+    plan_options options = default_options<backend::stock>();
+    options.use_proc_grid({2, 2});
+    logic_plan3d<int> plan = plan_operations<int>({boxes, boxes}, -1, options, 0);
+
+    comm_cost_model model;
+    std::array<double, 4> single_node = estimate_comm_time(plan, {0, 0, 0, 0}, model);
+    std::array<double, 4> four_nodes  = estimate_comm_time(plan, {0, 1, 2, 3}, model);
+
+    double single_total = 0.0, four_total = 0.0;
+    for(int i=0; i<4; i++){
+        if (match(plan.in_shape[i], plan.out_shape[i])){ // no communication in this stage
+            sassert(single_node[i] == 0.0);
+            sassert(four_nodes[i] == 0.0);
+        }
+        single_total += single_node[i];
+        four_total   += four_nodes[i];
+    }
+    sassert(single_total > 0.0); // the input and output are x-pencils, y and z need reshapes
+    sassert(four_total > single_total); // crossing the nodes costs more with the default model
+
+    options.use_proc_grid({3, 1}); // does not match the number of boxes
+    bool caught = false;
+    try{
+        plan_operations<int>({boxes, boxes}, -1, options, 0);
+    }catch(std::invalid_argument &){
+        caught = true;
+    }
+    sassert(caught);
+}
+
+void test_plan_cost(){
+    using namespace heffte;
+    current_test<int, using_nompi> name("analytical plan cost");
+
+    box3d<> const world = {{0, 0, 0}, {7, 7, 7}};
+    std::vector<box3d<>> boxes = split_world(world, {1, 2, 2});
+
+    plan_options options = default_options<backend::stock>();
+    options.use_proc_grid({2, 2});
+    logic_plan3d<int> plan = plan_operations<int>({boxes, boxes}, -1, options, 0);
+
+    plan_cost cost = estimate_plan_cost(plan, sizeof(std::complex<double>));
+
+    for(int i=0; i<4; i++){
+        if (match(plan.in_shape[i], plan.out_shape[i])){
+            sassert(not cost.reshapes[i].active);
+            sassert(cost.reshapes[i].max_send_bytes == 0);
+            continue;
+        }
+        sassert(cost.reshapes[i].active);
+        long long total_send = 0, total_recv = 0, total_send_messages = 0, total_recv_messages = 0;
+        for(int r=0; r<4; r++){
+            total_send += cost.reshapes[i].send_bytes[r];
+            total_recv += cost.reshapes[i].recv_bytes[r];
+            total_send_messages += cost.reshapes[i].send_messages[r];
+            total_recv_messages += cost.reshapes[i].recv_messages[r];
+        }
+        sassert(total_send > 0);
+        sassert(total_send == total_recv);
+        sassert(total_send_messages == total_recv_messages);
+        sassert(cost.reshapes[i].imbalance >= 1.0);
+    }
+
+    for(int i=0; i<3; i++){
+        double total_flops = 0.0;
+        for(auto f : cost.fft_flops[i]) total_flops += f;
+        sassert(std::abs(total_flops - 5.0 * 512.0 * 3.0) < 1.E-8); // 64 transforms of size 8, 5 N log2(N)
+    }
+    sassert(cost.max_workspace_bytes > 0);
+
+    plan_cost r2c_cost = estimate_plan_cost(plan_operations<int>({boxes, boxes}, 0, options, 0),
+                                            sizeof(std::complex<double>), 0);
+    double r2c_flops = 0.0;
+    for(auto f : r2c_cost.fft_flops[0]) r2c_flops += f;
+    sassert(r2c_flops < 5.0 * 512.0 * 3.0); // the real-to-complex transform does half the work
+}
+
 void test_cpu_scale(){
     using namespace heffte;
     current_test<int, using_nompi> name("cpu scaling");
@@ -84,6 +264,36 @@ void test_cpu_scale(){
     sassert(approx(cx, cy));
 }
 
+void test_aligned_buffer(){
+    using namespace heffte;
+    current_test<int, using_nompi> name("aligned buffer");
+    for(auto mode : std::vector<pool_alignment>{pool_alignment::cache_line, pool_alignment::huge_page}){
+        aligned_buffer buffer(mode);
+        sassert(buffer.capacity() == 0 and buffer.allocations() == 0);
+
+        double *x = buffer.get<double>(100);
+        sassert(reinterpret_cast<size_t>(x) % alignment_bytes(mode) == 0);
+        sassert(buffer.capacity() >= 100 * sizeof(double) and buffer.allocations() == 1);
+        for(int i=0; i<100; i++) x[i] = static_cast<double>(i);
+
+        // smaller requests reuse the block
+        sassert(buffer.get<std::complex<double>>(50) == reinterpret_cast<std::complex<double>*>(x));
+        sassert(buffer.get<float>(10) == reinterpret_cast<float*>(x));
+        sassert(buffer.allocations() == 1);
+
+        std::complex<double> *y = buffer.get<std::complex<double>>(buffer.capacity());
+        sassert(reinterpret_cast<size_t>(y) % alignment_bytes(mode) == 0);
+        sassert(buffer.allocations() == 2);
+    }
+
+    workspace_pool<tag::cpu> pool;
+    pool.register_client(200);
+    float *w = pool.get<float>(nullptr, 10);
+    sassert(pool.capacity() >= 200 * sizeof(float));
+    sassert(pool.get<float>(nullptr, 200) == w);
+    sassert(pool.allocations() == 1);
+}
+
 /*
  * Generates input for the fft, the input consists of reals or complex but they have only
  * integer values and the values follow the order of the entries.
@@ -201,6 +411,14 @@ std::vector<typename fft_output<scalar_type>::type> make_fft2_r2c(){
     return result;
 }
 
+// Returns batch_size copies of x stored back-to-back, used to test the batched executor methods.
+template<typename scalar_type>
+std::vector<scalar_type> repeat_batch(std::vector<scalar_type> const &x, int batch_size){
+    std::vector<scalar_type> result;
+    for(int j=0; j<batch_size; j++) result.insert(result.end(), x.begin(), x.end());
+    return result;
+}
+
 /*
  * Tests the 1-D executor for the backend_tag in the complex-to-complex case.
  * The test is done against pen-and-paper solution using a box of size 2x3x4 with data 1, 2, 3, ...
@@ -230,6 +448,16 @@ void test_1d_complex(){
         auto backward_result = test_traits<backend_tag>::unload(forward_result);
         for(auto &r : backward_result) r /= (2.0 + i);
         sassert(approx(backward_result, input));
+
+        int const batch_size = 3;
+        auto batch_result = test_traits<backend_tag>::load(repeat_batch(input, batch_size));
+        fft->forward(batch_size, batch_result.data(), workspace.data());
+        sassert(approx(batch_result, repeat_batch(reference[i], batch_size)));
+
+        fft->backward(batch_size, batch_result.data(), workspace.data());
+        auto batch_backward = test_traits<backend_tag>::unload(batch_result);
+        for(auto &r : batch_backward) r /= (2.0 + i);
+        sassert(approx(batch_backward, repeat_batch(input, batch_size)));
     }
 }
 // Same as test_1d_complex() but uses the real-to-complex case computing all entries.
@@ -363,6 +591,18 @@ void test_1d_r2c(){
         auto unload_result = test_traits<backend_tag>::unload(back_result);
         for(auto &r : unload_result) r /= (2.0 + i);
         sassert(approx(unload_result, input));
+
+        int const batch_size = 3;
+        auto batch_input = test_traits<backend_tag>::load(repeat_batch(input, batch_size));
+        typename test_traits<backend_tag>::template container<typename fft_output<scalar_type>::type> batch_result(batch_size * fft->complex_size());
+        fft->forward(batch_size, batch_input.data(), batch_result.data(), workspace.data());
+        sassert(approx(batch_result, repeat_batch(reference[i], batch_size)));
+
+        typename test_traits<backend_tag>::template container<scalar_type> batch_back(batch_input.size());
+        fft->backward(batch_size, batch_result.data(), batch_back.data(), workspace.data());
+        auto batch_unload = test_traits<backend_tag>::unload(batch_back);
+        for(auto &r : batch_unload) r /= (2.0 + i);
+        sassert(approx(batch_unload, repeat_batch(input, batch_size)));
     }
 }
 // instantiates a test for the backend tag using all cases of 1D real and complex transforms
@@ -655,6 +895,48 @@ void test_transpose(){
     #endif
 }
 
+// Tests the blocked and tiled CPU unpack kernels against a simple loop, using sizes that do not divide the tiles.
+template<typename scalar_type>
+void test_cpu_transpose_unpack(){
+    current_test<scalar_type, using_nompi> name("cpu transpose unpack");
+
+    std::array<int, 3> const size = {37, 43, 23}; // fast, mid, slow dimensions, large enough to use multiple threads
+    int const nbuff = size[0] * size[1] * size[2];
+    std::vector<scalar_type> buffer(nbuff);
+    for(int i=0; i<nbuff; i++) buffer[i] = static_cast<scalar_type>(i + 1);
+
+    std::array<std::array<int, 3>, 6> const maps = {{{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}};
+    for(auto const &map : maps){
+        // the buffer holds the box in the order given by the map, see the plans in compute_overlap_map_transpose_pack()
+        std::array<int, 3> const bsize = {size[map[0]], size[map[1]], size[map[2]]};
+        // the destination has padding in the line and plane strides
+        heffte::pack_plan_3d<int> plan = {size, size[0] + 3, (size[0] + 3) * (size[1] + 2),
+                                          bsize[0], bsize[0] * bsize[1], map};
+
+        std::vector<scalar_type> result(plan.plane_stride * size[2]), reference(plan.plane_stride * size[2]);
+        for(int i=0; i<size[2]; i++){
+            for(int j=0; j<size[1]; j++){
+                for(int k=0; k<size[0]; k++){
+                    std::array<int, 3> const ijk = {k, j, i};
+                    reference[i * plan.plane_stride + j * plan.line_stride + k] =
+                        buffer[ijk[map[2]] * plan.buff_plane_stride + ijk[map[1]] * plan.buff_line_stride + ijk[map[0]]];
+                }
+            }
+        }
+
+        heffte::transpose_packer<tag::cpu>().unpack(nullptr, plan, buffer.data(), result.data());
+        sassert(match(result, reference));
+    }
+}
+
+// Runs the CPU unpack test for all supported types.
+void test_cpu_transpose_unpack(){
+    test_cpu_transpose_unpack<float>();
+    test_cpu_transpose_unpack<double>();
+    test_cpu_transpose_unpack<std::complex<float>>();
+    test_cpu_transpose_unpack<std::complex<double>>();
+}
+
 /*
  * Make data for a world box using a uniform random distribution on (0, 1).
  * The random seed is fixed, thus the result is deterministic and repeatable.
@@ -815,7 +1097,12 @@ int main(int, char**){
     test_factorize();
     test_process_grid();
     test_split_pencils();
+    test_split_grid();
+    test_plan_2d();
+    test_comm_cost_model();
+    test_plan_cost();
     test_cpu_scale();
+    test_aligned_buffer();
 
     test_gpu_vector();
     test_gpu_scale();
@@ -824,6 +1111,7 @@ int main(int, char**){
 
     test_1d_reorder();
     test_transpose();
+    test_cpu_transpose_unpack();
 
     test_cross_reference();
 